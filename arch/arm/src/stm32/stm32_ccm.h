@@ -98,12 +98,12 @@
  * allocators can be used just like the standard memory allocators.
  */
 
-#define ccm_malloc(s)      mm_malloc(&g_ccm_heap, s)
-#define ccm_zalloc(s)      mm_zalloc(&g_ccm_heap, s)
-#define ccm_calloc(n,s)    mm_calloc(&g_ccm_heap, n,s)
+#define ccm_malloc(s)      mm_malloc(&g_ccm_heap, s MM_CALLER)
+#define ccm_zalloc(s)      mm_zalloc(&g_ccm_heap, s MM_CALLER)
+#define ccm_calloc(n,s)    mm_calloc(&g_ccm_heap, n,s MM_CALLER)
 #define ccm_free(p)        mm_free(&g_ccm_heap, p)
-#define ccm_realloc(p,s)   mm_realloc(&g_ccm_heap, p, s)
-#define ccm_memalign(a,s)  mm_memalign(&g_ccm_heap, a, s)
+#define ccm_realloc(p,s)   mm_realloc(&g_ccm_heap, p, s MM_CALLER)
+#define ccm_memalign(a,s)  mm_memalign(&g_ccm_heap, a, s MM_CALLER)
 
 /****************************************************************************
  * Public Types
@@ -97,12 +97,12 @@
  * allocators can be used just like the standard memory allocators.
  */
 
-#define dtcm_malloc(s)      mm_malloc(&g_dtcm_heap, s)
-#define dtcm_zalloc(s)      mm_zalloc(&g_dtcm_heap, s)
-#define dtcm_calloc(n,s)    mm_calloc(&g_dtcm_heap, n,s)
+#define dtcm_malloc(s)      mm_malloc(&g_dtcm_heap, s MM_CALLER)
+#define dtcm_zalloc(s)      mm_zalloc(&g_dtcm_heap, s MM_CALLER)
+#define dtcm_calloc(n,s)    mm_calloc(&g_dtcm_heap, n,s MM_CALLER)
 #define dtcm_free(p)        mm_free(&g_dtcm_heap, p)
-#define dtcm_realloc(p,s)   mm_realloc(&g_dtcm_heap, p, s)
-#define dtcm_memalign(a,s)  mm_memalign(&g_dtcm_heap, a, s)
+#define dtcm_realloc(p,s)   mm_realloc(&g_dtcm_heap, p, s MM_CALLER)
+#define dtcm_memalign(a,s)  mm_memalign(&g_dtcm_heap, a, s MM_CALLER)
 
 /****************************************************************************
  * Public Types
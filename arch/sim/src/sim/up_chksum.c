@@ -0,0 +1,257 @@
+/****************************************************************************
+ * arch/sim/src/sim/up_chksum.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef uint32_t (*chksum_native_t)(const uint8_t *data, uint16_t len,
+                                    uint32_t acc);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t chksum_select(const uint8_t *data, uint16_t len,
+                              uint32_t acc);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The summation to use.  This is selected on the first call. */
+
+static chksum_native_t g_chksum_native = chksum_select;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_tail
+ *
+ * Description:
+ *   Add the remaining 16-bit words of the buffer, and any odd trailing byte
+ *   padded with zero, to the 32-bit accumulator.  The words are summed in
+ *   host (little-endian) byte order.
+ *
+ ****************************************************************************/
+
+static uint32_t chksum_tail(const uint8_t *data, uint16_t len, uint32_t acc)
+{
+  uint16_t word;
+
+  while (len >= 2)
+    {
+      memcpy(&word, data, 2);
+      acc  += word;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += *data;
+    }
+
+  return acc;
+}
+
+/****************************************************************************
+ * Name: chksum_sse2
+ *
+ * Description:
+ *   Sum 16 bytes per iteration.  The eight 16-bit words of each block are
+ *   zero-extended and added into four 32-bit lanes.  Since len is at most
+ *   65535 bytes, no lane can overflow.
+ *
+ ****************************************************************************/
+
+__attribute__((target("sse2")))
+static uint32_t chksum_sse2(const uint8_t *data, uint16_t len, uint32_t acc)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i vacc = zero;
+  uint32_t lanes[4];
+
+  while (len >= 16)
+    {
+      __m128i v = _mm_loadu_si128((const __m128i *)data);
+
+      vacc  = _mm_add_epi32(vacc, _mm_unpacklo_epi16(v, zero));
+      vacc  = _mm_add_epi32(vacc, _mm_unpackhi_epi16(v, zero));
+      data += 16;
+      len  -= 16;
+    }
+
+  _mm_storeu_si128((__m128i *)lanes, vacc);
+  acc = chksum_tail(data, len, acc);
+
+  /* Fold each lane before adding them so that the 32-bit accumulator
+   * cannot overflow.
+   */
+
+  acc  = (acc & 0xffff) + (acc >> 16);
+  acc += (lanes[0] & 0xffff) + (lanes[0] >> 16);
+  acc += (lanes[1] & 0xffff) + (lanes[1] >> 16);
+  acc += (lanes[2] & 0xffff) + (lanes[2] >> 16);
+  acc += (lanes[3] & 0xffff) + (lanes[3] >> 16);
+  return acc;
+}
+
+/****************************************************************************
+ * Name: chksum_avx2
+ *
+ * Description:
+ *   Sum 32 bytes per iteration into eight 32-bit lanes.  Otherwise, this is
+ *   the same as chksum_sse2().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_NET_CHKSUM_AVX2
+__attribute__((target("avx2")))
+static uint32_t chksum_avx2(const uint8_t *data, uint16_t len, uint32_t acc)
+{
+  __m256i zero = _mm256_setzero_si256();
+  __m256i vacc = zero;
+  uint32_t lanes[8];
+  int i;
+
+  while (len >= 32)
+    {
+      __m256i v = _mm256_loadu_si256((const __m256i *)data);
+
+      vacc  = _mm256_add_epi32(vacc, _mm256_unpacklo_epi16(v, zero));
+      vacc  = _mm256_add_epi32(vacc, _mm256_unpackhi_epi16(v, zero));
+      data += 32;
+      len  -= 32;
+    }
+
+  _mm256_storeu_si256((__m256i *)lanes, vacc);
+  acc = chksum_tail(data, len, acc);
+
+  acc = (acc & 0xffff) + (acc >> 16);
+  for (i = 0; i < 8; i++)
+    {
+      acc += (lanes[i] & 0xffff) + (lanes[i] >> 16);
+    }
+
+  return acc;
+}
+#endif
+
+/****************************************************************************
+ * Name: chksum_select
+ *
+ * Description:
+ *   Select the summation to use on the first call.  The AVX2 summation is
+ *   used only if it was selected in the configuration and the host CPU
+ *   supports it.
+ *
+ ****************************************************************************/
+
+static uint32_t chksum_select(const uint8_t *data, uint16_t len,
+                              uint32_t acc)
+{
+  g_chksum_native = chksum_sse2;
+
+#ifdef CONFIG_SIM_NET_CHKSUM_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    {
+      g_chksum_native = chksum_avx2;
+    }
+#endif
+
+  return g_chksum_native(data, len, acc);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum
+ *
+ * Description:
+ *   Calculate the raw change some over the memory region described by
+ *   data and len.  This replaces the generic logic in
+ *   net/utils/net_chksum.c when CONFIG_NET_ARCH_RAWCHKSUM is selected.
+ *
+ *   The one's complement sum does not depend on byte order, so the 16-bit
+ *   words are summed as they are loaded (little-endian) and the folded
+ *   result is byte-swapped into network order at the end.  The loads are
+ *   unaligned, so there are no alignment requirements on data.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   data - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint32_t acc;
+  uint16_t t;
+
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  acc = g_chksum_native(data, len, 0);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  t   = (uint16_t)acc;
+  t   = (uint16_t)((t << 8) | (t >> 8));
+
+  acc = (uint32_t)sum + t;
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
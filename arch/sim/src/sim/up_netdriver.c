@@ -50,6 +50,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <sched.h>
+#include <errno.h>
 #include <nuttx/net/net.h>
 
 #include <net/ethernet.h>
@@ -160,166 +161,207 @@ static int sim_txpoll(struct net_driver_s *dev)
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: sim_receive
+ *
+ * Description:
+ *   Receive and dispatch one frame from the host network device.  This is
+ *   the receive function passed to netdev_rxbatch().
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Zero if a frame was received; -EAGAIN if no frame was waiting.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
  ****************************************************************************/
 
-void netdriver_loop(void)
+static int sim_receive(FAR struct net_driver_s *dev)
 {
   FAR struct eth_hdr_s *eth;
 
-  /* Check for new frames.  If so, then poll the network for new XMIT data */
-
-  net_lock();
-  (void)devif_poll(&g_sim_dev, sim_txpoll);
-  net_unlock();
-
-  /* netdev_read will return 0 on a timeout event and >0 on a data received event */
+  /* netdev_read will return 0 if no frame is waiting and >0 on a data
+   * received event.  It does not wait:  That is done by netdriver_loop()
+   * without the network lock.
+   */
 
   g_sim_dev.d_len = netdev_read((FAR unsigned char *)g_sim_dev.d_buf,
                                 CONFIG_NET_ETH_PKTSIZE);
+  if (g_sim_dev.d_len == 0)
+    {
+      return -EAGAIN;
+    }
 
-  /* Disable preemption through to the following so that it behaves a little more
-   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
-   * oddly.
+  NETDEV_RXPACKETS(&g_sim_dev);
+
+  /* Data received event.  Check for valid Ethernet header with destination == our
+   * MAC address
    */
 
-  sched_lock();
-  if (g_sim_dev.d_len > 0)
+  eth = BUF;
+  if (g_sim_dev.d_len > ETH_HDRLEN)
     {
-      NETDEV_RXPACKETS(&g_sim_dev);
-
-      /* Data received event.  Check for valid Ethernet header with destination == our
-       * MAC address
-       */
-
-      eth = BUF;
-      if (g_sim_dev.d_len > ETH_HDRLEN)
-        {
 #ifdef CONFIG_NET_PKT
-          /* When packet sockets are enabled, feed the frame into the packet
-           * tap.
-           */
+      /* When packet sockets are enabled, feed the frame into the packet
+       * tap.
+       */
 
-          pkt_input(&g_sim_dev);
+      pkt_input(&g_sim_dev);
 #endif /* CONFIG_NET_PKT */
 
-          /* We only accept IP packets of the configured type and ARP packets */
+      /* We only accept IP packets of the configured type and ARP packets */
 
 #ifdef CONFIG_NET_IPv4
-          if (eth->type == HTONS(ETHTYPE_IP))
-            {
-              ninfo("IPv4 frame\n");
-              NETDEV_RXIPV4(&g_sim_dev);
+      if (eth->type == HTONS(ETHTYPE_IP))
+        {
+          ninfo("IPv4 frame\n");
+          NETDEV_RXIPV4(&g_sim_dev);
 
-              /* Handle ARP on input then give the IPv4 packet to the network
-               * layer
-               */
+          /* Handle ARP on input then give the IPv4 packet to the network
+           * layer
+           */
 
-              arp_ipin(&g_sim_dev);
-              ipv4_input(&g_sim_dev);
+          arp_ipin(&g_sim_dev);
+          ipv4_input(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+            {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv6
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
 #endif
-                    {
-                      arp_out(&g_sim_dev);
-                    }
+                {
+                  arp_out(&g_sim_dev);
+                }
 #ifdef CONFIG_NET_IPv6
-                  else
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+              else
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
+        }
+      else
 #endif /* CONFIG_NET_IPv4 */
 #ifdef CONFIG_NET_IPv6
-          if (eth->type == HTONS(ETHTYPE_IP6))
-            {
-              ninfo("Iv6 frame\n");
-              NETDEV_RXIPV6(&g_sim_dev);
+      if (eth->type == HTONS(ETHTYPE_IP6))
+        {
+          ninfo("Iv6 frame\n");
+          NETDEV_RXIPV6(&g_sim_dev);
 
-              /* Give the IPv6 packet to the network layer */
+          /* Give the IPv6 packet to the network layer */
 
-              ipv6_input(&g_sim_dev);
+          ipv6_input(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-               {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+           {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv4
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
-                    {
-                      arp_out(&g_sim_dev);
-                    }
-                  else
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
+                {
+                  arp_out(&g_sim_dev);
+                }
+              else
 #endif
 #ifdef CONFIG_NET_IPv6
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif /* CONFIG_NET_IPv6 */
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
+        }
+      else
 #endif/* CONFIG_NET_IPv6 */
 #ifdef CONFIG_NET_ARP
-          if (eth->type == htons(ETHTYPE_ARP))
-            {
-              ninfo("ARP frame\n");
-              NETDEV_RXARP(&g_sim_dev);
+      if (eth->type == htons(ETHTYPE_ARP))
+        {
+          ninfo("ARP frame\n");
+          NETDEV_RXARP(&g_sim_dev);
 
-              arp_arpin(&g_sim_dev);
+          arp_arpin(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+          if (g_sim_dev.d_len > 0)
+            {
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
-#endif
-           {
-             NETDEV_RXDROPPED(&g_sim_dev);
-             nwarn("WARNING: Unsupported Ethernet type %u\n", eth->type);
-           }
         }
       else
-        {
-          NETDEV_RXERRORS(&g_sim_dev);
-        }
+#endif
+       {
+         NETDEV_RXDROPPED(&g_sim_dev);
+         nwarn("WARNING: Unsupported Ethernet type %u\n", eth->type);
+       }
+    }
+  else
+    {
+      NETDEV_RXERRORS(&g_sim_dev);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void netdriver_loop(void)
+{
+  int nrx;
+
+  /* Check for new frames.  If so, then poll the network for new XMIT data */
+
+  net_lock();
+  (void)devif_poll(&g_sim_dev, sim_txpoll);
+  net_unlock();
+
+  /* Disable preemption through to the following so that it behaves a little more
+   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
+   * oddly.
+   */
+
+  sched_lock();
+
+  /* Wait up to 1 ms for a frame on the host device.  The network is not
+   * locked while waiting.  Then pass all of the frames that are waiting
+   * (up to the budget) to the network under one lock.
+   */
+
+  nrx = 0;
+  if (netdev_wait(1000))
+    {
+      nrx = netdev_rxbatch(&g_sim_dev, sim_receive, CONFIG_NETDEV_RXBUDGET);
     }
 
   /* Otherwise, it must be a timeout event */
 
-  else if (timer_expired(&g_periodic_timer))
+  if (nrx == 0 && timer_expired(&g_periodic_timer))
     {
       timer_reset(&g_periodic_timer);
       devif_timer(&g_sim_dev, sim_txpoll);
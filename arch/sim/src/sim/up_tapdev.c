@@ -240,6 +240,29 @@ void tapdev_init(void)
   up_setmacaddr();
 }
 
+int tapdev_wait(unsigned int usec)
+{
+  fd_set                fdset;
+  struct timeval        tv;
+
+  /* We can't do anything if we failed to open the tap device */
+
+  if (gtapdevfd < 0)
+    {
+      return 0;
+    }
+
+  /* Wait for data on the tap device (or a timeout) */
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = usec;
+
+  FD_ZERO(&fdset);
+  FD_SET(gtapdevfd, &fdset);
+
+  return select(gtapdevfd + 1, &fdset, NULL, NULL, &tv) > 0;
+}
+
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
 {
   fd_set                fdset;
@@ -253,10 +276,12 @@ unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
       return 0;
     }
 
-  /* Wait for data on the tap device (or a timeout) */
+  /* Check for data on the tap device without waiting.  Use tapdev_wait()
+   * to wait for it.
+   */
 
   tv.tv_sec  = 0;
-  tv.tv_usec = 1000;
+  tv.tv_usec = 0;
 
   FD_ZERO(&fdset);
   FD_SET(gtapdevfd, &fdset);
@@ -162,7 +162,7 @@ static int  skel_txpoll(FAR struct net_driver_s *dev);
 /* Interrupt handling */
 
 static void skel_reply(struct skel_driver_s *priv)
-static void skel_receive(FAR struct skel_driver_s *priv);
+static int  skel_receive(FAR struct net_driver_s *dev);
 static void skel_txdone(FAR struct skel_driver_s *priv);
 
 static void skel_interrupt_work(FAR void *arg);
@@ -384,105 +384,112 @@ static void skel_reply(struct skel_driver_s *priv)
  * Name: skel_receive
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Receive and dispatch the next RX packet.  This is the receive function
+ *   passed to netdev_rxbatch() when an interrupt indicates the availability
+ *   of new RX packets.
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   dev - Reference to the NuttX driver state structure
  *
  * Returned Value:
- *   None
+ *   Zero if a packet was received (and either dispatched or dropped);
+ *   -EAGAIN if there are no more RX packets.
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static void skel_receive(FAR struct skel_driver_s *priv)
+static int skel_receive(FAR struct net_driver_s *dev)
 {
-  do
-    {
-      /* Check for errors and update statistics */
+  FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)dev->d_private;
 
-      /* Check if the packet is a valid size for the network buffer
-       * configuration.
-       */
+  /* Check if there is another packet to be processed.  If not, return
+   * -EAGAIN.
+   */
 
-      /* Copy the data data from the hardware to priv->sk_dev.d_buf.  Set
-       * amount of data in priv->sk_dev.d_len
-       */
+  /* Check for errors and update statistics */
+
+  /* Check if the packet is a valid size for the network buffer
+   * configuration.
+   */
+
+  /* Copy the data data from the hardware to priv->sk_dev.d_buf.  Set
+   * amount of data in priv->sk_dev.d_len
+   */
 
 #ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the packet tap */
+  /* When packet sockets are enabled, feed the frame into the packet tap */
 
-       pkt_input(&priv->sk_dev);
+   pkt_input(&priv->sk_dev);
 #endif
 
 #ifdef CONFIG_NET_IPv4
-      /* Check for an IPv4 packet */
+  /* Check for an IPv4 packet */
 
-      if (BUF->type == HTONS(ETHTYPE_IP))
-        {
-          ninfo("IPv4 frame\n");
-          NETDEV_RXIPV4(&priv->sk_dev);
+  if (BUF->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(&priv->sk_dev);
 
-          /* Handle ARP on input, then dispatch IPv4 packet to the network
-           * layer.
-           */
+      /* Handle ARP on input, then dispatch IPv4 packet to the network
+       * layer.
+       */
 
-          arp_ipin(&priv->sk_dev);
-          ipv4_input(&priv->sk_dev);
+      arp_ipin(&priv->sk_dev);
+      ipv4_input(&priv->sk_dev);
 
-          /* Check for a reply to the IPv4 packet */
+      /* Check for a reply to the IPv4 packet */
 
-          skel_reply(priv);
-        }
-      else
+      skel_reply(priv);
+    }
+  else
 #endif
 #ifdef CONFIG_NET_IPv6
-      /* Check for an IPv6 packet */
+  /* Check for an IPv6 packet */
 
-      if (BUF->type == HTONS(ETHTYPE_IP6))
-        {
-          ninfo("Iv6 frame\n");
-          NETDEV_RXIPV6(&priv->sk_dev);
+  if (BUF->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("Iv6 frame\n");
+      NETDEV_RXIPV6(&priv->sk_dev);
 
-          /* Dispatch IPv6 packet to the network layer */
+      /* Dispatch IPv6 packet to the network layer */
 
-          ipv6_input(&priv->sk_dev);
+      ipv6_input(&priv->sk_dev);
 
-          /* Check for a reply to the IPv6 packet */
+      /* Check for a reply to the IPv6 packet */
 
-          skel_reply(priv);
-        }
-      else
+      skel_reply(priv);
+    }
+  else
 #endif
 #ifdef CONFIG_NET_ARP
-      /* Check for an ARP packet */
+  /* Check for an ARP packet */
 
-      if (BUF->type == htons(ETHTYPE_ARP))
-        {
-          /* Dispatch ARP packet to the network layer */
+  if (BUF->type == htons(ETHTYPE_ARP))
+    {
+      /* Dispatch ARP packet to the network layer */
 
-          arp_arpin(&priv->sk_dev);
-          NETDEV_RXARP(&priv->sk_dev);
+      arp_arpin(&priv->sk_dev);
+      NETDEV_RXARP(&priv->sk_dev);
 
-          /* If the above function invocation resulted in data that should be
-           * sent out on the network, the field  d_len will set to a value
-           * > 0.
-           */
+      /* If the above function invocation resulted in data that should be
+       * sent out on the network, the field  d_len will set to a value
+       * > 0.
+       */
 
-          if (priv->sk_dev.d_len > 0)
-            {
-              skel_transmit(priv);
-            }
-        }
-      else
-#endif
+      if (priv->sk_dev.d_len > 0)
         {
-          NETDEV_RXDROPPED(&priv->sk_dev);
+          skel_transmit(priv);
         }
     }
-  while (); /* While there are more packets to be processed */
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(&priv->sk_dev);
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -545,6 +552,7 @@ static void skel_txdone(FAR struct skel_driver_s *priv)
 static void skel_interrupt_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
+  int nrx;
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -560,9 +568,12 @@ static void skel_interrupt_work(FAR void *arg)
 
   /* Handle interrupts according to status bit settings */
 
-  /* Check if we received an incoming packet, if so, call skel_receive() */
+  /* Check if we received incoming packets, if so, pass a batch of them to
+   * the network.  The network lock is already held, so this costs no
+   * additional lock acquisition.
+   */
 
-  skel_receive(priv);
+  nrx = netdev_rxbatch(&priv->sk_dev, skel_receive, CONFIG_NETDEV_RXBUDGET);
 
   /* Check if a packet transmission just completed.  If so, call skel_txdone.
    * This may disable further Tx interrupts if there are no pending
@@ -572,6 +583,17 @@ static void skel_interrupt_work(FAR void *arg)
   skel_txdone(priv);
   net_unlock();
 
+  /* If the whole budget was used, then there are probably more RX packets
+   * waiting.  Leave Ethernet interrupts disabled and process the next batch
+   * from the work queue so that other work gets a chance to run.
+   */
+
+  if (nrx >= CONFIG_NETDEV_RXBUDGET)
+    {
+      work_queue(ETHWORK, &priv->sk_irqwork, skel_interrupt_work, priv, 0);
+      return;
+    }
+
   /* Re-enable Ethernet interrupts */
 
   up_enable_irq(CONFIG_skeleton_IRQ);
@@ -145,7 +145,7 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -425,6 +425,10 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
   ssize_t                nread  = 0;
+  size_t                 ncopy;
+#ifdef CONFIG_DEV_PIPE_DIRECTCOPY
+  bool                   direct;
+#endif
   int                    sval;
   int                    ret;
 
@@ -463,6 +467,21 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
           return 0;
         }
 
+#ifdef CONFIG_DEV_PIPE_DIRECTCOPY
+      /* Let the next writer copy directly into the caller's buffer unless
+       * another reader is already waiting for that.
+       */
+
+      direct = false;
+      if (dev->d_rdbuffer == NULL)
+        {
+          dev->d_rdbuffer = (FAR uint8_t *)buffer;
+          dev->d_rdlen    = len;
+          dev->d_rdcopied = 0;
+          direct          = true;
+        }
+#endif
+
       /* Otherwise, wait for something to be written to the pipe */
 
       sched_lock();
@@ -470,24 +489,71 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       ret = nxsem_wait(&dev->d_rdsem);
       sched_unlock();
 
+#ifdef CONFIG_DEV_PIPE_DIRECTCOPY
+      if (direct)
+        {
+          /* Withdraw the buffer.  This must be done even if the wait was
+           * interrupted so that no data written into it is lost.
+           */
+
+          pipecommon_semtake(&dev->d_bfsem);
+          nread           = dev->d_rdcopied;
+          dev->d_rdbuffer = NULL;
+
+          if (nread > 0)
+            {
+              /* Data in the pipe, if any, follows the data already copied */
+
+              buffer += nread;
+              break;
+            }
+          else if (ret < 0)
+            {
+              nxsem_post(&dev->d_bfsem);
+              return ret;
+            }
+
+          continue;
+        }
+#endif
+
       if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
         {
           return ret;
         }
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte unless some data was copied directly into the caller's buffer).
+   * The data is copied in at most two contiguous runs:  One up to the end
+   * of the circular buffer and one from the beginning.
+   */
 
-  nread = 0;
   while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
+      if (dev->d_wrndx > dev->d_rdndx)
         {
-          dev->d_rdndx = 0;
+          ncopy = dev->d_wrndx - dev->d_rdndx;
+        }
+      else
+        {
+          ncopy = dev->d_bufsize - dev->d_rdndx;
+        }
+
+      if (ncopy > len - nread)
+        {
+          ncopy = len - nread;
         }
 
-      nread++;
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], ncopy);
+      buffer += ncopy;
+      nread  += ncopy;
+
+      dev->d_rdndx += ncopy;
+      if (dev->d_rdndx >= dev->d_bufsize)
+        {
+          dev->d_rdndx = 0;
+        }
     }
 
   /* Notify all waiting writers that bytes have been removed from the buffer */
@@ -517,7 +583,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
+  size_t                 space;
   int                    sval;
   int                    ret;
 
@@ -565,31 +631,85 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
       return ret;
     }
 
+#ifdef CONFIG_DEV_PIPE_DIRECTCOPY
+  /* If a reader is waiting on the empty pipe, then copy directly into its
+   * buffer.  This saves copying the data into and back out of the pipe.
+   */
+
+  if (dev->d_rdbuffer != NULL && dev->d_wrndx == dev->d_rdndx &&
+      dev->d_rdcopied < dev->d_rdlen)
+    {
+      nwritten = dev->d_rdlen - dev->d_rdcopied;
+      if ((size_t)nwritten > len)
+        {
+          nwritten = len;
+        }
+
+      memcpy(&dev->d_rdbuffer[dev->d_rdcopied], buffer, nwritten);
+      dev->d_rdcopied += nwritten;
+      buffer          += nwritten;
+
+      if ((size_t)nwritten >= len)
+        {
+          /* Wake up the reader */
+
+          while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+            {
+              nxsem_post(&dev->d_rdsem);
+            }
+
+          nxsem_post(&dev->d_bfsem);
+          return len;
+        }
+    }
+#endif
+
   /* Loop until all of the bytes have been written */
 
   last = 0;
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Get the size of the contiguous free space following the write
+       * index.  One byte is always left unused so that a full buffer can
+       * be distinguished from an empty one.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      if (dev->d_rdndx > dev->d_wrndx)
+        {
+          space = dev->d_rdndx - dev->d_wrndx - 1;
+        }
+      else
         {
-          nxtwrndx = 0;
+          space = dev->d_bufsize - dev->d_wrndx;
+          if (dev->d_rdndx == 0)
+            {
+              space--;
+            }
         }
 
       /* Would the next write overflow the circular buffer? */
 
-      if (nxtwrndx != dev->d_rdndx)
+      if (space > 0)
         {
-          /* No... copy the byte */
+          /* No... copy as many bytes as will fit */
+
+          if (space > len - nwritten)
+            {
+              space = len - nwritten;
+            }
+
+          memcpy(&dev->d_buffer[dev->d_wrndx], buffer, space);
+          buffer   += space;
+          nwritten += space;
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          dev->d_wrndx += space;
+          if (dev->d_wrndx >= dev->d_bufsize)
+            {
+              dev->d_wrndx = 0;
+            }
 
           /* Is the write complete? */
 
-          nwritten++;
           if ((size_t)nwritten >= len)
             {
               /* Yes.. Notify all of the waiting readers that more data is available */
@@ -140,6 +140,11 @@ struct pipe_dev_s
   uint8_t    d_pipeno;      /* Pipe minor number */
   uint8_t    d_flags;       /* See PIPE_FLAG_* definitions */
   uint8_t   *d_buffer;      /* Buffer allocated when device opened */
+#ifdef CONFIG_DEV_PIPE_DIRECTCOPY
+  uint8_t   *d_rdbuffer;    /* Buffer of a reader waiting on an empty pipe */
+  size_t     d_rdlen;       /* Size of d_rdbuffer in bytes */
+  size_t     d_rdcopied;    /* Number of bytes written into d_rdbuffer */
+#endif
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -51,6 +51,7 @@
 
 #include <nuttx/ascii.h>
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
@@ -2663,7 +2664,7 @@ static int gs2200m_poll(FAR struct file *filep, FAR struct pollfd *fds,
       if (0 < n)
         {
           dev->pfd->revents |= POLLIN;
-          nxsem_post(dev->pfd->sem);
+          poll_notify(dev->pfd);
           wlinfo("==== _notif_q_count=%d \n", n);
         }
     }
@@ -2793,7 +2794,7 @@ static void gs2200m_irq_worker(FAR void *arg)
       /* If poll() waits and cid has been pushed to the queue, notify  */
 
       dev->pfd->revents |= POLLIN;
-      nxsem_post(dev->pfd->sem);
+      poll_notify(dev->pfd);
     }
 
 errout:
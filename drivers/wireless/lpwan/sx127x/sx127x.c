@@ -50,6 +50,7 @@
 #include <time.h>
 #include <fcntl.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/wqueue.h>
@@ -1263,7 +1264,7 @@ static int sx127x_poll(FAR struct file *filep, FAR struct pollfd *fds,
           /* Data available for input */
 
           dev->pfd->revents |= POLLIN;
-          nxsem_post(dev->pfd->sem);
+          poll_notify(dev->pfd);
         }
 
       nxsem_post(&dev->rx_buffer_sem);
@@ -1349,7 +1350,7 @@ static int sx127x_lora_isr0_process(FAR struct sx127x_dev_s *dev)
                       dev->pfd->revents |= POLLIN;
 
                       wlinfo("Wake up polled fd\n");
-                      nxsem_post(dev->pfd->sem);
+                      poll_notify(dev->pfd);
                     }
 
                   /* Wake-up any thread waiting in recv */
@@ -1484,7 +1485,7 @@ static int sx127x_fskook_isr0_process(FAR struct sx127x_dev_s *dev)
                       dev->pfd->revents |= POLLIN;
 
                       wlinfo("Wake up polled fd\n");
-                      nxsem_post(dev->pfd->sem);
+                      poll_notify(dev->pfd);
                     }
 
                   /* Wake-up any thread waiting in recv */
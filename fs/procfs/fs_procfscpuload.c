@@ -55,6 +55,7 @@
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -69,7 +70,11 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CPULOAD_LINELEN 16
+#ifdef CONFIG_SCHED_CPUBALANCE
+#  define CPULOAD_LINELEN (16 + 32 * CONFIG_SMP_NCPUS)
+#else
+#  define CPULOAD_LINELEN 16
+#endif
 
 /****************************************************************************
  * Private Types
@@ -226,6 +231,9 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
       struct cpuload_s cpuload;
       uint32_t intpart;
       uint32_t fracpart;
+#ifdef CONFIG_SCHED_CPUBALANCE
+      int i;
+#endif
 
       /* Sample the counts for the IDLE thread.  clock_cpuload should only
        * fail if the PID is not valid.  This, however, should never happen
@@ -255,6 +263,18 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
       linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%\n",
                           intpart, fracpart);
 
+#ifdef CONFIG_SCHED_CPUBALANCE
+      /* Followed by the number of task migrations onto each CPU */
+
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          linesize += snprintf(&attr->line[linesize],
+                               CPULOAD_LINELEN - linesize,
+                               "CPU%d migrations: %lu\n", i,
+                               (unsigned long)g_cpu_migrations[i]);
+        }
+#endif
+
       /* Save the linesize in case we are re-entered with f_pos > 0 */
 
       attr->linesize = linesize;
@@ -0,0 +1,396 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheapprof.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_HEAPPROF) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAPPROF)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAPPROF_LINELEN 112
+
+/* The user heap structure is only accessible here in the flat build */
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+#  define HAVE_USER_HEAP 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct heapprof_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[HEAPPROF_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure describes one profiled heap */
+
+struct heapprof_heap_s
+{
+  FAR const char *name;           /* Name shown in the HEAP column */
+  FAR struct mm_heap_s *heap;     /* The heap */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     heapprof_close(FAR struct file *filep);
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t heapprof_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     heapprof_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heapprof_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct heapprof_heap_s g_heapprof_heaps[] =
+{
+#ifdef CONFIG_MM_KERNEL_HEAP
+  { "kmm",  &g_kmmheap },
+#endif
+#ifdef HAVE_USER_HEAP
+  { "umm",  &g_mmheap },
+#endif
+};
+
+#define HEAPPROF_NHEAPS \
+  (sizeof(g_heapprof_heaps) / sizeof(struct heapprof_heap_s))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations heapprof_operations =
+{
+  heapprof_open,   /* open */
+  heapprof_close,  /* close */
+  heapprof_read,   /* read */
+  heapprof_write,  /* write */
+  heapprof_dup,    /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  heapprof_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_open
+ ****************************************************************************/
+
+static int heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct heapprof_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* "heapprof" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heapprof") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct heapprof_file_s *)
+    kmm_zalloc(sizeof(struct heapprof_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_close
+ ****************************************************************************/
+
+static int heapprof_close(FAR struct file *filep)
+{
+  FAR struct heapprof_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct heapprof_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_read
+ ****************************************************************************/
+
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct heapprof_file_s *proffile;
+  struct mm_profsite_s site;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  proffile = (FAR struct heapprof_file_s *)filep->f_priv;
+  DEBUGASSERT(proffile);
+
+  /* The first line is the headers */
+
+  linesize  = snprintf(proffile->line, HEAPPROF_LINELEN,
+                       "%-5s%-19s%6s%8s%11s%11s%11s%8s%11s\n",
+                       "HEAP", "CALLER", "PID", "LIVE", "LIVEBYTES",
+                       "PEAKBYTES", "ALLOCS", "NEW", "NEWBYTES");
+
+  copysize  = procfs_memcpy(proffile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+  buffer   += copysize;
+  buflen   -= copysize;
+
+  /* Then one line for each allocation site of each heap.  Site zero
+   * collects the allocations from all sites that did not fit into the
+   * table; its caller is shown as zero.
+   */
+
+  for (i = 0; i < HEAPPROF_NHEAPS; i++)
+    {
+      for (j = 0; j < MM_PROF_NSITES && buflen > 0; j++)
+        {
+          if (mm_profsite(g_heapprof_heaps[i].heap, j, &site) < 0 ||
+              site.ps_nalloc == 0)
+            {
+              continue;
+            }
+
+          linesize   = snprintf(proffile->line, HEAPPROF_LINELEN,
+                                "%-5s0x%-17lx%6d%8lu%11lu%11lu%11lu%8lu"
+                                "%11lu\n",
+                                g_heapprof_heaps[i].name,
+                                (unsigned long)(uintptr_t)site.ps_caller,
+                                (int)site.ps_pid,
+                                (unsigned long)site.ps_nlive,
+                                (unsigned long)site.ps_live,
+                                (unsigned long)site.ps_peak,
+                                site.ps_nalloc,
+                                (unsigned long)site.ps_nsnap,
+                                (unsigned long)site.ps_snap);
+
+          copysize   = procfs_memcpy(proffile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heapprof_write
+ *
+ * Description:
+ *   Writing "snapshot" starts a new snapshot on all heaps.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen)
+{
+  size_t len = buflen;
+  int i;
+
+  /* Ignore a trailing newline */
+
+  if (len > 0 && buffer[len - 1] == '\n')
+    {
+      len--;
+    }
+
+  if (len != 8 || strncmp(buffer, "snapshot", 8) != 0)
+    {
+      ferr("ERROR: Only \"snapshot\" is supported\n");
+      return -EINVAL;
+    }
+
+  for (i = 0; i < HEAPPROF_NHEAPS; i++)
+    {
+      mm_profsnapshot(g_heapprof_heaps[i].heap);
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: heapprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heapprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapprof_file_s *oldattr;
+  FAR struct heapprof_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heapprof_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct heapprof_file_s *)
+    kmm_malloc(sizeof(struct heapprof_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct heapprof_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heapprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "heapprof" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heapprof") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "heapprof" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_MM_HEAPPROF && !CONFIG_FS_PROCFS_EXCLUDE_HEAPPROF */
@@ -147,9 +147,15 @@ static FAR const char *g_iob_user_names[] =
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   "tcp_writebuffer",
 #endif
+#ifdef CONFIG_NET_SENDFILE_IOB
+  "tcp_sendfile",
+#endif
 #ifdef CONFIG_NET_IPFORWARD
   "ipforward",
 #endif
+#ifdef CONFIG_NET_ARP_QUEUE
+  "arp_queue",
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   "rad802154",
 #endif
@@ -42,194 +42,1444 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <poll.h>
+#include <queue.h>
+#include <assert.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
-#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The initial and the minimum number of hash buckets in the interest set.
+ * This must be a power of two.  The interest set doubles in size whenever
+ * the number of registered descriptors exceeds the number of buckets.
+ */
+
+#define EPOLL_MINBUCKETS  8
+
+/* Hash a descriptor to its bucket.  Descriptors are small integers, so the
+ * low order bits are as good as anything.
+ */
+
+#define EPOLL_HASH(eph, fd) ((unsigned int)(fd) & ((eph)->nbuckets - 1))
+
+/* The poll events that may be requested from the driver */
+
+#define EPOLL_POLLEVENTS  (EPOLLIN | EPOLLOUT | EPOLLPRI | EPOLLERR | \
+                           EPOLLHUP)
+
+/* The number of buckets in the hash table of registered files and sockets.
+ * This must be a power of two.
+ */
+
+#define EPOLL_NOBJBUCKETS 32
+
+/* Hash the address of a registered file or socket structure to its bucket */
+
+#define EPOLL_OBJHASH(obj) \
+  ((unsigned int)(((uintptr_t)(obj) >> 4) ^ ((uintptr_t)(obj) >> 10)) & \
+   (EPOLL_NOBJBUCKETS - 1))
+
+#ifndef CONFIG_FS_EPOLL_NPOLLWAITERS
+#  define CONFIG_FS_EPOLL_NPOLLWAITERS 2
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct epoll_head_s;
+
+/* One registered file or socket descriptor */
+
+struct epoll_item_s
+{
+  struct pollfd pfd;                /* Registered with the driver */
+  union
+  {
+    FAR struct file *filep;         /* The registered file */
+#ifdef CONFIG_NET
+    FAR struct socket *psock;       /* The registered socket */
+#endif
+  } u;
+  dq_entry_t rnode;                 /* Link in the ready list */
+  FAR struct epoll_item_s *flink;   /* Link in the interest set hash chain */
+  FAR struct epoll_item_s *olink;   /* Link in the g_epoll_objects chain */
+  FAR struct epoll_head_s *eph;     /* The containing epoll instance */
+  uint32_t events;                  /* Requested events and EPOLL* flags */
+  epoll_data_t data;                /* User data returned with events */
+  bool issock;                      /* True: u.psock, false: u.filep */
+  bool armed;                       /* True: The poll is set up */
+  bool ready;                       /* True: In the ready list */
+  bool rearmed;                     /* True: Re-armed after a report */
+};
+
+/* One epoll instance.  This is the private data of an anonymous inode that
+ * is bound to the epoll file descriptor.
+ */
+
+struct epoll_head_s
+{
+  sem_t exclsem;                    /* Protects the interest set */
+  sem_t waitsem;                    /* epoll_wait() waits here */
+  uint8_t crefs;                    /* Number of open file references */
+  unsigned int nusers;              /* Number of epoll_ctl/wait() calls */
+  unsigned int nbuckets;            /* Number of hash buckets (power of 2) */
+  unsigned int nitems;              /* Number of registered descriptors */
+  FAR struct epoll_item_s **hash;   /* The interest set, hashed by fd */
+  dq_queue_t rdlist;                /* Items with pending events */
+
+  /* Polls of the epoll descriptor itself */
+
+  FAR struct pollfd *poll[CONFIG_FS_EPOLL_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep);
+static int epoll_close_file(FAR struct file *filep);
+static int epoll_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  epoll_open,       /* open */
+  epoll_close_file, /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  NULL,             /* ioctl */
+  epoll_poll        /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL            /* unlink */
+#endif
+};
+
+/* Every registered file and socket, hashed by the address of its struct
+ * file or struct socket, so that the registrations can be found when the
+ * descriptor is closed.  g_epoll_sem protects this table and the lifetime
+ * of every epoll instance.  It must be taken before the exclsem of any
+ * epoll instance.
+ */
+
+static sem_t g_epoll_sem = SEM_INITIALIZER(1);
+static FAR struct epoll_item_s *g_epoll_objects[EPOLL_NOBJBUCKETS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#define epoll_semgive(sem) nxsem_post(sem)
+
+/****************************************************************************
+ * Name: epoll_gethead
+ *
+ * Description:
+ *   Return the epoll instance bound to an epoll file descriptor with a
+ *   reference held for the duration of an epoll_ctl() or epoll_wait()
+ *   call.  The instance stays valid even if another thread closes the
+ *   descriptor during the call.  The reference must be released with
+ *   epoll_puthead().
+ *
+ ****************************************************************************/
+
+static int epoll_gethead(int epfd, FAR struct epoll_head_s **eph)
+{
+  FAR struct file *filep;
+  FAR struct inode *inode;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+
+  ret = fs_getfilep(epfd, &filep);
+  if (ret >= 0)
+    {
+      inode = filep->f_inode;
+      if (inode == NULL || inode->i_private == NULL)
+        {
+          /* Not open or being closed */
+
+          ret = -EBADF;
+        }
+      else if (inode->u.i_ops != &g_epoll_ops)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          *eph = (FAR struct epoll_head_s *)inode->i_private;
+          (*eph)->nusers++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_lookup
+ *
+ * Description:
+ *   Find the file or socket structure of a descriptor.  The item refers to
+ *   that structure without holding a reference of its own:  The item is
+ *   removed by epoll_fdclose() when the descriptor is closed.
+ *
+ ****************************************************************************/
+
+static int epoll_lookup(FAR struct epoll_item_s *item, int fd)
+{
+  FAR struct file *filep;
+  int ret;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+#ifdef CONFIG_NET
+      if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS +
+                              CONFIG_NSOCKET_DESCRIPTORS))
+        {
+          FAR struct socket *psock = sockfd_socket(fd);
+
+          if (psock == NULL || psock->s_crefs <= 0)
+            {
+              return -EBADF;
+            }
+
+          item->u.psock = psock;
+          item->issock  = true;
+          return OK;
+        }
+      else
+#endif
+        {
+          return -EBADF;
+        }
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode == NULL)
+    {
+      return -EBADF;
+    }
+
+  item->u.filep = filep;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_object
+ *
+ * Description:
+ *   Return the file or socket structure that an item is registered on.
+ *
+ ****************************************************************************/
+
+static FAR void *epoll_object(FAR struct epoll_item_s *item)
+{
+#ifdef CONFIG_NET
+  if (item->issock)
+    {
+      return item->u.psock;
+    }
+#endif
+
+  return item->u.filep;
+}
+
+/****************************************************************************
+ * Name: epoll_attach
+ *
+ * Description:
+ *   Add an item to the table of registered files and sockets.  The caller
+ *   holds g_epoll_sem.
+ *
+ ****************************************************************************/
+
+static void epoll_attach(FAR struct epoll_item_s *item)
+{
+  unsigned int ndx = EPOLL_OBJHASH(epoll_object(item));
+
+  item->olink          = g_epoll_objects[ndx];
+  g_epoll_objects[ndx] = item;
+}
+
+/****************************************************************************
+ * Name: epoll_detach
+ *
+ * Description:
+ *   Remove an item from the table of registered files and sockets.  The
+ *   caller holds g_epoll_sem.
+ *
+ ****************************************************************************/
+
+static void epoll_detach(FAR struct epoll_item_s *item)
+{
+  FAR struct epoll_item_s **prev;
+
+  prev = &g_epoll_objects[EPOLL_OBJHASH(epoll_object(item))];
+  while (*prev != item)
+    {
+      DEBUGASSERT(*prev != NULL);
+      prev = &(*prev)->olink;
+    }
+
+  *prev = item->olink;
+}
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Set up or tear down the poll of the file or socket of an item.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(FAR struct epoll_item_s *item, bool setup)
+{
+#ifdef CONFIG_NET
+  if (item->issock)
+    {
+      return psock_poll(item->u.psock, &item->pfd, setup);
+    }
+#endif
+
+  return file_poll(item->u.filep, &item->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_notify
+ *
+ * Description:
+ *   The poll notification callback of each registered descriptor.  The
+ *   driver has posted new events in fds->revents:  Queue the item in the
+ *   ready list (if it is not already there) and wake up any waiter.
+ *
+ *   This may run in an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void epoll_notify(FAR struct pollfd *fds)
+{
+  FAR struct epoll_item_s *item =
+    container_of(fds, struct epoll_item_s, pfd);
+  FAR struct epoll_head_s *eph = item->eph;
+  irqstate_t flags;
+  int semcount;
+  int i;
+
+  flags = enter_critical_section();
+  if (!item->ready && fds->revents != 0)
+    {
+      item->ready = true;
+      dq_addlast(&item->rnode, &eph->rdlist);
+
+      /* Wake up one thread waiting in epoll_wait() */
+
+      nxsem_getvalue(&eph->waitsem, &semcount);
+      if (semcount < 0)
+        {
+          nxsem_post(&eph->waitsem);
+        }
+
+      /* And anyone polling the epoll descriptor itself */
+
+      for (i = 0; i < CONFIG_FS_EPOLL_NPOLLWAITERS; i++)
+        {
+          FAR struct pollfd *poll = eph->poll[i];
+
+          if (poll != NULL)
+            {
+              poll->revents |= (poll->events & POLLIN);
+              if (poll->revents != 0)
+                {
+                  poll_notify(poll);
+                }
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Set up the poll on the descriptor of an item.  The driver will report
+ *   any events that are already pending through epoll_notify().
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_item_s *item)
+{
+  int ret;
+
+  DEBUGASSERT(!item->armed);
+
+  item->pfd.events  = (pollevent_t)(item->events & EPOLL_POLLEVENTS) |
+                      POLLERR | POLLHUP;
+  item->pfd.revents = 0;
+  item->pfd.priv    = NULL;
+
+  ret = epoll_fdsetup(item, true);
+  if (ret >= 0)
+    {
+      item->armed = true;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Tear down the poll on the descriptor of an item and remove the item
+ *   from the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_item_s *item)
+{
+  irqstate_t flags;
+
+  if (item->armed)
+    {
+      (void)epoll_fdsetup(item, false);
+      item->armed = false;
+    }
+
+  item->rearmed = false;
+
+  flags = enter_critical_section();
+  if (item->ready)
+    {
+      dq_rem(&item->rnode, &eph->rdlist);
+      item->ready = false;
+    }
+
+  item->pfd.revents = 0;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Find the item for a descriptor in the interest set.  If pprev is not
+ *   NULL, then the location of the link to the item is also returned.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_item_s *
+epoll_find(FAR struct epoll_head_s *eph, int fd,
+           FAR struct epoll_item_s ***pprev)
+{
+  FAR struct epoll_item_s **prev;
+  FAR struct epoll_item_s *item;
+
+  for (prev = &eph->hash[EPOLL_HASH(eph, fd)], item = *prev;
+       item != NULL;
+       prev = &item->flink, item = *prev)
+    {
+      if (item->pfd.fd == fd)
+        {
+          if (pprev != NULL)
+            {
+              *pprev = prev;
+            }
+
+          return item;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_grow
+ *
+ * Description:
+ *   Double the number of hash buckets in the interest set.  Failure to
+ *   allocate the larger table is not an error:  The chains just get longer.
+ *
+ ****************************************************************************/
+
+static void epoll_grow(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_item_s **hash;
+  FAR struct epoll_item_s *item;
+  FAR struct epoll_item_s *next;
+  unsigned int nbuckets = eph->nbuckets << 1;
+  unsigned int i;
+
+  hash = (FAR struct epoll_item_s **)
+    kmm_zalloc(nbuckets * sizeof(FAR struct epoll_item_s *));
+  if (hash == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < eph->nbuckets; i++)
+    {
+      for (item = eph->hash[i]; item != NULL; item = next)
+        {
+          unsigned int ndx = (unsigned int)item->pfd.fd & (nbuckets - 1);
+
+          next        = item->flink;
+          item->flink = hash[ndx];
+          hash[ndx]   = item;
+        }
+    }
+
+  kmm_free(eph->hash);
+  eph->hash     = hash;
+  eph->nbuckets = nbuckets;
+}
+
+/****************************************************************************
+ * Name: epoll_add
+ *
+ * Description:
+ *   Add a descriptor to the interest set.  The caller holds g_epoll_sem
+ *   and the exclsem of the epoll instance.
+ *
+ ****************************************************************************/
+
+static int epoll_add(FAR struct epoll_head_s *eph, int fd,
+                     FAR struct epoll_event *ev)
+{
+  FAR struct epoll_item_s *item;
+  unsigned int ndx;
+  int ret;
+
+  if (epoll_find(eph, fd, NULL) != NULL)
+    {
+      return -EEXIST;
+    }
+
+  item = (FAR struct epoll_item_s *)kmm_zalloc(sizeof(struct epoll_item_s));
+  if (item == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  item->pfd.fd  = fd;
+  item->pfd.sem = &eph->waitsem;
+  item->pfd.cb  = epoll_notify;
+  item->eph     = eph;
+  item->events  = ev->events;
+  item->data    = ev->data;
+
+  ret = epoll_lookup(item, fd);
+  if (ret < 0)
+    {
+      kmm_free(item);
+      return ret;
+    }
+
+  ret = epoll_arm(item);
+  if (ret < 0)
+    {
+      epoll_disarm(eph, item);
+      kmm_free(item);
+      return ret;
+    }
+
+  epoll_attach(item);
+
+  ndx             = EPOLL_HASH(eph, fd);
+  item->flink     = eph->hash[ndx];
+  eph->hash[ndx]  = item;
+
+  if (++eph->nitems > eph->nbuckets)
+    {
+      epoll_grow(eph);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_modify
+ ****************************************************************************/
+
+static int epoll_modify(FAR struct epoll_head_s *eph, int fd,
+                        FAR struct epoll_event *ev)
+{
+  FAR struct epoll_item_s *item;
+
+  item = epoll_find(eph, fd, NULL);
+  if (item == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* Re-register with the new event set.  This also re-enables an item
+   * disabled by EPOLLONESHOT.
+   */
+
+  epoll_disarm(eph, item);
+
+  item->events = ev->events;
+  item->data   = ev->data;
+
+  return epoll_arm(item);
+}
+
+/****************************************************************************
+ * Name: epoll_remove
+ *
+ * Description:
+ *   Remove an item from the interest set and free it.  The caller holds
+ *   g_epoll_sem and the exclsem of the epoll instance.
+ *
+ ****************************************************************************/
+
+static void epoll_remove(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_item_s **prev)
+{
+  FAR struct epoll_item_s *item = *prev;
+
+  *prev = item->flink;
+  eph->nitems--;
+
+  epoll_disarm(eph, item);
+  epoll_detach(item);
+  kmm_free(item);
+}
+
+/****************************************************************************
+ * Name: epoll_delete
+ ****************************************************************************/
+
+static int epoll_delete(FAR struct epoll_head_s *eph, int fd)
+{
+  FAR struct epoll_item_s **prev;
+
+  if (epoll_find(eph, fd, &prev) == NULL)
+    {
+      return -ENOENT;
+    }
+
+  epoll_remove(eph, prev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
+ *
+ * Description:
+ *   Tear down and set up again the poll of an item so that the driver
+ *   reports its current state.  If the item is still ready, it goes right
+ *   back into the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_rearm(FAR struct epoll_head_s *eph,
+                        FAR struct epoll_item_s *item)
+{
+  irqstate_t flags;
+
+  epoll_disarm(eph, item);
+  if (epoll_arm(item) < 0)
+    {
+      /* Report the failure the next time around */
+
+      flags = enter_critical_section();
+      item->pfd.revents = POLLERR;
+      if (!item->ready)
+        {
+          item->ready = true;
+          dq_addlast(&item->rnode, &eph->rdlist);
+        }
+
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Remove up to maxevents items from the ready list and return their
+ *   events.  Only the items that are actually ready are visited.
+ *
+ *   Level-triggered items are re-armed afterward so that the driver will
+ *   report them again if they are still ready.  That is deferred until all
+ *   events have been collected so that an item can be returned only once
+ *   per call.  The events reported by the re-arm may be stale by the time
+ *   of the next call (the data may have been read in the meantime), so
+ *   such items are sampled again before they are returned.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_item_s *item;
+  FAR dq_entry_t *node;
+  dq_queue_t rearm;
+  pollevent_t revents;
+  irqstate_t flags;
+  int nevents = 0;
+
+  dq_init(&rearm);
+
+  while (nevents < maxevents)
+    {
+      flags = enter_critical_section();
+      node  = dq_remfirst(&eph->rdlist);
+      if (node == NULL)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      item              = container_of(node, struct epoll_item_s, rnode);
+      item->ready       = false;
+      revents           = item->pfd.revents;
+      item->pfd.revents = 0;
+      leave_critical_section(flags);
+
+      if (item->rearmed)
+        {
+          /* Sample the current state.  The item is queued again at the end
+           * of the ready list if it is still ready.
+           */
+
+          epoll_rearm(eph, item);
+          continue;
+        }
+
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = item->data;
+      nevents++;
+
+      if ((item->events & EPOLLONESHOT) != 0)
+        {
+          /* Disabled until re-enabled with EPOLL_CTL_MOD */
+
+          epoll_disarm(eph, item);
+        }
+      else if ((item->events & EPOLLET) == 0)
+        {
+          dq_addlast(&item->rnode, &rearm);
+        }
+
+      /* Edge-triggered items stay armed.  They will be queued again on the
+       * next event from the driver.
+       */
+    }
+
+  /* Now re-arm the level-triggered items.  Those that are still ready will
+   * go right back into the ready list.
+   */
+
+  while ((node = dq_remfirst(&rearm)) != NULL)
+    {
+      item = container_of(node, struct epoll_item_s, rnode);
+
+      epoll_rearm(eph, item);
+      item->rearmed = item->armed;
+    }
+
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_free
+ *
+ * Description:
+ *   Tear down all registrations and free an epoll instance that is no
+ *   longer referenced.
+ *
+ ****************************************************************************/
+
+static void epoll_free(FAR struct epoll_head_s *eph)
+{
+  unsigned int i;
+
+  epoll_semtake(&g_epoll_sem);
+
+  for (i = 0; i < eph->nbuckets; i++)
+    {
+      while (eph->hash[i] != NULL)
+        {
+          epoll_remove(eph, &eph->hash[i]);
+        }
+    }
+
+  epoll_semgive(&g_epoll_sem);
+
+  kmm_free(eph->hash);
+  nxsem_destroy(&eph->waitsem);
+  nxsem_destroy(&eph->exclsem);
+  kmm_free(eph);
+}
+
+/****************************************************************************
+ * Name: epoll_puthead
+ *
+ * Description:
+ *   Release the reference taken by epoll_gethead().  The instance is freed
+ *   if the epoll descriptor was closed during the call.
+ *
+ ****************************************************************************/
+
+static void epoll_puthead(FAR struct epoll_head_s *eph)
+{
+  irqstate_t flags;
+  bool last;
+
+  flags = enter_critical_section();
+  last  = (--eph->nusers == 0 && eph->crefs == 0);
+  leave_critical_section(flags);
+
+  if (last)
+    {
+      epoll_free(eph);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_open
+ *
+ * Description:
+ *   The epoll descriptor was duplicated.
+ *
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (eph->crefs >= 255)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      eph->crefs++;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_close_file
+ *
+ * Description:
+ *   Release a reference to the epoll instance.  The last close unbinds the
+ *   instance from the inode and frees it, unless an epoll_ctl() or
+ *   epoll_wait() call is still using it; then the instance is freed when
+ *   that call returns.  The anonymous inode itself is freed when its last
+ *   reference is released.
+ *
+ ****************************************************************************/
+
+static int epoll_close_file(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)inode->i_private;
+  irqstate_t flags;
+  bool last = false;
+
+  flags = enter_critical_section();
+  if (--eph->crefs == 0)
+    {
+      inode->i_private = NULL;
+      last = (eph->nusers == 0);
+    }
+
+  leave_critical_section(flags);
+
+  if (last)
+    {
+      epoll_free(eph);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_poll
+ *
+ * Description:
+ *   Poll the epoll descriptor itself.  It is readable when there are
+ *   pending events.  Up to CONFIG_FS_EPOLL_NPOLLWAITERS pollers are
+ *   supported at a time.
+ *
+ ****************************************************************************/
+
+static int epoll_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_FS_EPOLL_NPOLLWAITERS; i++)
+        {
+          if (eph->poll[i] == NULL)
+            {
+              eph->poll[i] = fds;
+              break;
+            }
+        }
+
+      if (i >= CONFIG_FS_EPOLL_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else if (!dq_empty(&eph->rdlist))
+        {
+          fds->revents |= (fds->events & POLLIN);
+          if (fds->revents != 0)
+            {
+              poll_notify(fds);
+            }
+        }
+    }
+  else
+    {
+      for (i = 0; i < CONFIG_FS_EPOLL_NPOLLWAITERS; i++)
+        {
+          if (eph->poll[i] == fds)
+            {
+              eph->poll[i] = NULL;
+              break;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: epoll_create
+ * Name: epoll_create1
  *
  * Description:
+ *   Create a new epoll instance and return a file descriptor referring to
+ *   it.  The instance is released when the last descriptor referring to
+ *   it is closed.
  *
  * Input Parameters:
+ *   flags - Zero or EPOLL_CLOEXEC
  *
  * Returned Value:
+ *   A new file descriptor on success; -1 (ERROR) on failure with errno
+ *   set appropriately:
+ *
+ *   EINVAL - Invalid flags
+ *   EMFILE - No free file descriptors
+ *   ENOMEM - Out of memory
  *
  ****************************************************************************/
 
-int epoll_create(int size)
+int epoll_create1(int flags)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if ((flags & ~EPOLL_CLOEXEC) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  eph->hash = (FAR struct epoll_item_s **)
+    kmm_zalloc(EPOLL_MINBUCKETS * sizeof(FAR struct epoll_item_s *));
+  if (eph->hash == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_eph;
+    }
+
+  /* The epoll instance is bound to an anonymous inode.  It is never linked
+   * into the pseudo-filesystem tree and is marked as deleted so that it is
+   * freed when the last reference is released.
+   */
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_hash;
+    }
+
+  inode->i_crefs   = 1;
+  inode->i_flags   = FSNODEFLAG_TYPE_DRIVER | FSNODEFLAG_DELETED;
+  inode->u.i_ops   = &g_epoll_ops;
+  inode->i_private = eph;
+
+  eph->crefs    = 1;
+  eph->nbuckets = EPOLL_MINBUCKETS;
+  dq_init(&eph->rdlist);
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  nxsem_init(&eph->exclsem, 0, 1);
+  nxsem_init(&eph->waitsem, 0, 0);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
    */
 
-  return (int)((intptr_t)eph);
+  nxsem_setprotocol(&eph->waitsem, SEM_PRIO_NONE);
+
+  fd = files_allocate(inode, O_RDWR, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      goto errout_with_sem;
+    }
+
+  return fd;
+
+errout_with_sem:
+  nxsem_destroy(&eph->waitsem);
+  nxsem_destroy(&eph->exclsem);
+  kmm_free(inode);
+
+errout_with_hash:
+  kmm_free(eph->hash);
+
+errout_with_eph:
+  kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
 }
 
 /****************************************************************************
- * Name: epoll_close
+ * Name: epoll_create
  *
  * Description:
+ *   Create a new epoll instance.  The size is only a hint:  The interest
+ *   set grows as descriptors are added.
  *
  * Input Parameters:
+ *   size - Must be greater than zero
  *
  * Returned Value:
+ *   See epoll_create1()
  *
  ****************************************************************************/
 
-void epoll_close(int epfd)
+int epoll_create(int size)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  if (size <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  return epoll_create1(0);
+}
 
-  kmm_free(eph->evs);
-  kmm_free(eph);
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Close an epoll instance.  This is equivalent to close(epfd).
+ *
+ * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  (void)close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a descriptor in the interest set of an epoll
+ *   instance.
+ *
+ *   The registration refers to the file or socket of the descriptor but
+ *   holds no reference to it:  Closing the descriptor removes it from the
+ *   interest set of every epoll instance.  Note that the registration
+ *   belongs to the descriptor that was registered; it is removed even if
+ *   other descriptors still refer to the same file or socket.
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD, or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor of interest
+ *   ev   - The requested events (EPOLLIN, EPOLLOUT, ...) and flags
+ *          (EPOLLET, EPOLLONESHOT), and the user data to be returned with
+ *          events.  Ignored for EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with errno set
+ *   appropriately:
+ *
+ *   EBADF  - epfd or fd is not a valid descriptor
+ *   EEXIST - EPOLL_CTL_ADD of a descriptor that is already registered
+ *   EINVAL - epfd is not an epoll descriptor, fd is epfd, or op is invalid
+ *   ENOENT - EPOLL_CTL_MOD or EPOLL_CTL_DEL of an unregistered descriptor
+ *   ENOMEM - Out of memory
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  FAR struct epoll_head_s *eph;
+  bool global;
+  int ret;
+
+  ret = epoll_gethead(epfd, &eph);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (fd == epfd || fd < 0)
+    {
+      ret = fd < 0 ? -EBADF : -EINVAL;
+      goto errout_with_eph;
+    }
+
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      ret = -EINVAL;
+      goto errout_with_eph;
+    }
+
+  /* Adding or removing a descriptor also changes the table of registered
+   * files and sockets.
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  global = (op != EPOLL_CTL_MOD);
+  if (global)
+    {
+      epoll_semtake(&g_epoll_sem);
+    }
+
+  epoll_semtake(&eph->exclsem);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
+        finfo("%d CTL ADD(%u): fd=%d ev=%08lx\n",
+              epfd, eph->nitems, fd, (unsigned long)ev->events);
+        ret = epoll_add(eph, fd, ev);
+        break;
 
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+      case EPOLL_CTL_MOD:
+        finfo("%d CTL MOD(%u): fd=%d ev=%08lx\n",
+              epfd, eph->nitems, fd, (unsigned long)ev->events);
+        ret = epoll_modify(eph, fd, ev);
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
+        finfo("%d CTL DEL(%u): fd=%d\n", epfd, eph->nitems, fd);
+        ret = epoll_delete(eph, fd);
+        break;
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied - 1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-          return -ENOENT;
-        }
+  epoll_semgive(&eph->exclsem);
 
-      case EPOLL_CTL_MOD:
-        {
-          int i;
+  if (global)
+    {
+      epoll_semgive(&g_epoll_sem);
+    }
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+  if (ret < 0)
+    {
+      goto errout_with_eph;
+    }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+  epoll_puthead(eph);
+  return OK;
 
-          return -ENOENT;
-        }
-    }
+errout_with_eph:
+  epoll_puthead(eph);
 
-  return -EINVAL;
+errout:
+  set_errno(-ret);
+  return ERROR;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on an epoll instance.  The cost is proportional to the
+ *   number of ready descriptors, not to the size of the interest set.
  *
  * Input Parameters:
+ *   epfd      - The epoll file descriptor
+ *   evs       - The location to return events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The maximum time to wait in milliseconds.  Zero means to
+ *               return immediately; a negative value means to wait
+ *               forever.
  *
  * Returned Value:
+ *   The number of events returned (zero on timeout) on success; -1 (ERROR)
+ *   on failure with errno set appropriately:
+ *
+ *   EBADF  - epfd is not a valid descriptor
+ *   EINTR  - A signal was received before any event
+ *   EINVAL - epfd is not an epoll descriptor or maxevents is not positive
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  irqstate_t flags;
+  clock_t start = 0;
+  clock_t ticks = 0;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = epoll_gethead(epfd, &eph);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (evs == NULL || maxevents <= 0)
+    {
+      ret = -EINVAL;
+      goto errout_with_eph;
+    }
+
+  if (timeout > 0)
+    {
+      /* Round the timeout up to the next full tick as does poll() */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
+      start = clock_systimer();
+    }
 
-  if (rc <= 0)
+  for (; ; )
     {
-      if (rc < 0)
+      /* Wait until something is in the ready list.  The check and the wait
+       * must be atomic with respect to epoll_notify().
+       */
+
+      flags = enter_critical_section();
+      while (dq_empty(&eph->rdlist))
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          if (timeout == 0)
+            {
+              leave_critical_section(flags);
+              ret = 0;
+              goto out;
+            }
+          else if (timeout > 0)
+            {
+              ret = nxsem_tickwait(&eph->waitsem, start, ticks);
+            }
+          else
+            {
+              ret = nxsem_wait(&eph->waitsem);
+            }
 
-          for (i = 0; i < eph->occupied; i++)
+          if (ret < 0)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              leave_critical_section(flags);
+              if (ret == -ETIMEDOUT)
+                {
+                  ret = 0;
+                  goto out;
+                }
+
+              goto errout_with_eph;
             }
         }
 
-      return rc;
+      leave_critical_section(flags);
+
+      /* Collect the events */
+
+      epoll_semtake(&eph->exclsem);
+      ret = epoll_collect(eph, evs, maxevents);
+      epoll_semgive(&eph->exclsem);
+
+      /* All of the queued items may have been stale */
+
+      if (ret > 0)
+        {
+          break;
+        }
+    }
+
+out:
+  epoll_puthead(eph);
+  leave_cancellation_point();
+  return ret;
+
+errout_with_eph:
+  epoll_puthead(eph);
+
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_fdclose
+ *
+ * Description:
+ *   A file or socket descriptor is being closed.  Remove it from the
+ *   interest set of every epoll instance in which it is registered.  This
+ *   is called before the file or socket is actually closed so that the
+ *   polls can still be torn down.
+ *
+ * Input Parameters:
+ *   obj - The struct file or struct socket of the descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_fdclose(FAR const void *obj)
+{
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_item_s **prev;
+  FAR struct epoll_item_s **fprev;
+  FAR struct epoll_item_s *item;
+  unsigned int ndx = EPOLL_OBJHASH(obj);
+
+  /* This is called on every close.  Most descriptors were never registered
+   * so check the hash chain before taking the lock.  A registration that
+   * races with the close of the same descriptor is an application error.
+   */
+
+  if (g_epoll_objects[ndx] == NULL)
+    {
+      return;
     }
 
-  /* Iterate over non NULL event fds */
+  epoll_semtake(&g_epoll_sem);
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
+  prev = &g_epoll_objects[ndx];
+  while ((item = *prev) != NULL)
     {
-      if (eph->evs[counter].revents != 0)
+      if (epoll_object(item) != obj)
+        {
+          prev = &item->olink;
+          continue;
+        }
+
+      eph = item->eph;
+      epoll_semtake(&eph->exclsem);
+
+      fprev = &eph->hash[EPOLL_HASH(eph, item->pfd.fd)];
+      while (*fprev != item)
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          DEBUGASSERT(*fprev != NULL);
+          fprev = &(*fprev)->flink;
         }
+
+      /* This unlinks the item from *prev too */
+
+      epoll_remove(eph, fprev);
+      epoll_semgive(&eph->exclsem);
     }
 
-  return i;
+  epoll_semgive(&g_epoll_sem);
 }
-
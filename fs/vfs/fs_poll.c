@@ -151,6 +151,7 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds,
       fds[i].sem     = sem;
       fds[i].revents = 0;
       fds[i].priv    = NULL;
+      fds[i].cb      = NULL;
 
       /* Check for invalid descriptors. "If the value of fd is less than 0,
        * events shall be ignored, and revents shall be set to 0 in that entry
@@ -360,7 +361,7 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
               fds->revents |= (fds->events & (POLLIN | POLLOUT));
               if (fds->revents != 0)
                 {
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
             }
 
@@ -371,6 +372,34 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   return ret;
 }
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Notify the poll logic that events have been posted in fds->revents.
+ *   If the poll structure has a notification callback, then that callback
+ *   is called; otherwise the poll semaphore is posted.
+ *
+ * Input Parameters:
+ *   fds - The poll structure with newly posted events
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds)
+{
+  if (fds->cb != NULL)
+    {
+      fds->cb(fds);
+    }
+  else
+    {
+      poll_semgive(fds->sem);
+    }
+}
+
 /****************************************************************************
  * Name: fdesc_poll
  *
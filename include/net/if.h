@@ -59,6 +59,7 @@
 #define IFF_UP             (1 << 1) /* Interface is up */
 #define IFF_RUNNING        (1 << 2) /* Carrier is available */
 #define IFF_IPv6           (1 << 3) /* Configured for IPv6 packet (vs ARP or IPv4) */
+#define IFF_TSO            (1 << 4) /* Driver segments TCP super-segments itself */
 #define IFF_NOARP          (1 << 7) /* ARP is not required for this packet */
 
 /* Interface flag helpers */
@@ -77,6 +78,7 @@
 #define IFF_IS_UP(f)       (((f) & IFF_UP) != 0)
 #define IFF_IS_RUNNING(f)  (((f) & IFF_RUNNING) != 0)
 #define IFF_IS_NOARP(f)    (((f) & IFF_NOARP) != 0)
+#define IFF_IS_TSO(f)      (((f) & IFF_TSO) != 0)
 
 /* We only need to manage the IPv6 bit if both IPv6 and IPv4 are supported.  Otherwise,
  * we can save a few bytes by ignoring it.
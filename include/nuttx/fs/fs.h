@@ -1301,6 +1301,46 @@ int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Notify the poll logic that events have been posted in fds->revents.
+ *   Drivers call this (instead of posting fds->sem directly) after
+ *   updating revents.  If the poll structure has a notification callback,
+ *   as those set up by epoll do, then that callback is called; otherwise
+ *   the poll semaphore is posted.
+ *
+ *   This may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   fds - The poll structure with newly posted events
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: epoll_fdclose
+ *
+ * Description:
+ *   A file or socket descriptor is being closed.  Remove it from the
+ *   interest set of every epoll instance in which it is registered.  This
+ *   must be called before the file or socket is actually closed.
+ *
+ * Input Parameters:
+ *   obj - The struct file or struct socket of the descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_fdclose(FAR const void *obj);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
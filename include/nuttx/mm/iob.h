@@ -199,9 +199,15 @@ enum iob_user_e
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   IOBUSER_NET_TCP_WRITEBUFFER,
 #endif
+#ifdef CONFIG_NET_SENDFILE_IOB
+  IOBUSER_NET_TCP_SENDFILE,
+#endif
 #ifdef CONFIG_NET_IPFORWARD
   IOBUSER_NET_IPFORWARD,
 #endif
+#ifdef CONFIG_NET_ARP_QUEUE
+  IOBUSER_NET_ARP_QUEUE,
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   IOBUSER_WIRELESS_RAD802154,
 #endif
@@ -268,6 +274,19 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid);
 
 FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid);
 
+/****************************************************************************
+ * Name: iob_tryalloc_chain
+ *
+ * Description:
+ *   Try to allocate a chain of 'nbufs' I/O buffers in one operation without
+ *   waiting for buffers to become free.  Either all of the buffers are
+ *   allocated or none are.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_chain(unsigned int nbufs, bool throttled,
+                                     enum iob_user_e consumerid);
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -359,7 +378,7 @@ int iob_notifier_teardown(int key);
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  The whole chain is returned in one operation.
  *
  ****************************************************************************/
 
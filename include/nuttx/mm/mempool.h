@@ -0,0 +1,212 @@
+/****************************************************************************
+ * include/nuttx/mm/mempool.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_H
+#define __INCLUDE_NUTTX_MM_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <queue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Memory pool flags */
+
+#define MEMPOOL_FLAG_GROW  (1 << 0) /* Bit 0: Allocate from the kernel heap
+                                     *        when the pool is exhausted */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A memory pool manages a set of fixed size blocks.  A number of blocks is
+ * pre-allocated when the pool is initialized.  Some of these may be
+ * reserved for use by interrupt handlers:  An allocation from a task is
+ * satisfied from the pre-allocated blocks only while more than 'nreserve'
+ * of them are free.  If MEMPOOL_FLAG_GROW is set, then an allocation from
+ * a task that cannot be satisfied from the pre-allocated blocks is taken
+ * from the kernel heap instead.
+ *
+ * The fields of this structure are private to the memory pool logic.
+ */
+
+struct mempool_s
+{
+  FAR struct mempool_s *next;    /* Supports a list of all memory pools */
+  FAR const char *name;          /* Name shown in /proc/mempool */
+  FAR char *base;                /* Start of the pre-allocated blocks */
+  size_t blocksize;              /* Size of one block */
+  sq_queue_t freelist;           /* List of free, pre-allocated blocks */
+  uint16_t nblocks;              /* Number of pre-allocated blocks */
+  uint16_t nreserve;             /* Blocks reserved for interrupt handlers */
+  uint16_t nfree;                /* Number of free, pre-allocated blocks */
+  uint8_t flags;                 /* See MEMPOOL_FLAG_* definitions */
+
+  /* Statistics */
+
+  unsigned int nused;            /* Blocks in use (including heap blocks) */
+  unsigned int npeak;            /* Maximum value of nused */
+  unsigned long nalloc;          /* Number of successful allocations */
+  unsigned long nfail;           /* Number of failed allocations */
+};
+
+/* This is a snapshot of the state of a memory pool as returned by
+ * mempool_info().
+ */
+
+struct mempoolinfo_s
+{
+  FAR const char *name;          /* Name of the pool */
+  size_t blocksize;              /* Size of one block */
+  unsigned int nblocks;          /* Number of pre-allocated blocks */
+  unsigned int nfree;            /* Number of free, pre-allocated blocks */
+  unsigned int nused;            /* Blocks in use (including heap blocks) */
+  unsigned int npeak;            /* Maximum value of nused */
+  unsigned long nalloc;          /* Number of successful allocations */
+  unsigned long nfail;           /* Number of failed allocations */
+};
+
+/* This is the type of the callback used by mempool_foreach() */
+
+typedef CODE void (*mempool_handler_t)(FAR struct mempool_s *pool,
+                                       FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a memory pool and add it to the list of all memory pools.
+ *
+ * Input Parameters:
+ *   pool      - The memory pool to be initialized
+ *   name      - A name for the pool.  The string must persist.
+ *   base      - Memory to hold the pre-allocated blocks.  At least
+ *               nblocks * blocksize bytes, suitably aligned for the block
+ *               type.  If NULL, the memory is allocated from the kernel
+ *               heap.
+ *   blocksize - The size of one block.  Must be at least the size of a
+ *               pointer.
+ *   nblocks   - The number of pre-allocated blocks
+ *   nreserve  - The number of pre-allocated blocks reserved for interrupt
+ *               handlers
+ *   flags     - See MEMPOOL_FLAG_* definitions
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if base is NULL and the memory for the
+ *   pre-allocated blocks could not be allocated.
+ *
+ * Assumptions:
+ *   Memory pools are never uninitialized.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       FAR void *base, size_t blocksize,
+                       unsigned int nblocks, unsigned int nreserve,
+                       uint8_t flags);
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from a memory pool.  This function may be called
+ *   from an interrupt handler but will never use the kernel heap in that
+ *   case.
+ *
+ * Returned Value:
+ *   The allocated block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the memory pool that it was allocated from.  This
+ *   function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return a consistent snapshot of the state of a memory pool.
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info);
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call the handler once for each memory pool in the system.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MM_MEMPOOL_H */
@@ -47,6 +47,10 @@
 #include <string.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_MM_CPUCACHE
+#  include <nuttx/spinlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -178,6 +182,86 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Two-level segregated fit (TLSF) free list indexing.
+ *
+ * When CONFIG_MM_TLSF is selected, the free chunks are not kept in a
+ * single, size ordered list.  Instead, each free chunk is placed in one
+ * of MM_TLSF_FLCOUNT x MM_TLSF_SLCOUNT unordered lists.  The first level
+ * index is the power-of-two range of the chunk size; the second level
+ * index linearly subdivides that range into MM_TLSF_SLCOUNT parts.  Chunks
+ * smaller than MM_TLSF_SMALL all go into first level list zero and are
+ * subdivided in units of MM_MIN_CHUNK.
+ *
+ * A bitmap of non-empty lists at each level lets malloc find a suitable
+ * chunk in constant time.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  ifndef CONFIG_MM_TLSF_SLBITS
+#    define CONFIG_MM_TLSF_SLBITS 3
+#  endif
+
+#  ifdef CONFIG_MM_SMALL
+#    define MM_TLSF_SIZEBITS 16
+#  else
+#    define MM_TLSF_SIZEBITS 32
+#  endif
+
+#  define MM_TLSF_SLSHIFT  CONFIG_MM_TLSF_SLBITS
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLSHIFT)
+#  define MM_TLSF_FLSHIFT  (MM_MIN_SHIFT + MM_TLSF_SLSHIFT)
+#  define MM_TLSF_FLCOUNT  (MM_TLSF_SIZEBITS - MM_TLSF_FLSHIFT + 1)
+#  define MM_TLSF_SMALL    (1 << MM_TLSF_FLSHIFT)
+#endif
+
+/* Per-CPU chunk caches.
+ *
+ * When CONFIG_MM_CPUCACHE is selected, each CPU keeps a small stack of
+ * recently freed chunks for each of the MM_CACHE_NCLASSES smallest chunk
+ * sizes (MM_MIN_CHUNK, 2*MM_MIN_CHUNK, ...).  Cached chunks remain marked
+ * as allocated in the heap, so malloc() and free() of small chunks can be
+ * satisfied without taking the heap semaphore.  The caches are drained
+ * back into the heap when an allocation cannot otherwise be satisfied.
+ */
+
+#ifdef CONFIG_MM_CPUCACHE
+#  define MM_CACHE_NCLASSES CONFIG_MM_CPUCACHE_NCLASSES
+#  define MM_CACHE_DEPTH    CONFIG_MM_CPUCACHE_DEPTH
+#  define MM_CACHE_MAXCHUNK (MM_CACHE_NCLASSES << MM_MIN_SHIFT)
+#endif
+
+/* Heap allocation profiler.
+ *
+ * When CONFIG_MM_HEAPPROF is selected, each allocated chunk is tagged with
+ * the ID of the allocating task and the return address of the allocating
+ * call, and live/peak counters are kept for up to MM_PROF_NSITES distinct
+ * allocation sites per heap.  Allocations from further sites are counted
+ * in the catch-all site zero.
+ *
+ * The return address is captured in the malloc()/kmm_malloc() (etc.)
+ * wrappers and passed down to the mm_ interfaces as an additional, last
+ * argument.  MM_CALLER_PARM declares that argument, MM_CALLER_ARG passes
+ * it on, and MM_CALLER provides it from the wrappers.  All of these
+ * expand to nothing if the profiler is disabled.
+ */
+
+#ifdef CONFIG_MM_HEAPPROF
+#  ifndef CONFIG_MM_HEAPPROF_NSITES
+#    define CONFIG_MM_HEAPPROF_NSITES 32
+#  endif
+
+#  define MM_PROF_NSITES  CONFIG_MM_HEAPPROF_NSITES
+#  define MM_PROF_NOSITE  0xff
+
+#  define MM_CALLER_PARM  , FAR void *caller
+#  define MM_CALLER_ARG   , caller
+#  define MM_CALLER       , __builtin_return_address(0)
+#else
+#  define MM_CALLER_PARM
+#  define MM_CALLER_ARG
+#  define MM_CALLER
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -201,14 +285,28 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_HEAPPROF
+  FAR void *caller;        /* Return address of the allocating call */
+  pid_t pid;               /* ID of the allocating task */
+  uint8_t site;            /* Index of the allocation site (or NOSITE) */
+  uint8_t gen;             /* Snapshot generation of the allocation */
+#endif
 };
 
-/* What is the size of the allocnode? */
+/* What is the size of the allocnode?  SIZEOF_MM_NODEHDR is the size of
+ * the size/preceding header that is common to allocated and free chunks.
+ */
 
 #ifdef CONFIG_MM_SMALL
-# define SIZEOF_MM_ALLOCNODE   B2C(4)
+# define SIZEOF_MM_NODEHDR     B2C(4)
+#else
+# define SIZEOF_MM_NODEHDR     B2C(8)
+#endif
+
+#ifdef CONFIG_MM_HEAPPROF
+# define SIZEOF_MM_ALLOCNODE   sizeof(struct mm_allocnode_s)
 #else
-# define SIZEOF_MM_ALLOCNODE   B2C(8)
+# define SIZEOF_MM_ALLOCNODE   SIZEOF_MM_NODEHDR
 #endif
 
 #define CHECK_ALLOCNODE_SIZE \
@@ -227,11 +325,45 @@ struct mm_freenode_s
 /* What is the size of the freenode? */
 
 #define MM_PTR_SIZE sizeof(FAR struct mm_freenode_s *)
-#define SIZEOF_MM_FREENODE (SIZEOF_MM_ALLOCNODE + 2*MM_PTR_SIZE)
+#define SIZEOF_MM_FREENODE (SIZEOF_MM_NODEHDR + 2*MM_PTR_SIZE)
 
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_CPUCACHE
+/* This describes the chunk cache of one CPU.  The cached chunks of each
+ * size class are kept in a singly linked list using the flink field of
+ * struct mm_freenode_s.  The cache is only ever modified with the lock
+ * held and with local interrupts disabled.
+ */
+
+struct mm_cpucache_s
+{
+  spinlock_t mc_lock;
+  uint8_t mc_count[MM_CACHE_NCLASSES];
+  FAR struct mm_freenode_s *mc_head[MM_CACHE_NCLASSES];
+};
+#endif
+
+#ifdef CONFIG_MM_HEAPPROF
+/* This describes the allocations from one allocation site.  The byte
+ * counts are in units of chunk sizes, i.e., include the chunk headers and
+ * the alignment padding.
+ */
+
+struct mm_profsite_s
+{
+  FAR void *ps_caller;     /* Return address of the allocating call */
+  size_t ps_nlive;         /* Number of live allocations */
+  size_t ps_live;          /* Bytes in live allocations */
+  size_t ps_peak;          /* Maximum value of ps_live */
+  size_t ps_nsnap;         /* Live allocations since the last snapshot */
+  size_t ps_snap;          /* Bytes in those allocations */
+  unsigned long ps_nalloc; /* Total number of allocations */
+  pid_t ps_pid;            /* Task that made the most recent allocation */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -257,12 +389,37 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Free nodes are maintained in segregated, doubly linked lists.  The
+   * first free node in each list has a NULL blink.  Bit n of mm_flbitmap
+   * is set if any of the lists mm_freelist[n][] is non-empty; bit m of
+   * mm_slbitmap[n] is set if mm_freelist[n][m] is non-empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Small chunk caches, one per CPU */
+
+  struct mm_cpucache_s mm_cache[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_HEAPPROF
+  /* Allocation site records and the current snapshot generation */
+
+  uint8_t mm_profgen;
+  struct mm_profsite_s mm_profsite[MM_PROF_NSITES];
+#endif
 };
 
 /****************************************************************************
@@ -367,7 +524,8 @@ void kmm_givesemaphore(void);
 
 /* Functions contained in mm_malloc.c ***************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size
+                    MM_CALLER_PARM);
 
 /* Functions contained in kmm_malloc.c **************************************/
 
@@ -388,7 +546,7 @@ void kmm_free(FAR void *mem);
 /* Functions contained in mm_realloc.c **************************************/
 
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
-                     size_t size);
+                     size_t size MM_CALLER_PARM);
 
 /* Functions contained in kmm_realloc.c *************************************/
 
@@ -398,7 +556,8 @@ FAR void *kmm_realloc(FAR void *oldmem, size_t newsize);
 
 /* Functions contained in mm_calloc.c ***************************************/
 
-FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size);
+FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size
+                    MM_CALLER_PARM);
 
 /* Functions contained in kmm_calloc.c **************************************/
 
@@ -408,7 +567,8 @@ FAR void *kmm_calloc(size_t n, size_t elem_size);
 
 /* Functions contained in mm_zalloc.c ***************************************/
 
-FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size
+                    MM_CALLER_PARM);
 
 /* Functions contained in kmm_zalloc.c **************************************/
 
@@ -419,7 +579,7 @@ FAR void *kmm_zalloc(size_t size);
 /* Functions contained in mm_memalign.c *************************************/
 
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
-                      size_t size);
+                      size_t size MM_CALLER_PARM);
 
 /* Functions contained in kmm_memalign.c ************************************/
 
@@ -504,6 +664,31 @@ int kmm_mallinfo(struct mallinfo *info);
 #endif /* CONFIG_CAN_PASS_STRUCTS */
 #endif /* CONFIG_MM_KERNEL_HEAP */
 
+/* Functions contained in mm_free.c *****************************************/
+
+void mm_freechunk(FAR struct mm_heap_s *heap,
+                  FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_cpucache.c *************************************/
+
+#ifdef CONFIG_MM_CPUCACHE
+void mm_cacheinitialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cachealloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_cachefree(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_cachedrain(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_heapprof.c *************************************/
+
+#ifdef CONFIG_MM_HEAPPROF
+void mm_profalloc(FAR struct mm_heap_s *heap, FAR void *mem,
+                  FAR void *caller);
+void mm_proffree(FAR struct mm_heap_s *heap, FAR void *mem);
+int  mm_profsite(FAR struct mm_heap_s *heap, int index,
+                 FAR struct mm_profsite_s *site);
+void mm_profsnapshot(FAR struct mm_heap_s *heap);
+#endif
+
 /* Functions contained in mm_shrinkchunk.c **********************************/
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
@@ -514,9 +699,22 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c *********************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_findfreechunk.c ********************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
+#ifdef CONFIG_MM_TLSF
+void mm_size2tlsf(size_t size, FAR int *fl, FAR int *sl);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
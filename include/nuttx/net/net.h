@@ -223,6 +223,7 @@ struct sock_intf_s
   CODE int        (*si_ioctl)(FAR struct socket *psock, int cmd,
                     FAR void *arg, size_t arglen);
 #endif
+  CODE int        (*si_socketpair)(FAR struct socket *psocks[2]);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -1012,6 +1013,71 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                        int flags, FAR struct sockaddr *from,
                        FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a batch of up to 'vlen' messages from a
+ *   socket with the network locked only once.  This is an internal OS
+ *   interface.  It is functionally equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - The array of messages to receive
+ *   vlen    - The number of messages in msgvec
+ *   flags   - Receive flags
+ *   timeout - The time limit for the whole batch (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  The number of
+ *   bytes received in each message is returned in its msg_len field.  If
+ *   the very first receive fails, a negated errno value is returned (see
+ *   comments with recvfrom() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+struct mmsghdr;  /* Forward reference. See nuttx/include/sys/socket.h */
+struct timespec; /* Forward reference. See nuttx/include/time.h */
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a batch of up to 'vlen' messages on a socket
+ *   with the network locked only once.  This is an internal OS interface.
+ *   It is functionally equivalent to sendmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - The array of messages to send
+ *   vlen    - The number of messages in msgvec
+ *   flags   - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  The number of bytes
+ *   sent from each message is returned in its msg_len field.  If the very
+ *   first send fails, a negated errno value is returned (see comments with
+ *   sendto() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /* recv using the underlying socket structure */
 
 #define psock_recv(psock,buf,len,flags) \
@@ -343,6 +343,37 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_COPYCHKSUM
+  /* When the payload at d_appdata was summed as it was copied in,
+   * d_sndchklen is the length that was summed and d_sndchksum is the sum.
+   * d_sndchklen is zero if there is no such sum.
+   */
+
+  uint16_t d_sndchklen;
+  uint16_t d_sndchksum;
+#endif
+
+#ifdef CONFIG_NET_TCP_GSO
+  /* TCP generic segmentation offload.  While a connection is polled,
+   * d_gsosegs is the maximum number of segments that the TCP send logic
+   * may hand to the device at once.  If it hands over more than one, the
+   * first segment is in d_buf as usual and the rest of the payload,
+   * d_gsolen bytes at d_gsooffset in the d_gsoiob chain, is to be sent in
+   * segments of at most d_gsosize bytes with the same headers.
+   *
+   * The rest of the payload is sliced into segments by tcp_gso_output()
+   * unless the driver sets IFF_TSO in d_flags.  In that case, the driver
+   * may send all of it from the poll callback for the first segment and
+   * then set d_gsolen to zero.
+   */
+
+  FAR struct iob_s *d_gsoiob;
+  uint16_t d_gsooffset;
+  uint16_t d_gsolen;
+  uint16_t d_gsosize;
+  uint8_t  d_gsosegs;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -608,6 +639,40 @@ int devif_loopback(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_rxbatch
+ *
+ * Description:
+ *   Pass a batch of received frames to the network.  The network is locked
+ *   once for the whole batch and rxfunc() is called repeatedly to receive
+ *   and dispatch one frame at a time until either there are no more frames
+ *   or the budget is exhausted.
+ *
+ *   rxfunc() should copy the next frame into d_buf, dispatch it as the
+ *   driver would for a single frame (including sending any reply), and
+ *   return zero.  A frame that is dropped still counts against the budget.
+ *   rxfunc() should return -EAGAIN when there are no further frames.
+ *
+ *   The driver should keep its receive interrupt disabled while the batch
+ *   is processed.  If all of the budget was used, then more frames are
+ *   probably waiting and the driver should schedule another batch rather
+ *   than re-enabling the interrupt.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure
+ *   rxfunc - Driver function that receives and dispatches one frame
+ *   budget - The maximum number of frames to process
+ *
+ * Returned Value:
+ *   The number of frames processed.
+ *
+ ****************************************************************************/
+
+typedef CODE int (*netdev_rxfunc_t)(FAR struct net_driver_s *dev);
+
+int netdev_rxbatch(FAR struct net_driver_s *dev, netdev_rxfunc_t rxfunc,
+                   int budget);
+
 /****************************************************************************
  * Name: net_ioctl_arglen
  *
@@ -76,8 +76,13 @@
 #define TCP_OPT_END       0   /* End of TCP options list */
 #define TCP_OPT_NOOP      1   /* "No-operation" TCP option */
 #define TCP_OPT_MSS       2   /* Maximum segment size TCP option */
+#define TCP_OPT_WS        3   /* Window scale TCP option */
+#define TCP_OPT_SACK_PERM 4   /* SACK permitted TCP option */
+#define TCP_OPT_SACK      5   /* SACK TCP option */
 
 #define TCP_OPT_MSS_LEN   4   /* Length of TCP MSS option. */
+#define TCP_OPT_WS_LEN    3   /* Length of TCP window scale option. */
+#define TCP_OPT_SACK_PERM_LEN 2 /* Length of TCP SACK permitted option. */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
@@ -191,6 +196,12 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                              available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  net_stats_t rcviobs;    /* Number of IOBs held for read-ahead data */
+  net_stats_t sndiobs;    /* Number of IOBs held in write buffers */
+  net_stats_t iobdrop;    /* Number of segments dropped for the IOB budget */
+  net_stats_t iobwait;    /* Number of sends delayed for the IOB budget */
+#endif
 };
 #endif
 
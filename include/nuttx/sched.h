@@ -823,6 +823,14 @@ EXTERN uint32_t g_crit_max[1];
 #endif
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
+#ifdef CONFIG_SCHED_CPUBALANCE
+/* The number of times that a task started running on each CPU after last
+ * running on a different CPU.
+ */
+
+EXTERN volatile uint32_t g_cpu_migrations[CONFIG_SMP_NCPUS];
+#endif
+
 /********************************************************************************
  * Public Function Prototypes
  ********************************************************************************/
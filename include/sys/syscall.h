@@ -549,16 +549,20 @@
 #  define SYS_sendto                   (__SYS_network + 10)
 #  define SYS_setsockopt               (__SYS_network + 11)
 #  define SYS_socket                   (__SYS_network + 12)
+#  define SYS_socketpair               (__SYS_network + 13)
+#  define SYS_recvmmsg                 (__SYS_network + 14)
+#  define SYS_sendmmsg                 (__SYS_network + 15)
 #else
 #  define SYS_socket                    __SYS_network
+#  define SYS_sendmmsg                  SYS_socket
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
 #if CONFIG_TASK_NAME_SIZE > 0
-#  define SYS_prctl                    (SYS_socket + 1)
+#  define SYS_prctl                    (SYS_sendmmsg + 1)
 #else
-#  define SYS_prctl                    SYS_socket
+#  define SYS_prctl                    SYS_sendmmsg
 #endif
 
 /* The following is defined only if entropy pool random number generator
@@ -42,9 +42,12 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <debug.h>
 
+#include <nuttx/spinlock.h>
 #include <nuttx/mm/iob.h>
 
 #ifdef CONFIG_MM_IOB
@@ -83,6 +86,52 @@
 #endif
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* IOB notifications are sent only when the number of available IOBs is a
+ * multiple of IOB_DIVIDER.
+ */
+
+#ifdef CONFIG_IOB_NOTIFIER
+#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
+#    define IOB_DIVIDER 1
+#  elif CONFIG_IOB_NOTIFIER_DIV < 4
+#    define IOB_DIVIDER 2
+#  elif CONFIG_IOB_NOTIFIER_DIV < 8
+#    define IOB_DIVIDER 4
+#  elif CONFIG_IOB_NOTIFIER_DIV < 16
+#    define IOB_DIVIDER 8
+#  elif CONFIG_IOB_NOTIFIER_DIV < 32
+#    define IOB_DIVIDER 16
+#  elif CONFIG_IOB_NOTIFIER_DIV < 64
+#    define IOB_DIVIDER 32
+#  else
+#    define IOB_DIVIDER 64
+#  endif
+
+#  define IOB_MASK    (IOB_DIVIDER - 1)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CPUCACHE
+/* The cache of free I/O buffers and I/O buffer chain containers of one
+ * CPU.  Cached entries are not counted by the counting semaphores.  The
+ * spinlock is only contended when the caches are drained.
+ */
+
+struct iob_cpucache_s
+{
+  spinlock_t ic_lock;                  /* Protects the cache */
+  uint8_t ic_niob;                     /* Number of cached IOBs */
+  FAR struct iob_s *ic_iob;            /* List of cached IOBs */
+#if CONFIG_IOB_NCHAINS > 0
+  uint8_t ic_nqentry;                  /* Number of cached containers */
+  FAR struct iob_qentry_s *ic_qentry;  /* List of cached containers */
+#endif
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,10 +164,52 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_CPUCACHE
+/* The per-CPU caches */
+
+extern struct iob_cpucache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* The number of threads that are waiting (or about to wait) for a free
+ * IOB/qentry.  While non-zero, freed entries bypass the caches.  These
+ * are modified only within a critical section.
+ */
+
+extern volatile int16_t g_iob_nwaiters;
+#if CONFIG_IOB_NCHAINS > 0
+extern volatile int16_t g_qentry_nwaiters;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one I/O buffer to the free list or, if a thread is waiting for
+ *   an I/O buffer, to the committed list and wake up the waiter.  The
+ *   caller must be in a critical section.  No statistics are updated.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_notify
+ *
+ * Description:
+ *   'nfreed' IOBs have just been freed.  Signal any threads that have
+ *   requested a notification if the number of available IOBs crossed a
+ *   multiple of the notification divider.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_NOTIFIER
+void iob_notify(int nfreed);
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_qentry
  *
@@ -154,6 +245,97 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_release_qentry
+ *
+ * Description:
+ *   Return one I/O buffer chain container to the free list or to the
+ *   committed list.  The caller must be in a critical section.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+void iob_release_qentry(FAR struct iob_qentry_s *iobq);
+#endif
+
+#ifdef CONFIG_IOB_CPUCACHE
+/****************************************************************************
+ * Name: iob_cacheinitialize
+ *
+ * Description:
+ *   Initialize the per-CPU caches.  All caches are initially empty.
+ *
+ ****************************************************************************/
+
+void iob_cacheinitialize(void);
+
+/****************************************************************************
+ * Name: iob_cachealloc
+ *
+ * Description:
+ *   Try to take an I/O buffer from the cache of the current CPU without
+ *   entering the critical section.  The I/O buffer is not initialized.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cachealloc(bool throttled,
+                                 enum iob_user_e consumerid);
+
+/****************************************************************************
+ * Name: iob_cachefree
+ *
+ * Description:
+ *   Put as much of the I/O buffer chain as will fit into the cache of the
+ *   current CPU without entering the critical section.
+ *
+ * Returned Value:
+ *   The remainder of the chain that must be returned to the free list or
+ *   NULL if the entire chain was cached.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cachefree(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cachedrain
+ *
+ * Description:
+ *   Return the I/O buffers in the caches of all CPUs to the free list.
+ *
+ * Returned Value:
+ *   The number of I/O buffers returned.
+ *
+ ****************************************************************************/
+
+int iob_cachedrain(void);
+
+/****************************************************************************
+ * Name: iob_ncached
+ *
+ * Description:
+ *   Return the number of I/O buffers in the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_ncached(void);
+
+#if CONFIG_IOB_NCHAINS > 0
+/****************************************************************************
+ * Name: iob_qcachealloc, iob_qcachefree, iob_qcachedrain, iob_nqcached
+ *
+ * Description:
+ *   The same as above, but for I/O buffer chain containers.
+ *   iob_qcachefree() returns false if the container could not be cached.
+ *
+ ****************************************************************************/
+
+FAR struct iob_qentry_s *iob_qcachealloc(void);
+bool iob_qcachefree(FAR struct iob_qentry_s *iobq);
+int iob_qcachedrain(void);
+int iob_nqcached(void);
+#endif
+#endif /* CONFIG_IOB_CPUCACHE */
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -46,6 +46,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -54,6 +55,74 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_takefree
+ *
+ * Description:
+ *   Take the I/O buffer at the head of the free list if the semaphore
+ *   count permits.  The caller must be in a critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_takefree(bool throttled,
+                                      enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob;
+#if CONFIG_IOB_THROTTLE > 0
+  FAR sem_t *sem;
+
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+
+  /* If there are free I/O buffers for this allocation */
+
+  if (sem->semcount <= 0)
+    {
+      return NULL;
+    }
+#endif
+
+  /* Take the I/O buffer from the head of the free list */
+
+  iob = g_iob_freelist;
+  if (iob != NULL)
+    {
+      /* Remove the I/O buffer from the free list and decrement the
+       * counting semaphore(s) that tracks the number of available
+       * IOBs.
+       */
+
+      g_iob_freelist = iob->io_flink;
+
+      /* Take a semaphore count.  Note that we cannot do this in
+       * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+       * because this function may be called from an interrupt
+       * handler. Fortunately we know at at least one free buffer
+       * so a simple decrement is all that is needed.
+       */
+
+      g_iob_sem.semcount--;
+      DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+      /* The throttle semaphore is a little more complicated because
+       * it can be negative!  Decrementing is still safe, however.
+       */
+
+      g_throttle_sem.semcount--;
+      DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onalloc(consumerid);
+#endif
+    }
+
+  return iob;
+}
+
 /****************************************************************************
  * Name: iob_alloc_committed
  *
@@ -133,6 +202,17 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_IOB_CPUCACHE
+  /* Announce that we may wait before looking at the caches.  From now on,
+   * freed I/O buffers will bypass the caches and any buffer that was
+   * cached before iob_cachefree() saw this will be drained by
+   * iob_tryalloc() below or by iob_cachefree() itself.
+   */
+
+  g_iob_nwaiters++;
+  SP_DMB();
+#endif
+
   /* Try to get an I/O buffer.  If successful, the semaphore count will be
    * decremented atomically.
    */
@@ -205,6 +285,10 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
         }
     }
 
+#ifdef CONFIG_IOB_CPUCACHE
+  g_iob_nwaiters--;
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -252,76 +336,48 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
 {
   FAR struct iob_s *iob;
   irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
-  FAR sem_t *sem;
-#endif
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the semaphore count to check. */
-
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
-#endif
 
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
+#ifdef CONFIG_IOB_CPUCACHE
+  /* First try the cache of this CPU.  That does not require the critical
+   * section.
    */
 
-  flags = enter_critical_section();
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
-
-  if (sem->semcount > 0)
+  iob = iob_cachealloc(throttled, consumerid);
+  if (iob == NULL)
 #endif
     {
-      /* Take the I/O buffer from the head of the free list */
-
-      iob = g_iob_freelist;
-      if (iob != NULL)
-        {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
-
-          g_iob_freelist = iob->io_flink;
-
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
+      /* We don't know what context we are called from so we use extreme
+       * measures to protect the free list:  We disable interrupts very
+       * briefly.
+       */
 
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+      flags = enter_critical_section();
+      iob   = iob_takefree(throttled, consumerid);
 
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is a little more complicated because
-           * it can be negative!  Decrementing is still safe, however.
-           */
-
-          g_throttle_sem.semcount--;
-          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
-#endif
+#ifdef CONFIG_IOB_CPUCACHE
+      /* The free I/O buffers may all be sitting in the caches of other
+       * CPUs.  Return them to the free list and try again.
+       */
 
-#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
-    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
-          iob_stats_onalloc(consumerid);
+      if (iob == NULL && iob_cachedrain() > 0)
+        {
+          iob = iob_takefree(throttled, consumerid);
+        }
 #endif
 
-          leave_critical_section(flags);
+      leave_critical_section(flags);
 
-          /* Put the I/O buffer in a known state */
-
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
+      if (iob == NULL)
+        {
+          return NULL;
         }
     }
 
-  leave_critical_section(flags);
-  return NULL;
+  /* Put the I/O buffer in a known state */
+
+  iob->io_flink  = NULL; /* Not in a chain */
+  iob->io_len    = 0;    /* Length of the data in the entry */
+  iob->io_offset = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen = 0;    /* Total length of the packet */
+  return iob;
 }
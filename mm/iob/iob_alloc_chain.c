@@ -0,0 +1,157 @@
+/****************************************************************************
+ * mm/iob/iob_alloc_chain.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <semaphore.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_tryalloc_chain
+ *
+ * Description:
+ *   Try to allocate a chain of 'nbufs' I/O buffers in one operation without
+ *   waiting for buffers to become free.  Either all of the buffers are
+ *   allocated or none are.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_chain(unsigned int nbufs, bool throttled,
+                                     enum iob_user_e consumerid)
+{
+  FAR struct iob_s *head;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  FAR sem_t *sem;
+  unsigned int i;
+
+  if (nbufs == 0)
+    {
+      return NULL;
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#else
+  sem = &g_iob_sem;
+#endif
+
+  /* We don't know what context we are called from so we use extreme
+   * measures to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_IOB_CPUCACHE
+  /* Some of the free I/O buffers may be sitting in the per-CPU caches */
+
+  if (sem->semcount < (int)nbufs)
+    {
+      iob_cachedrain();
+    }
+#endif
+
+  /* Are there enough free I/O buffers for this allocation? */
+
+  if (sem->semcount < (int)nbufs)
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
+  /* Yes.. Detach the first 'nbufs' I/O buffers from the free list.  They
+   * are already linked together.
+   */
+
+  head = g_iob_freelist;
+  iob  = head;
+
+  for (i = 1; i < nbufs; i++)
+    {
+      DEBUGASSERT(iob != NULL);
+      iob = iob->io_flink;
+    }
+
+  g_iob_freelist = iob->io_flink;
+  iob->io_flink  = NULL;
+
+  /* Take the semaphore counts.  See iob_tryalloc() */
+
+  g_iob_sem.semcount -= nbufs;
+  DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+  g_throttle_sem.semcount -= nbufs;
+  DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  for (i = 0; i < nbufs; i++)
+    {
+      iob_stats_onalloc(consumerid);
+    }
+#endif
+
+  leave_critical_section(flags);
+
+  /* Put the I/O buffers in a known state */
+
+  for (iob = head; iob != NULL; iob = iob->io_flink)
+    {
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return head;
+}
@@ -45,6 +45,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -117,6 +118,15 @@ static FAR struct iob_qentry_s *iob_allocwait_qentry(void)
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_IOB_CPUCACHE
+  /* Announce that we may wait before looking at the caches (see
+   * iob_allocwait()).
+   */
+
+  g_qentry_nwaiters++;
+  SP_DMB();
+#endif
+
   /* Try to get an I/O buffer chain container.  If successful, the semaphore
    * count will bedecremented atomically.
    */
@@ -178,6 +188,10 @@ static FAR struct iob_qentry_s *iob_allocwait_qentry(void)
         }
     }
 
+#ifdef CONFIG_IOB_CPUCACHE
+  g_qentry_nwaiters--;
+#endif
+
   leave_critical_section(flags);
   return qentry;
 }
@@ -229,12 +243,33 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
   FAR struct iob_qentry_s *iobq;
   irqstate_t flags;
 
+#ifdef CONFIG_IOB_CPUCACHE
+  /* First try the cache of this CPU */
+
+  iobq = iob_qcachealloc();
+  if (iobq != NULL)
+    {
+      iobq->qe_head = NULL; /* Nothing is contained */
+      return iobq;
+    }
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
 
   flags = enter_critical_section();
   iobq  = g_iob_freeqlist;
+
+#ifdef CONFIG_IOB_CPUCACHE
+  /* The free containers may all be sitting in the caches of other CPUs */
+
+  if (iobq == NULL && iob_qcachedrain() > 0)
+    {
+      iobq = g_iob_freeqlist;
+    }
+#endif
+
   if (iobq)
     {
       /* Remove the I/O buffer chain container from the free list and
@@ -0,0 +1,443 @@
+/****************************************************************************
+ * mm/iob/iob_cpucache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <semaphore.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_CPUCACHE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The per-CPU caches */
+
+struct iob_cpucache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* The number of threads that are waiting (or about to wait) for a free
+ * IOB/qentry.
+ */
+
+volatile int16_t g_iob_nwaiters;
+#if CONFIG_IOB_NCHAINS > 0
+volatile int16_t g_qentry_nwaiters;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cacheinitialize
+ *
+ * Description:
+ *   Initialize the per-CPU caches.  All caches are initially empty.
+ *
+ ****************************************************************************/
+
+void iob_cacheinitialize(void)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      spin_initialize(&g_iob_cache[cpu].ic_lock, SP_UNLOCKED);
+      g_iob_cache[cpu].ic_niob    = 0;
+      g_iob_cache[cpu].ic_iob     = NULL;
+#if CONFIG_IOB_NCHAINS > 0
+      g_iob_cache[cpu].ic_nqentry = 0;
+      g_iob_cache[cpu].ic_qentry  = NULL;
+#endif
+    }
+
+  g_iob_nwaiters    = 0;
+#if CONFIG_IOB_NCHAINS > 0
+  g_qentry_nwaiters = 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_cachealloc
+ *
+ * Description:
+ *   Try to take an I/O buffer from the cache of the current CPU without
+ *   entering the critical section.  The I/O buffer is not initialized.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cachealloc(bool throttled,
+                                 enum iob_user_e consumerid)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Cached IOBs are not counted by the semaphores so taking one never
+   * eats into the reserve of the throttle.  But a throttled allocation
+   * must still fail when the reserve is all that is left in the free list,
+   * otherwise throttled users could hold on to every cached IOB.
+   */
+
+  if (throttled && g_throttle_sem.semcount <= 0)
+    {
+      return NULL;
+    }
+#endif
+
+  /* Disable local interrupts so that we cannot migrate to another CPU */
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  iob = cache->ic_iob;
+  if (iob != NULL)
+    {
+      cache->ic_iob = iob->io_flink;
+      cache->ic_niob--;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  if (iob != NULL)
+    {
+      iob_stats_onalloc(consumerid);
+    }
+#endif
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cachefree
+ *
+ * Description:
+ *   Put as much of the I/O buffer chain as will fit into the cache of the
+ *   current CPU without entering the critical section.
+ *
+ * Returned Value:
+ *   The remainder of the chain that must be returned to the free list or
+ *   NULL if the entire chain was cached.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cachefree(FAR struct iob_s *iob)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+
+  /* If some thread is waiting for an IOB, then the IOB must go to the
+   * committed list.
+   */
+
+  if (g_iob_nwaiters > 0)
+    {
+      return iob;
+    }
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  while (iob != NULL && cache->ic_niob < CONFIG_IOB_CPUCACHE_DEPTH)
+    {
+      next          = iob->io_flink;
+      iob->io_flink = cache->ic_iob;
+      cache->ic_iob = iob;
+      cache->ic_niob++;
+      iob           = next;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+  /* A thread may have started to wait after the check above.  It drains
+   * the caches after announcing itself and before blocking, but it may
+   * have done so before we added our IOBs.  In that case, nothing else
+   * would wake it up so the IOBs must be released here.
+   */
+
+  SP_DMB();
+  if (g_iob_nwaiters > 0)
+    {
+      flags = enter_critical_section();
+      iob_cachedrain();
+      leave_critical_section(flags);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cachedrain
+ *
+ * Description:
+ *   Return the I/O buffers in the caches of all CPUs to the free list.
+ *
+ * Returned Value:
+ *   The number of I/O buffers returned.
+ *
+ ****************************************************************************/
+
+int iob_cachedrain(void)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_s *head;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int ndrained = 0;
+  int cpu;
+
+  flags = enter_critical_section();
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* Detach all of the cached IOBs of this CPU */
+
+      cache = &g_iob_cache[cpu];
+      spin_lock(&cache->ic_lock);
+
+      head           = cache->ic_iob;
+      ndrained      += cache->ic_niob;
+      cache->ic_iob  = NULL;
+      cache->ic_niob = 0;
+
+      spin_unlock(&cache->ic_lock);
+
+      /* Then return them to the free list */
+
+      while ((iob = head) != NULL)
+        {
+          head = iob->io_flink;
+          iob_release(iob);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ndrained;
+}
+
+/****************************************************************************
+ * Name: iob_ncached
+ *
+ * Description:
+ *   Return the number of I/O buffers in the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_ncached(void)
+{
+  int ncached = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ncached += g_iob_cache[cpu].ic_niob;
+    }
+
+  return ncached;
+}
+
+#if CONFIG_IOB_NCHAINS > 0
+/****************************************************************************
+ * Name: iob_qcachealloc
+ *
+ * Description:
+ *   Try to take an I/O buffer chain container from the cache of the
+ *   current CPU without entering the critical section.
+ *
+ ****************************************************************************/
+
+FAR struct iob_qentry_s *iob_qcachealloc(void)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_qentry_s *iobq;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  iobq = cache->ic_qentry;
+  if (iobq != NULL)
+    {
+      cache->ic_qentry = iobq->qe_flink;
+      cache->ic_nqentry--;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+  return iobq;
+}
+
+/****************************************************************************
+ * Name: iob_qcachefree
+ *
+ * Description:
+ *   Try to put an I/O buffer chain container into the cache of the
+ *   current CPU without entering the critical section.
+ *
+ * Returned Value:
+ *   True if the container was cached; false if it must be returned to the
+ *   free list.
+ *
+ ****************************************************************************/
+
+bool iob_qcachefree(FAR struct iob_qentry_s *iobq)
+{
+  FAR struct iob_cpucache_s *cache;
+  irqstate_t flags;
+  bool cached = false;
+
+  if (g_qentry_nwaiters > 0)
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  if (cache->ic_nqentry < CONFIG_IOB_CPUCACHE_QDEPTH)
+    {
+      iobq->qe_flink   = cache->ic_qentry;
+      cache->ic_qentry = iobq;
+      cache->ic_nqentry++;
+      cached           = true;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+  /* See iob_cachefree() */
+
+  SP_DMB();
+  if (cached && g_qentry_nwaiters > 0)
+    {
+      flags = enter_critical_section();
+      iob_qcachedrain();
+      leave_critical_section(flags);
+    }
+
+  return cached;
+}
+
+/****************************************************************************
+ * Name: iob_qcachedrain
+ *
+ * Description:
+ *   Return the I/O buffer chain containers in the caches of all CPUs to
+ *   the free list.
+ *
+ * Returned Value:
+ *   The number of containers returned.
+ *
+ ****************************************************************************/
+
+int iob_qcachedrain(void)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_qentry_s *head;
+  FAR struct iob_qentry_s *iobq;
+  irqstate_t flags;
+  int ndrained = 0;
+  int cpu;
+
+  flags = enter_critical_section();
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+      spin_lock(&cache->ic_lock);
+
+      head              = cache->ic_qentry;
+      ndrained         += cache->ic_nqentry;
+      cache->ic_qentry  = NULL;
+      cache->ic_nqentry = 0;
+
+      spin_unlock(&cache->ic_lock);
+
+      while ((iobq = head) != NULL)
+        {
+          head = iobq->qe_flink;
+          iob_release_qentry(iobq);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ndrained;
+}
+
+/****************************************************************************
+ * Name: iob_nqcached
+ *
+ * Description:
+ *   Return the number of I/O buffer chain containers in the caches of all
+ *   CPUs.
+ *
+ ****************************************************************************/
+
+int iob_nqcached(void)
+{
+  int ncached = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ncached += g_iob_cache[cpu].ic_nqentry;
+    }
+
+  return ncached;
+}
+#endif /* CONFIG_IOB_NCHAINS > 0 */
+
+#endif /* CONFIG_IOB_CPUCACHE */
@@ -51,33 +51,80 @@
 #include "iob.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Public Functions
  ****************************************************************************/
 
-#ifdef CONFIG_IOB_NOTIFIER
-#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
-#    define IOB_DIVIDER 1
-#  elif CONFIG_IOB_NOTIFIER_DIV < 4
-#    define IOB_DIVIDER 2
-#  elif CONFIG_IOB_NOTIFIER_DIV < 8
-#    define IOB_DIVIDER 4
-#  elif CONFIG_IOB_NOTIFIER_DIV < 16
-#    define IOB_DIVIDER 8
-#  elif CONFIG_IOB_NOTIFIER_DIV < 32
-#    define IOB_DIVIDER 16
-#  elif CONFIG_IOB_NOTIFIER_DIV < 64
-#    define IOB_DIVIDER 32
-#  else
-#    define IOB_DIVIDER 64
-#  endif
-#endif
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one I/O buffer to the free list or, if a thread is waiting for
+ *   an I/O buffer, to the committed list and wake up the waiter.  The
+ *   caller must be in a critical section.  No statistics are updated.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob)
+{
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on either the free list or on the committed list where
+   * it is reserved for that allocation (and not available to
+   * iob_tryalloc()).
+   */
+
+  if (g_iob_sem.semcount < 0)
+    {
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+    }
+  else
+    {
+      iob->io_flink   = g_iob_freelist;
+      g_iob_freelist  = iob;
+    }
+
+  /* Signal that an IOB is available.  If there is a thread blocked,
+   * waiting for an IOB, this will wake up exactly one thread.  The
+   * semaphore count will correctly indicated that the awakened task
+   * owns an IOB and should find it in the committed list.
+   */
+
+  nxsem_post(&g_iob_sem);
+  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
 
-#define IOB_MASK      (IOB_DIVIDER - 1)
+#if CONFIG_IOB_THROTTLE > 0
+  nxsem_post(&g_throttle_sem);
+  DEBUGASSERT(g_throttle_sem.semcount <= (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+}
 
 /****************************************************************************
- * Public Functions
+ * Name: iob_notify
+ *
+ * Description:
+ *   'nfreed' IOBs have just been freed.  Signal any threads that have
+ *   requested a notification if the number of available IOBs crossed a
+ *   multiple of the notification divider.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_IOB_NOTIFIER
+void iob_notify(int nfreed)
+{
+  int navail;
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & ~IOB_MASK) > navail - nfreed)
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -92,9 +139,6 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob,
 {
   FAR struct iob_s *next = iob->io_flink;
   irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -129,64 +173,46 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob,
               next, next->io_pktlen, next->io_len);
     }
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = enter_critical_section();
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()).
+#ifdef CONFIG_IOB_CPUCACHE
+  /* Try to keep the I/O buffer in the cache of this CPU.  That does not
+   * require the critical section.
    */
 
-  if (g_iob_sem.semcount < 0)
-    {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-    }
-  else
+  iob->io_flink = NULL;
+  if (iob_cachefree(iob) == NULL)
     {
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onfree(producerid);
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+      iob_notify(1);
+#endif
+      return next;
     }
+#endif
 
-  /* Signal that an IOB is available.  If there is a thread blocked,
-   * waiting for an IOB, this will wake up exactly one thread.  The
-   * semaphore count will correctly indicated that the awakened task
-   * owns an IOB and should find it in the committed list.
+  /* Free the I/O buffer by adding it to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
    */
 
-  nxsem_post(&g_iob_sem);
-  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+  flags = enter_critical_section();
+  iob_release(iob);
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   iob_stats_onfree(producerid);
 #endif
 
-#if CONFIG_IOB_THROTTLE > 0
-  nxsem_post(&g_throttle_sem);
-  DEBUGASSERT(g_throttle_sem.semcount <= (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
-#endif
-
 #ifdef CONFIG_IOB_NOTIFIER
   /* Check if the IOB was claimed by a thread that is blocked waiting
    * for an IOB.
    */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
-    {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
-
-      iob_notifier_signal();
-    }
+  iob_notify(1);
 #endif
 
   leave_critical_section(flags);
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/mm/iob.h>
 
@@ -53,18 +54,63 @@
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  The whole chain is returned in one operation.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob, enum iob_user_e producerid)
 {
   FAR struct iob_s *next;
+  irqstate_t flags;
+  int nfreed = 0;
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
+#ifdef CONFIG_IOB_CPUCACHE
+  /* Account for each IOB in the chain.  The statistics have their own
+   * lock in this configuration.
+   */
 
-  for (; iob; iob = next)
+  for (next = iob; next != NULL; next = next->io_flink)
     {
-      next = iob_free(iob, producerid);
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onfree(producerid);
+#endif
+      nfreed++;
     }
+
+  /* Keep as much of the chain as will fit in the cache of this CPU */
+
+  iob = iob_cachefree(iob);
+#endif
+
+  /* Then return the rest of the chain to the free list in one critical
+   * section, rather than one IOB at a time.  The semaphore counts are
+   * still incremented once per IOB to keep them straight.
+   */
+
+  if (iob != NULL)
+    {
+      flags = enter_critical_section();
+      for (; iob != NULL; iob = next)
+        {
+          next = iob->io_flink;
+          iob_release(iob);
+
+#ifndef CONFIG_IOB_CPUCACHE
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+          iob_stats_onfree(producerid);
+#endif
+          nfreed++;
+#endif
+        }
+
+      leave_critical_section(flags);
+    }
+
+#ifdef CONFIG_IOB_NOTIFIER
+  iob_notify(nfreed);
+#else
+  UNUSED(nfreed);
+#endif
 }
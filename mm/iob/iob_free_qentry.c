@@ -55,27 +55,16 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_free_qentry
+ * Name: iob_release_qentry
  *
  * Description:
- *   Free the I/O buffer chain container by returning it to the free list.
- *   The link to  the next I/O buffer in the chain is return.
+ *   Return one I/O buffer chain container to the free list or to the
+ *   committed list.  The caller must be in a critical section.
  *
  ****************************************************************************/
 
-FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq)
+void iob_release_qentry(FAR struct iob_qentry_s *iobq)
 {
-  FAR struct iob_qentry_s *nextq = iobq->qe_flink;
-  irqstate_t flags;
-
-  /* Free the I/O buffer chain container by adding it to the head of the
-   * free or the committed list. We don't know what context we are called
-   * from so we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = enter_critical_section();
-
   /* Which list?  If there is a task waiting for an IOB chain, then put
    * the IOB chain on either the free list or on the committed list where
    * it is reserved for that allocation (and not available to
@@ -101,6 +90,39 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq)
    */
 
   nxsem_post(&g_qentry_sem);
+}
+
+/****************************************************************************
+ * Name: iob_free_qentry
+ *
+ * Description:
+ *   Free the I/O buffer chain container by returning it to the free list.
+ *   The link to  the next I/O buffer in the chain is return.
+ *
+ ****************************************************************************/
+
+FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq)
+{
+  FAR struct iob_qentry_s *nextq = iobq->qe_flink;
+  irqstate_t flags;
+
+#ifdef CONFIG_IOB_CPUCACHE
+  /* Try to keep the container in the cache of this CPU */
+
+  if (iob_qcachefree(iobq))
+    {
+      return nextq;
+    }
+#endif
+
+  /* Free the I/O buffer chain container by adding it to the head of the
+   * free or the committed list. We don't know what context we are called
+   * from so we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+  iob_release_qentry(iobq);
   leave_critical_section(flags);
 
   /* And return the I/O buffer chain container after the one that was freed */
@@ -155,6 +155,10 @@ void iob_initialize(void)
       nxsem_init(&g_qentry_sem, 0, CONFIG_IOB_NCHAINS);
 #endif
 
+#ifdef CONFIG_IOB_CPUCACHE
+      iob_cacheinitialize();
+#endif
+
       initialized = true;
     }
 }
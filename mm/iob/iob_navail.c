@@ -71,6 +71,14 @@ int iob_navail(bool throttled)
     {
       ret = navail;
 
+#ifdef CONFIG_IOB_CPUCACHE
+      /* IOBs held in the per-CPU caches are free but not counted by the
+       * semaphore.
+       */
+
+      ret += iob_ncached();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
       /* Subtract the throttle value is so requested */
 
@@ -112,6 +120,10 @@ int iob_qentry_navail(void)
   if (ret >= 0)
     {
       ret = navail;
+
+#ifdef CONFIG_IOB_CPUCACHE
+      ret += iob_nqcached();
+#endif
       if (ret < 0)
         {
           ret = 0;
@@ -44,6 +44,8 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/mm/iob.h>
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
@@ -55,6 +57,14 @@
 
 struct iob_userstats_s g_iobuserstats[IOBUSER_NENTRIES];
 
+#ifdef CONFIG_IOB_CPUCACHE
+/* IOBs moving through the per-CPU caches are counted outside of the
+ * critical section so the counters need their own lock.
+ */
+
+static volatile spinlock_t g_iobstats_lock SP_SECTION = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -76,12 +86,27 @@ struct iob_userstats_s g_iobuserstats[IOBUSER_NENTRIES];
 
 void iob_stats_onalloc(enum iob_user_e consumerid)
 {
+#ifdef CONFIG_IOB_CPUCACHE
+  irqstate_t flags;
+#endif
+
   DEBUGASSERT(consumerid < IOBUSER_NENTRIES);
+
+#ifdef CONFIG_IOB_CPUCACHE
+  flags = up_irq_save();
+  spin_lock(&g_iobstats_lock);
+#endif
+
   g_iobuserstats[consumerid].totalconsumed++;
 
   /* Increment the global statistic as well */
 
   g_iobuserstats[IOBUSER_GLOBAL].totalconsumed++;
+
+#ifdef CONFIG_IOB_CPUCACHE
+  spin_unlock(&g_iobstats_lock);
+  up_irq_restore(flags);
+#endif
 }
 
 /****************************************************************************
@@ -101,13 +126,27 @@ void iob_stats_onalloc(enum iob_user_e consumerid)
 
 void iob_stats_onfree(enum iob_user_e producerid)
 {
+#ifdef CONFIG_IOB_CPUCACHE
+  irqstate_t flags;
+#endif
+
   DEBUGASSERT(producerid < IOBUSER_NENTRIES);
+
+#ifdef CONFIG_IOB_CPUCACHE
+  flags = up_irq_save();
+  spin_lock(&g_iobstats_lock);
+#endif
+
   g_iobuserstats[producerid].totalproduced++;
 
   /* Increment the global statistic as well */
 
   g_iobuserstats[IOBUSER_GLOBAL].totalproduced++;
 
+#ifdef CONFIG_IOB_CPUCACHE
+  spin_unlock(&g_iobstats_lock);
+  up_irq_restore(flags);
+#endif
 }
 
 /****************************************************************************
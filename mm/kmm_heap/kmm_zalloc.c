@@ -63,7 +63,7 @@
 
 FAR void *kmm_zalloc(size_t size)
 {
-  return mm_zalloc(&g_kmmheap, size);
+  return mm_zalloc(&g_kmmheap, size MM_CALLER);
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
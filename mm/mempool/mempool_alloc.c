@@ -0,0 +1,133 @@
+/****************************************************************************
+ * mm/mempool/mempool_alloc.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from a memory pool.  This function may be called
+ *   from an interrupt handler but will never use the kernel heap in that
+ *   case.
+ *
+ * Returned Value:
+ *   The allocated block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  FAR void *blk = NULL;
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL);
+
+  /* These actions must be atomic with respect to other tasks and also with
+   * respect to interrupt handlers that may be allocating or freeing blocks.
+   */
+
+  flags = enter_critical_section();
+
+  /* If we are in an interrupt handler -OR- if the number of free,
+   * pre-allocated blocks exceeds the reserve, then take the next block from
+   * the head of the free list.
+   */
+
+  if (pool->nfree > pool->nreserve || up_interrupt_context())
+    {
+      blk = sq_remfirst(&pool->freelist);
+      if (blk != NULL)
+        {
+          DEBUGASSERT(pool->nfree > 0);
+          pool->nfree--;
+        }
+      else
+        {
+          /* We didn't get one... The count should then be exactly zero */
+
+          DEBUGASSERT(pool->nfree == 0);
+        }
+    }
+
+  /* We are in a normal tasking context AND there are not enough unreserved,
+   * pre-allocated blocks.  Allocate one from the kernel heap if the pool
+   * may grow.  We do not require that interrupts be disabled to do this.
+   */
+
+  if (blk == NULL && (pool->flags & MEMPOOL_FLAG_GROW) != 0 &&
+      !up_interrupt_context())
+    {
+      leave_critical_section(flags);
+      blk = kmm_malloc(pool->blocksize);
+      flags = enter_critical_section();
+    }
+
+  /* Update the statistics */
+
+  if (blk != NULL)
+    {
+      pool->nalloc++;
+      if (++pool->nused > pool->npeak)
+        {
+          pool->npeak = pool->nused;
+        }
+    }
+  else
+    {
+      pool->nfail++;
+    }
+
+  leave_critical_section(flags);
+  return blk;
+}
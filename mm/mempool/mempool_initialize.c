@@ -0,0 +1,168 @@
+/****************************************************************************
+ * mm/mempool/mempool_initialize.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* This is the list of all memory pools */
+
+FAR struct mempool_s *g_mempools;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is the tail of the list of all memory pools */
+
+static FAR struct mempool_s *g_mempooltail;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a memory pool and add it to the list of all memory pools.
+ *
+ * Input Parameters:
+ *   pool      - The memory pool to be initialized
+ *   name      - A name for the pool.  The string must persist.
+ *   base      - Memory to hold the pre-allocated blocks or NULL
+ *   blocksize - The size of one block
+ *   nblocks   - The number of pre-allocated blocks
+ *   nreserve  - The number of pre-allocated blocks reserved for interrupt
+ *               handlers
+ *   flags     - See MEMPOOL_FLAG_* definitions
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if base is NULL and the memory for the
+ *   pre-allocated blocks could not be allocated.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       FAR void *base, size_t blocksize,
+                       unsigned int nblocks, unsigned int nreserve,
+                       uint8_t flags)
+{
+  FAR char *blk;
+  irqstate_t irqflags;
+  unsigned int i;
+
+  DEBUGASSERT(pool != NULL && blocksize >= sizeof(sq_entry_t) &&
+              nblocks <= UINT16_MAX && nreserve <= nblocks);
+
+  /* Allocate memory for the pre-allocated blocks if none was provided */
+
+  if (base == NULL && nblocks > 0)
+    {
+      base = kmm_malloc(blocksize * nblocks);
+      if (base == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  memset(pool, 0, sizeof(struct mempool_s));
+  pool->name      = name;
+  pool->base      = (FAR char *)base;
+  pool->blocksize = blocksize;
+  pool->nblocks   = nblocks;
+  pool->nreserve  = nreserve;
+  pool->nfree     = nblocks;
+  pool->flags     = flags;
+
+  /* Put all of the pre-allocated blocks into the free list */
+
+  sq_init(&pool->freelist);
+  for (i = 0, blk = pool->base; i < nblocks; i++, blk += blocksize)
+    {
+      sq_addlast((FAR sq_entry_t *)blk, &pool->freelist);
+    }
+
+  /* Add the pool at the tail of the list of all pools */
+
+  irqflags = enter_critical_section();
+  if (g_mempooltail != NULL)
+    {
+      g_mempooltail->next = pool;
+    }
+  else
+    {
+      g_mempools = pool;
+    }
+
+  g_mempooltail = pool;
+  leave_critical_section(irqflags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call the handler once for each memory pool in the system.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg)
+{
+  FAR struct mempool_s *pool;
+
+  for (pool = g_mempools; pool != NULL; pool = pool->next)
+    {
+      handler(pool, arg);
+    }
+}
@@ -56,6 +56,33 @@
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 {
+#ifdef CONFIG_MM_TLSF
+  FAR struct mm_freenode_s *next;
+  int fl;
+  int sl;
+
+  /* Convert the size to a pair of free list indices */
+
+  mm_size2tlsf(node->size, &fl, &sl);
+
+  /* The TLSF lists are not ordered.  Just put the new node at the head of
+   * the list and mark the list as non-empty.
+   */
+
+  next        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = next;
+
+  if (next)
+    {
+      next->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_flbitmap        |= (uint32_t)1 << fl;
+  heap->mm_slbitmap[fl]    |= (uint32_t)1 << sl;
+
+#else
   FAR struct mm_freenode_s *next;
   FAR struct mm_freenode_s *prev;
 
@@ -81,4 +108,5 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
       next->blink = node;
     }
+#endif
 }
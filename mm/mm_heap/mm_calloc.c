@@ -53,7 +53,8 @@
  *
  ****************************************************************************/
 
-FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
+FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size
+                    MM_CALLER_PARM)
 {
   FAR void *ret = NULL;
 
@@ -69,7 +70,7 @@ FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
 
       if (n <= (SIZE_MAX / elem_size))
         {
-          ret = mm_zalloc(heap, n * elem_size);
+          ret = mm_zalloc(heap, n * elem_size MM_CALLER_ARG);
         }
     }
 
@@ -0,0 +1,235 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cpucache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CPUCACHE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cacheinitialize
+ *
+ * Description:
+ *   Initialize the per-CPU chunk caches of a heap.  All caches are
+ *   initially empty.
+ *
+ ****************************************************************************/
+
+void mm_cacheinitialize(FAR struct mm_heap_s *heap)
+{
+  int cpu;
+
+  memset(heap->mm_cache, 0, sizeof(heap->mm_cache));
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      spin_initialize(&heap->mm_cache[cpu].mc_lock, SP_UNLOCKED);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_cachealloc
+ *
+ * Description:
+ *   Try to take a chunk of exactly 'size' bytes (including the chunk
+ *   header) from the cache of the current CPU.  The heap semaphore is not
+ *   needed.
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if there is no suitable cached chunk.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cachealloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_freenode_s *node;
+  irqstate_t flags;
+  int ndx;
+
+  if (size > MM_CACHE_MAXCHUNK)
+    {
+      return NULL;
+    }
+
+  ndx = (int)(size >> MM_MIN_SHIFT) - 1;
+
+  /* Disable local interrupts so that we cannot migrate to another CPU.
+   * The spinlock is only contended while the caches are being drained.
+   */
+
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+  spin_lock(&cache->mc_lock);
+
+  node = cache->mc_head[ndx];
+  if (node != NULL)
+    {
+      cache->mc_head[ndx] = node->flink;
+      cache->mc_count[ndx]--;
+    }
+
+  spin_unlock(&cache->mc_lock);
+  up_irq_restore(flags);
+
+  if (node == NULL)
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(node->size == size && (node->preceding & MM_ALLOC_BIT) != 0);
+  return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: mm_cachefree
+ *
+ * Description:
+ *   Try to put a small chunk into the cache of the current CPU rather than
+ *   returning it to the heap.  The chunk stays marked as allocated.  The
+ *   heap semaphore is not needed.
+ *
+ * Returned Value:
+ *   True if the chunk was cached; false if it must be returned to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cachefree(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_freenode_s *node;
+  irqstate_t flags;
+  bool cached = false;
+  int ndx;
+
+  node = (FAR struct mm_freenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
+
+  /* Only chunks that are an exact multiple of the granule size can be
+   * cached.  Chunks split by memalign() may not be.
+   */
+
+  if (node->size > MM_CACHE_MAXCHUNK || (node->size & MM_GRAN_MASK) != 0)
+    {
+      return false;
+    }
+
+  ndx = (int)(node->size >> MM_MIN_SHIFT) - 1;
+
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+  spin_lock(&cache->mc_lock);
+
+  if (cache->mc_count[ndx] < MM_CACHE_DEPTH)
+    {
+      node->flink         = cache->mc_head[ndx];
+      cache->mc_head[ndx] = node;
+      cache->mc_count[ndx]++;
+      cached              = true;
+    }
+
+  spin_unlock(&cache->mc_lock);
+  up_irq_restore(flags);
+  return cached;
+}
+
+/****************************************************************************
+ * Name: mm_cachedrain
+ *
+ * Description:
+ *   Return all cached chunks of all CPUs to the heap.  It is assumed that
+ *   the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_cachedrain(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_freenode_s *head[MM_CACHE_NCLASSES];
+  FAR struct mm_freenode_s *node;
+  irqstate_t flags;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* Detach all of the cached chunks of this CPU */
+
+      cache = &heap->mm_cache[cpu];
+      flags = up_irq_save();
+      spin_lock(&cache->mc_lock);
+
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          head[ndx]            = cache->mc_head[ndx];
+          cache->mc_head[ndx]  = NULL;
+          cache->mc_count[ndx] = 0;
+        }
+
+      spin_unlock(&cache->mc_lock);
+      up_irq_restore(flags);
+
+      /* Then return them to the heap */
+
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          while ((node = head[ndx]) != NULL)
+            {
+              head[ndx] = node->flink;
+              mm_freechunk(heap, node);
+            }
+        }
+    }
+}
+
+#endif /* CONFIG_MM_CPUCACHE */
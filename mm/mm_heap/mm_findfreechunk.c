@@ -0,0 +1,161 @@
+/****************************************************************************
+ * mm/mm_heap/mm_findfreechunk.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+
+#include <nuttx/mm/mm.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes (including the chunk
+ *   header).  The chunk is not removed from the free list.  It is assumed
+ *   that the caller holds the mm semaphore.
+ *
+ *   In the default configuration, this is the smallest free chunk that
+ *   satisfies the request.  The search is linear in the number of free
+ *   chunks in the size range of the request.
+ *
+ *   If CONFIG_MM_TLSF is selected, then the size is first rounded up to
+ *   the start of the next second level range so that every chunk in the
+ *   selected list is large enough, then the bitmaps are used to find the
+ *   first non-empty list.  This is a good fit (not a best fit) but
+ *   executes in constant time.
+ *
+ * Returned Value:
+ *   The free node or NULL if there is no suitable free chunk.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+#ifdef CONFIG_MM_TLSF
+  uint32_t bitmap;
+  int fl;
+  int sl;
+
+  if (size > MMSIZE_MAX)
+    {
+      return NULL;
+    }
+
+  /* Round the request up to the next second level range.  Reject the
+   * request if the rounded size would not fit so that the rounding cannot
+   * wrap.
+   */
+
+  if (size >= MM_TLSF_SMALL)
+    {
+      size_t round;
+
+      round = ((size_t)1 << (flsl((long)size) - 1 - MM_TLSF_SLSHIFT)) - 1;
+      if (size > MMSIZE_MAX - round)
+        {
+          return NULL;
+        }
+
+      size += round;
+    }
+
+  mm_size2tlsf(size, &fl, &sl);
+
+  /* Search for a non-empty list in the same first level range */
+
+  bitmap = heap->mm_slbitmap[fl] & (~(uint32_t)0 << sl);
+  if (bitmap == 0)
+    {
+      /* None.. Search for a non-empty, larger first level range */
+
+      if (fl + 1 >= MM_TLSF_FLCOUNT)
+        {
+          return NULL;
+        }
+
+      bitmap = heap->mm_flbitmap & (~(uint32_t)0 << (fl + 1));
+      if (bitmap == 0)
+        {
+          return NULL;
+        }
+
+      fl     = ffsl((long)bitmap) - 1;
+      bitmap = heap->mm_slbitmap[fl];
+    }
+
+  sl = ffsl((long)bitmap) - 1;
+  return heap->mm_freelist[fl][sl];
+
+#else
+  FAR struct mm_freenode_s *node;
+  int ndx;
+
+  /* Get the location in the node list to start the search. Special case
+   * really big allocations
+   */
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      ndx = MM_NNODES-1;
+    }
+  else
+    {
+      /* Convert the request size into a nodelist index */
+
+      ndx = mm_size2ndx(size);
+    }
+
+  /* Search for a large enough chunk in the list of nodes. This list is
+   * ordered by size, but will have occasional zero sized nodes as we visit
+   * other mm_nodelist[] entries.
+   */
+
+  for (node = heap->mm_nodelist[ndx].flink;
+       node && node->size < size;
+       node = node->flink);
+
+  return node;
+#endif
+}
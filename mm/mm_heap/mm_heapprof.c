@@ -0,0 +1,249 @@
+/****************************************************************************
+ * mm/mm_heap/mm_heapprof.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_HEAPPROF
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profindex
+ *
+ * Description:
+ *   Return the index of the site record of an allocation site, claiming a
+ *   free record if the site is not yet known.  Site records are hashed by
+ *   the return address and are never released, so a lookup never has to
+ *   probe past the first free record.  Zero is returned if the table is
+ *   full.  The caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+static int mm_profindex(FAR struct mm_heap_s *heap, FAR void *caller)
+{
+  FAR struct mm_profsite_s *site;
+  int index;
+  int i;
+
+  if (caller == NULL)
+    {
+      return 0;
+    }
+
+  /* Site zero is the catch-all, hash into sites 1..MM_PROF_NSITES-1 */
+
+  index = ((uintptr_t)caller >> 1) % (MM_PROF_NSITES - 1);
+  for (i = 0; i < MM_PROF_NSITES - 1; i++)
+    {
+      site = &heap->mm_profsite[index + 1];
+      if (site->ps_caller == caller)
+        {
+          return index + 1;
+        }
+      else if (site->ps_caller == NULL)
+        {
+          site->ps_caller = caller;
+          return index + 1;
+        }
+
+      if (++index >= MM_PROF_NSITES - 1)
+        {
+          index = 0;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profalloc
+ *
+ * Description:
+ *   Tag a newly allocated chunk with the allocating task and the return
+ *   address of the allocating call and add it to the statistics of that
+ *   allocation site.
+ *
+ ****************************************************************************/
+
+void mm_profalloc(FAR struct mm_heap_s *heap, FAR void *mem,
+                  FAR void *caller)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_profsite_s *site;
+  int index;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  mm_takesemaphore(heap);
+
+  index        = mm_profindex(heap, caller);
+  node->caller = caller;
+  node->pid    = getpid();
+  node->site   = index;
+  node->gen    = heap->mm_profgen;
+
+  site            = &heap->mm_profsite[index];
+  site->ps_pid    = node->pid;
+  site->ps_nalloc++;
+  site->ps_nlive++;
+  site->ps_live  += node->size;
+  site->ps_nsnap++;
+  site->ps_snap  += node->size;
+
+  if (site->ps_live > site->ps_peak)
+    {
+      site->ps_peak = site->ps_live;
+    }
+
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_proffree
+ *
+ * Description:
+ *   Remove a chunk that is about to be freed (or resized) from the
+ *   statistics of its allocation site.  The task and caller tags are
+ *   retained.
+ *
+ ****************************************************************************/
+
+void mm_proffree(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_profsite_s *site;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  mm_takesemaphore(heap);
+
+  if (node->site != MM_PROF_NOSITE)
+    {
+      DEBUGASSERT(node->site < MM_PROF_NSITES);
+      site = &heap->mm_profsite[node->site];
+
+      DEBUGASSERT(site->ps_nlive > 0 && site->ps_live >= node->size);
+      site->ps_nlive--;
+      site->ps_live -= node->size;
+
+      /* Allocations made before the last snapshot are no longer included
+       * in the snapshot counts.  The generation is only eight bits wide,
+       * so guard against a wrapped generation number.
+       */
+
+      if (node->gen == heap->mm_profgen && site->ps_nsnap > 0 &&
+          site->ps_snap >= node->size)
+        {
+          site->ps_nsnap--;
+          site->ps_snap -= node->size;
+        }
+
+      node->site = MM_PROF_NOSITE;
+    }
+
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_profsite
+ *
+ * Description:
+ *   Return a consistent copy of one allocation site record.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if index is out of range.
+ *
+ ****************************************************************************/
+
+int mm_profsite(FAR struct mm_heap_s *heap, int index,
+                FAR struct mm_profsite_s *site)
+{
+  if (index < 0 || index >= MM_PROF_NSITES)
+    {
+      return -EINVAL;
+    }
+
+  mm_takesemaphore(heap);
+  memcpy(site, &heap->mm_profsite[index], sizeof(struct mm_profsite_s));
+  mm_givesemaphore(heap);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_profsnapshot
+ *
+ * Description:
+ *   Start a new snapshot:  From now on, the snapshot counts of each site
+ *   include only the live allocations that were made after this call.
+ *   Reading them later shows what was allocated and not freed in between.
+ *
+ ****************************************************************************/
+
+void mm_profsnapshot(FAR struct mm_heap_s *heap)
+{
+  int i;
+
+  mm_takesemaphore(heap);
+
+  heap->mm_profgen++;
+  for (i = 0; i < MM_PROF_NSITES; i++)
+    {
+      heap->mm_profsite[i].ps_nsnap = 0;
+      heap->mm_profsite[i].ps_snap  = 0;
+    }
+
+  mm_givesemaphore(heap);
+}
+
+#endif /* CONFIG_MM_HEAPPROF */
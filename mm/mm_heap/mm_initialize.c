@@ -122,6 +122,13 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapend[IDX]->size        = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapend[IDX]->preceding   = node->size | MM_ALLOC_BIT;
 
+#ifdef CONFIG_MM_HEAPPROF
+  /* The guard nodes are not attributed to any allocation site */
+
+  heap->mm_heapstart[IDX]->site      = MM_PROF_NOSITE;
+  heap->mm_heapend[IDX]->site        = MM_PROF_NOSITE;
+#endif
+
 #undef IDX
 
 #if CONFIG_MM_REGIONS > 1
@@ -155,7 +162,9 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
                    size_t heapsize)
 {
+#ifndef CONFIG_MM_TLSF
   int i;
+#endif
 
   minfo("Heap: start=%p size=%u\n", heapstart, heapsize);
 
@@ -177,6 +186,15 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_nregions = 0;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Initialize the segregated free lists and bitmaps.  All lists are
+   * initially empty.
+   */
+
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+  memset(heap->mm_freelist, 0, sizeof(heap->mm_freelist));
+#else
   /* Initialize the node array */
 
   memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
@@ -185,6 +203,20 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
       heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
     }
+#endif
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Initialize the per-CPU chunk caches */
+
+  mm_cacheinitialize(heap);
+#endif
+
+#ifdef CONFIG_MM_HEAPPROF
+  /* No allocation sites are known yet */
+
+  heap->mm_profgen = 0;
+  memset(heap->mm_profsite, 0, sizeof(heap->mm_profsite));
+#endif
 
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
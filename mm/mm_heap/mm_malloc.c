@@ -69,12 +69,11 @@
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size MM_CALLER_PARM)
 {
   FAR struct mm_freenode_s *node;
   size_t alignsize;
   void *ret = NULL;
-  int ndx;
 
   /* Ignore zero-length allocations */
 
@@ -90,55 +89,50 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
   DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
 
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
-
-  /* Get the location in the node list to start the search. Special case
-   * really big allocations
+#ifdef CONFIG_MM_CPUCACHE
+  /* Small requests may be satisfied from the cache of this CPU without
+   * taking the MM semaphore.
    */
 
-  if (alignsize >= MM_MAX_CHUNK)
+  ret = mm_cachealloc(heap, alignsize);
+  if (ret != NULL)
     {
-      ndx = MM_NNODES-1;
+      goto out;
     }
-  else
-    {
-      /* Convert the request size into a nodelist index */
+#endif
 
-      ndx = mm_size2ndx(alignsize);
-    }
+  /* We need to hold the MM semaphore while we muck with the nodelist. */
+
+  mm_takesemaphore(heap);
 
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
+  /* Search for a large enough chunk in the free lists.  This will be the
+   * best fitting chunk in the default configuration or a good fitting
+   * chunk found in constant time if CONFIG_MM_TLSF is selected.
    */
 
-  for (node = heap->mm_nodelist[ndx].flink;
-       node && node->size < alignsize;
-       node = node->flink);
+  node = mm_findfreechunk(heap, alignsize);
 
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that is must be best fitting chunk
-   * available.
+#ifdef CONFIG_MM_CPUCACHE
+  /* If there is none, return the cached chunks of all CPUs to the heap and
+   * try again.
    */
 
+  if (node == NULL)
+    {
+      mm_cachedrain(heap);
+      node = mm_findfreechunk(heap, alignsize);
+    }
+#endif
+
   if (node)
     {
       FAR struct mm_freenode_s *remainder;
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -185,6 +179,19 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   mm_givesemaphore(heap);
 
+#ifdef CONFIG_MM_CPUCACHE
+out:
+#endif
+
+#ifdef CONFIG_MM_HEAPPROF
+  /* Attribute the new chunk to the allocation site */
+
+  if (ret)
+    {
+      mm_profalloc(heap, ret, caller);
+    }
+#endif
+
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   if (ret)
     {
@@ -61,7 +61,7 @@
  ****************************************************************************/
 
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
-                      size_t size)
+                      size_t size MM_CALLER_PARM)
 {
   FAR struct mm_allocnode_s *node;
   size_t rawchunk;
@@ -75,7 +75,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   if (alignment <= MM_MIN_CHUNK)
     {
-      return mm_malloc(heap, size);
+      return mm_malloc(heap, size MM_CALLER_ARG);
     }
 
   /* Adjust the size to account for (1) the size of the allocated node, (2)
@@ -95,7 +95,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Then malloc that size */
 
-  rawchunk = (size_t)mm_malloc(heap, allocsize);
+  rawchunk = (size_t)mm_malloc(heap, allocsize MM_CALLER_ARG);
   if (rawchunk == 0)
     {
       return NULL;
@@ -107,6 +107,14 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   mm_takesemaphore(heap);
 
+#ifdef CONFIG_MM_HEAPPROF
+  /* The chunk is about to be trimmed and moved.  It will be attributed to
+   * the allocation site again when that is done.
+   */
+
+  mm_proffree(heap, (FAR void *)rawchunk);
+#endif
+
   /* Get the node associated with the allocation and the next node after
    * the allocation.
    */
@@ -205,6 +213,10 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size);
     }
 
+#ifdef CONFIG_MM_HEAPPROF
+  mm_profalloc(heap, (FAR void *)alignedchunk, caller);
+#endif
+
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
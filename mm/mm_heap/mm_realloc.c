@@ -74,7 +74,7 @@
  ****************************************************************************/
 
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
-                     size_t size)
+                     size_t size MM_CALLER_PARM)
 {
   FAR struct mm_allocnode_s *oldnode;
   FAR struct mm_freenode_s  *prev;
@@ -89,7 +89,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   if (oldmem == NULL)
     {
-      return mm_malloc(heap, size);
+      return mm_malloc(heap, size MM_CALLER_ARG);
     }
 
   /* If size is zero, then realloc is equivalent to free */
@@ -119,6 +119,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   oldsize = oldnode->size;
   if (newsize <= oldsize)
     {
+#ifdef CONFIG_MM_HEAPPROF
+      /* Attribute the (possibly resized) chunk to the realloc() caller */
+
+      mm_proffree(heap, oldmem);
+#endif
+
       /* Handle the special case where we are not going to change the size
        * of the allocation.
        */
@@ -128,6 +134,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           mm_shrinkchunk(heap, oldnode, newsize);
         }
 
+#ifdef CONFIG_MM_HEAPPROF
+      mm_profalloc(heap, oldmem, caller);
+#endif
+
       /* Then return the original address */
 
       mm_givesemaphore(heap);
@@ -213,6 +223,14 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+#ifdef CONFIG_MM_HEAPPROF
+      /* The chunk is about to be resized and, perhaps, moved.  It will be
+       * attributed to the allocation site again when that is done.
+       */
+
+      mm_proffree(heap, oldmem);
+#endif
+
       /* Extend into the previous free chunk */
 
       newmem = oldmem;
@@ -220,16 +238,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from the free list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
@@ -287,16 +298,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
           andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
@@ -327,6 +331,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+#ifdef CONFIG_MM_HEAPPROF
+      mm_profalloc(heap, newmem, caller);
+#endif
+
       mm_givesemaphore(heap);
       return newmem;
     }
@@ -340,7 +348,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
        */
 
       mm_givesemaphore(heap);
-      newmem = (FAR void *)mm_malloc(heap, size);
+      newmem = (FAR void *)mm_malloc(heap, size MM_CALLER_ARG);
       if (newmem)
         {
           memcpy(newmem, oldmem, oldsize);
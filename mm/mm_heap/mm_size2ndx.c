@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <strings.h>
+
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
@@ -71,3 +73,38 @@ int mm_size2ndx(size_t size)
 
   return ndx;
 }
+
+/****************************************************************************
+ * Name: mm_size2tlsf
+ *
+ * Description:
+ *    Convert the size to a pair of TLSF first and second level free list
+ *    indices.  Every chunk in the list selected by (fl, sl) has a size in
+ *    the same range as 'size'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TLSF
+void mm_size2tlsf(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size < MM_TLSF_SMALL)
+    {
+      /* Small chunks are linearly divided in units of the granule size */
+
+      *fl = 0;
+      *sl = (int)(size >> MM_MIN_SHIFT);
+    }
+  else
+    {
+      /* Otherwise, the first level is the power of two range of the size
+       * and the second level is given by the next MM_TLSF_SLSHIFT bits.
+       */
+
+      msb = flsl((long)size) - 1;
+      *fl = msb - MM_TLSF_FLSHIFT + 1;
+      *sl = (int)(size >> (msb - MM_TLSF_SLSHIFT)) & (MM_TLSF_SLCOUNT - 1);
+    }
+}
+#endif
@@ -55,9 +55,9 @@
  *
  ****************************************************************************/
 
-FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
+FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size MM_CALLER_PARM)
 {
-  FAR void *alloc = mm_malloc(heap, size);
+  FAR void *alloc = mm_malloc(heap, size MM_CALLER_ARG);
   if (alloc)
     {
        memset(alloc, 0, size);
@@ -85,6 +85,6 @@ FAR void *calloc(size_t n, size_t elem_size)
 #else
   /* Use mm_calloc() because it implements the clear */
 
-  return mm_calloc(USR_HEAP, n, elem_size);
+  return mm_calloc(USR_HEAP, n, elem_size MM_CALLER);
 #endif
 }
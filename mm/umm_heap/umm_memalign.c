@@ -82,7 +82,7 @@ FAR void *memalign(size_t alignment, size_t size)
 
   do
     {
-      mem = mm_memalign(USR_HEAP, alignment, size);
+      mem = mm_memalign(USR_HEAP, alignment, size MM_CALLER);
       if (!mem)
         {
           brkaddr = sbrk(size);
@@ -96,6 +96,6 @@ FAR void *memalign(size_t alignment, size_t size)
 
   return mem;
 #else
-  return mm_memalign(USR_HEAP, alignment, size);
+  return mm_memalign(USR_HEAP, alignment, size MM_CALLER);
 #endif
 }
@@ -84,7 +84,7 @@ FAR void *realloc(FAR void *oldmem, size_t size)
 
   do
     {
-      mem = mm_realloc(USR_HEAP, oldmem, size);
+      mem = mm_realloc(USR_HEAP, oldmem, size MM_CALLER);
       if (!mem)
         {
           brkaddr = sbrk(size);
@@ -98,6 +98,6 @@ FAR void *realloc(FAR void *oldmem, size_t size)
 
   return mem;
 #else
-  return mm_realloc(USR_HEAP, oldmem, size);
+  return mm_realloc(USR_HEAP, oldmem, size MM_CALLER);
 #endif
 }
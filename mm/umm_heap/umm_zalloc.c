@@ -80,6 +80,6 @@ FAR void *zalloc(size_t size)
 #else
   /* Use mm_zalloc() because it implements the clear */
 
-  return mm_zalloc(USR_HEAP, size);
+  return mm_zalloc(USR_HEAP, size MM_CALLER);
 #endif
 }
@@ -53,6 +53,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <queue.h>
 #include <errno.h>
@@ -167,6 +168,19 @@ struct arp_notify_s
  ****************************************************************************/
 
 #ifdef CONFIG_NET_ARP
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table.
+ *
+ * Assumptions:
+ *   Called early in the initialization sequence.
+ *
+ ****************************************************************************/
+
+void arp_initialize(void);
+
 /****************************************************************************
  * Name: arp_format
  *
@@ -224,7 +238,8 @@ int arp_send(in_addr_t ipaddr);
  * Name: arp_poll
  *
  * Description:
- *   Poll all pending transfer for ARP requests to send.
+ *   Poll all pending transfer for ARP requests to send and for packets
+ *   that were queued awaiting ARP resolution.
  *
  * Assumptions:
  *   This function is called from the MAC device driver indirectly through
@@ -232,7 +247,7 @@ int arp_send(in_addr_t ipaddr);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_ARP_SEND
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ARP_QUEUE)
 int arp_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
 #else
 #  define arp_poll(d,c) (0)
@@ -416,6 +431,55 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr);
 
 void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr);
 
+/****************************************************************************
+ * Name: arp_queue
+ *
+ * Description:
+ *   Queue the outgoing IPv4 packet in the device buffer until the MAC
+ *   address of the next hop is known.
+ *
+ * Input Parameters:
+ *   dev    - The device that will send the packet.  d_buf holds the IPv4
+ *            packet (after the link layer header) and d_len its length.
+ *   ipaddr - The IP address of the next hop
+ *
+ * Returned Value:
+ *   None.  The caller replaces the packet in d_buf with an ARP request.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+void arp_queue(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: arp_queue_poll
+ *
+ * Description:
+ *   Send the packets queued for entries that have been resolved and repeat
+ *   the ARP requests for those that have not.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback; zero if
+ *   there was nothing to send.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+int arp_queue_poll(FAR struct net_driver_s *dev,
+                   devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: arp_snapshot
  *
@@ -467,6 +531,7 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 
 /* If ARP is disabled, stub out all ARP interfaces */
 
+#  define arp_initialize()
 #  define arp_format(d,i);
 #  define arp_send(i) (0)
 #  define arp_poll(d,c) (0)
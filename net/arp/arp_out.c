@@ -128,7 +128,8 @@ static const uint8_t g_multicast_ethaddr[3] =
  *   packet in the d_buf is replaced by an ARP request packet for the
  *   IP address. The IP packet is dropped and it is assumed that the
  *   higher level protocols (e.g., TCP) eventually will retransmit the
- *   dropped packet.
+ *   dropped packet.  If CONFIG_NET_ARP_QUEUE is selected, the IP packet is
+ *   instead queued and sent when the ARP reply is received.
  *
  *   Upon return in either the case, a packet to be sent is present in the
  *   d_buf buffer and the d_len field holds the length of the Ethernet
@@ -145,9 +146,10 @@ void arp_out(FAR struct net_driver_s *dev)
   in_addr_t destipaddr;
   int ret;
 
-#if defined(CONFIG_NET_PKT) || defined(CONFIG_NET_ARP_SEND)
+#if defined(CONFIG_NET_PKT) || defined(CONFIG_NET_ARP_SEND) || \
+    defined(CONFIG_NET_ARP_QUEUE) || defined(CONFIG_NET_IPFORWARD_FLOWCACHE)
   /* Skip sending ARP requests when the frame to be transmitted was
-   * written into a packet socket.
+   * written into a packet socket or already has its Ethernet header.
    */
 
   if (IFF_IS_NOARP(dev->d_flags))
@@ -257,6 +259,12 @@ void arp_out(FAR struct net_driver_s *dev)
     {
       ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
+#ifdef CONFIG_NET_ARP_QUEUE
+      /* Keep a copy of the IP packet until the ARP reply is received */
+
+      arp_queue(dev, ipaddr);
+#endif
+
       /* The destination address was not in our ARP table, so we overwrite
        * the IP packet with an ARP request.
        */
@@ -46,7 +46,7 @@
 #include "devif/devif.h"
 #include "arp/arp.h"
 
-#ifdef CONFIG_NET_ARP_SEND
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ARP_QUEUE)
 
 /****************************************************************************
  * Public Functions
@@ -56,7 +56,8 @@
  * Name: arp_poll
  *
  * Description:
- *   Poll all pending transfer for ARP requests to send.
+ *   Poll all pending transfer for ARP requests to send and for packets
+ *   that were queued awaiting ARP resolution.
  *
  * Assumptions:
  *   This function is called from the MAC device driver indirectly through
@@ -67,6 +68,19 @@
 
 int arp_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 {
+#ifdef CONFIG_NET_ARP_QUEUE
+  int bstop;
+
+  /* Send the packets that were waiting for ARP resolution */
+
+  bstop = arp_queue_poll(dev, callback);
+  if (bstop != 0)
+    {
+      return bstop;
+    }
+#endif
+
+#ifdef CONFIG_NET_ARP_SEND
   /* Setup for the ARP callback (most of these do not apply) */
 
   dev->d_appdata = NULL;
@@ -80,6 +94,9 @@ int arp_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   /* Call back into the driver */
 
   return callback(dev);
+#else
+  return 0;
+#endif
 }
 
-#endif /* CONFIG_NET_ARP_SEND */
+#endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ARP_QUEUE */
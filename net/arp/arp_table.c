@@ -48,13 +48,18 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
+#include <queue.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <netinet/in.h>
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -70,7 +75,21 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
+#define ARP_MAXAGE_TICK   SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
+
+/* The interval between runs of the aging worker */
+
+#define ARP_AGING_TICK    SEC2TICK(10)
+
+/* The interval between ARP requests for a pending entry */
+
+#define ARP_RETRY_TICK    MSEC2TICK(CONFIG_ARP_SEND_DELAYMSEC)
+
+/* The entry holds a valid IP/MAC address mapping.  Otherwise, an entry with
+ * a non-zero IP address is waiting for an ARP reply.
+ */
+
+#define ARP_FLAG_RESOLVED (1 << 0)
 
 /****************************************************************************
  * Private Types
@@ -82,13 +101,51 @@ struct arp_table_info_s
   FAR struct ether_addr *ai_ethaddr;  /* Location to return the MAC address */
 };
 
+/* One slot in the ARP table */
+
+struct arp_tabent_s
+{
+  dq_entry_t ae_node;                 /* LRU or free list (must be first) */
+  FAR struct arp_tabent_s *ae_hnext;  /* Next entry in the hash chain */
+  struct arp_entry_s ae_entry;        /* The IP/MAC address mapping */
+  uint8_t ae_flags;                   /* See ARP_FLAG_* definitions */
+#ifdef CONFIG_NET_ARP_QUEUE
+  uint8_t ae_npending;                /* Number of queued packets */
+  uint8_t ae_nrequests;               /* ARP requests sent while pending */
+  clock_t ae_reqtime;                 /* Time of the last ARP request */
+  FAR struct net_driver_s *ae_dev;    /* Device for the queued packets */
+  FAR struct iob_s *ae_pending[CONFIG_NET_ARP_QUEUE_DEPTH];
+#endif
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* The table of known address mappings */
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_tabent_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+
+/* Hash table of in-use entries, indexed by IP address */
+
+static FAR struct arp_tabent_s *g_arphash[CONFIG_NET_ARP_HASHSIZE];
+
+/* In-use entries, least recently used first, and free entries */
+
+static dq_queue_t g_arplru;
+static dq_queue_t g_arpfree;
+
+#ifdef CONFIG_NET_ARP_QUEUE
+/* The number of entries that hold queued packets */
+
+static unsigned int g_arpnqueued;
+#endif
+
+#ifdef CONFIG_NET_ARP_AGING
+/* Runs the aging of the ARP table */
+
+static struct work_s g_arpwork;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -141,31 +198,227 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash table index for an IP address.  The upper bytes are
+ *   folded into the lower ones so that every byte affects the low order
+ *   bits, then the whole value is reduced to the table size.
+ *
+ ****************************************************************************/
+
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash % CONFIG_NET_ARP_HASHSIZE;
+}
+
+/****************************************************************************
+ * Name: arp_hfind
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Find the in-use ARP table entry for an IP address, resolved or not,
+ *   expired or not.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_tabent_s *arp_hfind(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
+  FAR struct arp_tabent_s *ent;
+
+  for (ent = g_arphash[arp_hash(ipaddr)]; ent != NULL; ent = ent->ae_hnext)
     {
-      return e1;
+      if (net_ipv4addr_cmp(ipaddr, ent->ae_entry.at_ipaddr))
+        {
+          return ent;
+        }
     }
-  else if (e2->at_ipaddr == 0)
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_expired
+ *
+ * Description:
+ *   Return true if a resolved ARP table entry is too old to be used.
+ *
+ ****************************************************************************/
+
+static inline bool arp_expired(FAR struct arp_tabent_s *ent, clock_t now)
+{
+  return now - ent->ae_entry.at_time > ARP_MAXAGE_TICK;
+}
+
+/****************************************************************************
+ * Name: arp_flush
+ *
+ * Description:
+ *   Discard any packets queued on an ARP table entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+static void arp_flush(FAR struct arp_tabent_s *ent)
+{
+  if (ent->ae_npending > 0)
     {
-      return e2;
+      while (ent->ae_npending > 0)
+        {
+          iob_free_chain(ent->ae_pending[--ent->ae_npending],
+                         IOBUSER_NET_ARP_QUEUE);
+        }
+
+      g_arpnqueued--;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+}
+#else
+#  define arp_flush(e)
+#endif
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from the ARP table and return it to the free list.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_tabent_s *ent)
+{
+  FAR struct arp_tabent_s **link;
+
+  /* Unlink the entry from its hash chain */
+
+  for (link = &g_arphash[arp_hash(ent->ae_entry.at_ipaddr)];
+       *link != NULL;
+       link = &(*link)->ae_hnext)
     {
-      return e1;
+      if (*link == ent)
+        {
+          *link = ent->ae_hnext;
+          break;
+        }
     }
-  else
+
+  arp_flush(ent);
+
+  dq_rem(&ent->ae_node, &g_arplru);
+  ent->ae_hnext            = NULL;
+  ent->ae_entry.at_ipaddr  = 0;
+  ent->ae_flags            = 0;
+  dq_addlast(&ent->ae_node, &g_arpfree);
+}
+
+/****************************************************************************
+ * Name: arp_age_worker
+ *
+ * Description:
+ *   Remove expired entries from the ARP table.  Runs on the low priority
+ *   work queue for as long as the table is not empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_AGING
+static void arp_age_worker(FAR void *arg)
+{
+  FAR struct arp_tabent_s *ent;
+  FAR struct arp_tabent_s *next;
+  clock_t now;
+
+  net_lock();
+
+  now = clock_systimer();
+  for (ent = (FAR struct arp_tabent_s *)dq_peek(&g_arplru);
+       ent != NULL;
+       ent = next)
+    {
+      next = (FAR struct arp_tabent_s *)dq_next(&ent->ae_node);
+
+      /* Pending entries are retried and expired from the network poll */
+
+      if ((ent->ae_flags & ARP_FLAG_RESOLVED) != 0 && arp_expired(ent, now))
+        {
+          ninfo("Aging IP %08lx\n", (unsigned long)ent->ae_entry.at_ipaddr);
+          arp_release(ent);
+        }
+    }
+
+  if (!dq_empty(&g_arplru))
+    {
+      (void)work_queue(LPWORK, &g_arpwork, arp_age_worker, NULL,
+                       ARP_AGING_TICK);
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Add an entry for an IP address to the ARP table.  If the table is full,
+ *   the least recently used entry is replaced.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_tabent_s *arp_alloc(in_addr_t ipaddr)
+{
+  FAR struct arp_tabent_s *ent;
+  unsigned int hash;
+
+  ent = (FAR struct arp_tabent_s *)dq_peek(&g_arpfree);
+  if (ent == NULL)
+    {
+      ent = (FAR struct arp_tabent_s *)dq_peek(&g_arplru);
+      DEBUGASSERT(ent != NULL);
+
+      ninfo("Replacing IP %08lx\n", (unsigned long)ent->ae_entry.at_ipaddr);
+      arp_release(ent);
+    }
+
+  dq_rem(&ent->ae_node, &g_arpfree);
+
+  /* Add the entry to its hash chain and as the most recently used */
+
+  hash                    = arp_hash(ipaddr);
+  ent->ae_entry.at_ipaddr = ipaddr;
+  ent->ae_hnext           = g_arphash[hash];
+  g_arphash[hash]         = ent;
+
+  dq_addlast(&ent->ae_node, &g_arplru);
+
+#ifdef CONFIG_NET_ARP_AGING
+  /* Start the aging if this is the first entry */
+
+  if (work_available(&g_arpwork))
+    {
+      (void)work_queue(LPWORK, &g_arpwork, arp_age_worker, NULL,
+                       ARP_AGING_TICK);
+    }
+#endif
+
+  return ent;
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Make an entry the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void arp_touch(FAR struct arp_tabent_s *ent)
+{
+  if (dq_next(&ent->ae_node) != NULL)
     {
-      return e2;
+      dq_rem(&ent->ae_node, &g_arplru);
+      dq_addlast(&ent->ae_node, &g_arplru);
     }
 }
 
@@ -173,6 +426,30 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table.
+ *
+ * Assumptions:
+ *   Called early in the initialization sequence.
+ *
+ ****************************************************************************/
+
+void arp_initialize(void)
+{
+  int i;
+
+  dq_init(&g_arplru);
+  dq_init(&g_arpfree);
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
+    {
+      dq_addlast(&g_arptable[i].ae_node, &g_arpfree);
+    }
+}
+
 /****************************************************************************
  * Name: arp_update
  *
@@ -195,43 +472,45 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_tabent_s *ent;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Find the entry to update.  If there is none, the IP -> MAC address
+   * mapping is inserted in the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  ent = arp_hfind(ipaddr);
+  if (ent == NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      ent = arp_alloc(ipaddr);
+    }
+  else
+    {
+      arp_touch(ent);
+    }
 
-      if (g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
+  memcpy(ent->ae_entry.at_ethaddr.ether_addr_octet, ethaddr,
+         ETHER_ADDR_LEN);
+  ent->ae_entry.at_time = clock_systimer();
+  ent->ae_flags        |= ARP_FLAG_RESOLVED;
 
-          tabptr = &g_arptable[i];
-          break;
+#ifdef CONFIG_NET_ARP_QUEUE
+  /* If packets were waiting for this mapping, then have the device poll
+   * for them.
+   */
+
+  if (ent->ae_npending > 0)
+    {
+      if (netdev_verify(ent->ae_dev))
+        {
+          netdev_txnotify_dev(ent->ae_dev);
         }
       else
         {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+          arp_flush(ent);
         }
     }
+#endif
 
-  /* Now, tabptr is the ARP table entry which we will fill with the new
-   * information.
-   */
-
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = clock_systimer();
   return OK;
 }
 
@@ -281,19 +560,16 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_tabent_s *ent;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  ent = arp_hfind(ipaddr);
+  if (ent != NULL && (ent->ae_flags & ARP_FLAG_RESOLVED) != 0 &&
+      !arp_expired(ent, clock_systimer()))
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systimer() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      arp_touch(ent);
+      return &ent->ae_entry;
     }
 
   /* Not found */
@@ -380,18 +656,210 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
 
 void arp_delete(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_tabent_s *ent;
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr);
-  if (tabptr != NULL)
+  ent = arp_hfind(ipaddr);
+  if (ent != NULL)
+    {
+      arp_release(ent);
+    }
+}
+
+/****************************************************************************
+ * Name: arp_queue
+ *
+ * Description:
+ *   Queue the outgoing IPv4 packet in the device buffer until the MAC
+ *   address of the next hop is known.
+ *
+ * Input Parameters:
+ *   dev    - The device that will send the packet.  d_buf holds the IPv4
+ *            packet (after the link layer header) and d_len its length.
+ *   ipaddr - The IP address of the next hop
+ *
+ * Returned Value:
+ *   None.  The caller replaces the packet in d_buf with an ARP request.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+void arp_queue(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_tabent_s *ent;
+  FAR struct iob_s *iob;
+  int ret;
+
+  ent = arp_hfind(ipaddr);
+  if (ent == NULL)
+    {
+      ent = arp_alloc(ipaddr);
+    }
+  else if ((ent->ae_flags & ARP_FLAG_RESOLVED) != 0)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* The mapping has expired.  Resolve it again. */
 
-      tabptr->at_ipaddr = 0;
+      ent->ae_flags    &= ~ARP_FLAG_RESOLVED;
+      ent->ae_nrequests = 0;
     }
+
+  /* Copy the packet into an I/O buffer chain */
+
+  iob = iob_tryalloc(false, IOBUSER_NET_ARP_QUEUE);
+  if (iob != NULL)
+    {
+      ret = iob_trycopyin(iob, &dev->d_buf[NET_LL_HDRLEN(dev)], dev->d_len,
+                          0, false, IOBUSER_NET_ARP_QUEUE);
+      if (ret < 0)
+        {
+          iob_free_chain(iob, IOBUSER_NET_ARP_QUEUE);
+          iob = NULL;
+        }
+    }
+
+  if (iob == NULL)
+    {
+      nwarn("WARNING: No I/O buffer to queue packet for %08lx\n",
+            (unsigned long)ipaddr);
+    }
+  else
+    {
+      /* Packets for one next hop all go out on the same device */
+
+      if (ent->ae_npending > 0 && ent->ae_dev != dev)
+        {
+          arp_flush(ent);
+        }
+
+      /* If the queue is full, then drop the oldest packet */
+
+      if (ent->ae_npending == 0)
+        {
+          g_arpnqueued++;
+        }
+      else if (ent->ae_npending >= CONFIG_NET_ARP_QUEUE_DEPTH)
+        {
+          iob_free_chain(ent->ae_pending[0], IOBUSER_NET_ARP_QUEUE);
+          memmove(&ent->ae_pending[0], &ent->ae_pending[1],
+                  --ent->ae_npending * sizeof(FAR struct iob_s *));
+        }
+
+      ent->ae_dev = dev;
+      ent->ae_pending[ent->ae_npending++] = iob;
+    }
+
+  /* The caller sends an ARP request now.  Further requests are sent from
+   * arp_queue_poll().
+   */
+
+  ent->ae_nrequests++;
+  ent->ae_reqtime = clock_systimer();
+}
+#endif
+
+/****************************************************************************
+ * Name: arp_queue_poll
+ *
+ * Description:
+ *   Send the packets queued for entries that have been resolved and repeat
+ *   the ARP requests for those that have not.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback; zero if
+ *   there was nothing to send.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+int arp_queue_poll(FAR struct net_driver_s *dev,
+                   devif_poll_callback_t callback)
+{
+  FAR struct arp_tabent_s *ent;
+  FAR struct iob_s *iob;
+  clock_t now;
+  int bstop = 0;
+  int i;
+
+  if (g_arpnqueued == 0)
+    {
+      return 0;
+    }
+
+  now = clock_systimer();
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE && bstop == 0; i++)
+    {
+      ent = &g_arptable[i];
+      if (ent->ae_npending == 0 || ent->ae_dev != dev)
+        {
+          continue;
+        }
+
+      if ((ent->ae_flags & ARP_FLAG_RESOLVED) != 0)
+        {
+          /* Send the oldest queued packet.  The driver will add the
+           * Ethernet header in arp_out().
+           */
+
+          iob = ent->ae_pending[0];
+          memmove(&ent->ae_pending[0], &ent->ae_pending[1],
+                  --ent->ae_npending * sizeof(FAR struct iob_s *));
+          if (ent->ae_npending == 0)
+            {
+              g_arpnqueued--;
+            }
+
+          dev->d_len    = iob_copyout(&dev->d_buf[NET_LL_HDRLEN(dev)], iob,
+                                      iob->io_pktlen, 0);
+          dev->d_sndlen = 0;
+          iob_free_chain(iob, IOBUSER_NET_ARP_QUEUE);
+
+          IFF_SET_IPv4(dev->d_flags);
+          bstop = callback(dev);
+
+          /* Send the rest of the queue on the next poll */
+
+          if (ent->ae_npending > 0)
+            {
+              netdev_txnotify_dev(dev);
+            }
+        }
+      else if (now - ent->ae_reqtime >= ARP_RETRY_TICK)
+        {
+          if (ent->ae_nrequests >= CONFIG_ARP_SEND_MAXTRIES)
+            {
+              /* No reply.  Give up on the queued packets. */
+
+              nwarn("WARNING: IP %08lx unreachable\n",
+                    (unsigned long)ent->ae_entry.at_ipaddr);
+              arp_release(ent);
+              continue;
+            }
+
+          /* Repeat the ARP request */
+
+          ent->ae_nrequests++;
+          ent->ae_reqtime = now;
+
+          arp_format(dev, ent->ae_entry.at_ipaddr);
+          IFF_SET_NOARP(dev->d_flags);
+          bstop = callback(dev);
+        }
+    }
+
+  return bstop;
 }
+#endif
 
 /****************************************************************************
  * Name: arp_snapshot
@@ -417,22 +885,23 @@ void arp_delete(in_addr_t ipaddr)
 unsigned int arp_snapshot(FAR struct arp_entry_s *snapshot,
                           unsigned int nentries)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_tabent_s *ent;
   clock_t now;
   unsigned int ncopied;
-  int i;
 
-  /* Copy all non-empty, non-expired entries in the ARP table. */
+  /* Copy all resolved, non-expired entries in the ARP table. */
 
-  for (i = 0, now = clock_systimer(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
-       i++)
+  now = clock_systimer();
+  ncopied = 0;
+
+  for (ent = (FAR struct arp_tabent_s *)dq_peek(&g_arplru);
+       ent != NULL && nentries > ncopied;
+       ent = (FAR struct arp_tabent_s *)dq_next(&ent->ae_node))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr != 0 &&
-          now - tabptr->at_time <= ARP_MAXAGE_TICK)
+      if ((ent->ae_flags & ARP_FLAG_RESOLVED) != 0 && !arp_expired(ent, now))
         {
-          memcpy(&snapshot[ncopied], tabptr, sizeof(struct arp_entry_s));
+          memcpy(&snapshot[ncopied], &ent->ae_entry,
+                 sizeof(struct arp_entry_s));
           ncopied++;
         }
     }
@@ -445,4 +914,3 @@ unsigned int arp_snapshot(FAR struct arp_entry_s *snapshot,
 
 #endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET */
-
@@ -41,8 +41,12 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <net/if.h>
+
 #include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
 
 #include "ipforward/ipforward.h"
 #include "devif/devif.h"
@@ -90,6 +94,25 @@ void devif_forward(FAR struct forward_s *fwd)
   fwd->f_dev->d_sndlen = 0;
   fwd->f_dev->d_len    = fwd->f_iob->io_pktlen;
 
+#ifdef HAVE_FLOW_L2
+  /* The flow cache already knows the MAC address of the next hop.  Build
+   * the Ethernet header now and keep arp_out() from doing it again.
+   */
+
+  if (fwd->f_hasl2 && fwd->f_dev->d_lltype == NET_LL_ETHERNET)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)fwd->f_dev->d_buf;
+
+      memcpy(eth->dest, fwd->f_ethaddr, ETHER_ADDR_LEN);
+      memcpy(eth->src, fwd->f_dev->d_mac.ether.ether_addr_octet,
+             ETHER_ADDR_LEN);
+      eth->type             = HTONS(ETHTYPE_IP);
+      fwd->f_dev->d_len    += ETH_HDRLEN;
+
+      IFF_SET_NOARP(fwd->f_dev->d_flags);
+    }
+#endif
+
   UNUSED(ret);
 }
 
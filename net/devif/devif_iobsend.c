@@ -46,6 +46,8 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
+#include "utils/utils.h"
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
@@ -74,7 +76,12 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 
   /* Copy the data from the I/O buffer chain to the device buffer */
 
+#ifdef CONFIG_NET_COPYCHKSUM
+  dev->d_sndchksum = chksum_iob_copyout(0, dev->d_appdata, iob, len, offset);
+  dev->d_sndchklen = len;
+#else
   iob_copyout(dev->d_appdata, iob, len, offset);
+#endif
   dev->d_sndlen = len;
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
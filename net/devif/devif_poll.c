@@ -578,6 +578,12 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
     {
       /* Perform the TCP TX poll */
 
+#ifdef CONFIG_NET_TCP_GSO
+      /* Let the connection send a super-segment if it has enough data */
+
+      tcp_gso_enable(dev);
+#endif
+
       tcp_poll(dev, conn);
 
       /* Perform any necessary conversions on outgoing packets */
@@ -586,7 +592,11 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 
       /* Call back into the driver */
 
+#ifdef CONFIG_NET_TCP_GSO
+      bstop = tcp_gso_output(dev, conn, callback);
+#else
       bstop = callback(dev);
+#endif
     }
 
   return bstop;
@@ -622,6 +632,12 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
     {
       /* Perform the TCP timer poll */
 
+#ifdef CONFIG_NET_TCP_GSO
+      /* Let the connection send a super-segment if it has enough data */
+
+      tcp_gso_enable(dev);
+#endif
+
       tcp_timer(dev, conn, hsec);
 
       /* Perform any necessary conversions on outgoing packets */
@@ -630,7 +646,11 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
 
       /* Call back into the driver */
 
+#ifdef CONFIG_NET_TCP_GSO
+      bstop = tcp_gso_output(dev, conn, callback);
+#else
       bstop = callback(dev);
+#endif
     }
 
   return bstop;
@@ -672,12 +692,18 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 {
   int bstop = false;
 
+#ifdef CONFIG_NET_COPYCHKSUM
+  /* Discard any payload sum left from an earlier transmission */
+
+  dev->d_sndchklen = 0;
+#endif
+
   /* Traverse all of the active packet connections and perform the poll
    * action.
    */
 
-#ifdef CONFIG_NET_ARP_SEND
-  /* Check for pending ARP requests */
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ARP_QUEUE)
+  /* Check for pending ARP requests and for queued packets */
 
   bstop = arp_poll(dev, callback);
   if (!bstop)
@@ -822,6 +848,12 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   clock_t elapsed;
   int bstop = false;
 
+#ifdef CONFIG_NET_COPYCHKSUM
+  /* Discard any payload sum left from an earlier transmission */
+
+  dev->d_sndchklen = 0;
+#endif
+
   /* Get the elapsed time since the last poll in units of half seconds
    * (truncating).
    */
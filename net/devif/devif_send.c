@@ -41,6 +41,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -48,6 +50,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "devif/devif.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Public Functions
@@ -69,6 +72,15 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
 {
   DEBUGASSERT(dev != NULL && len > 0 && len < NETDEV_PKTSIZE(dev));
 
+#ifdef CONFIG_NET_COPYCHKSUM
+  /* Sum the payload as it is copied so that the TCP or UDP checksum need
+   * not read it again.
+   */
+
+  dev->d_sndchksum = chksum_copy(0, dev->d_appdata, buf, len);
+  dev->d_sndchklen = len;
+#else
   memcpy(dev->d_appdata, buf, len);
+#endif
   dev->d_sndlen = len;
 }
@@ -341,6 +341,14 @@ int ipv4_input(FAR struct net_driver_s *dev)
   g_netstats.ipv4.recv++;
 #endif
 
+#ifdef CONFIG_NET_COPYCHKSUM
+  /* Any payload sum left from an earlier transmission is not valid for
+   * the received packet.
+   */
+
+  dev->d_sndchklen = 0;
+#endif
+
   /* Start of IP input header processing code.
    *
    * Check validity of the IP header.
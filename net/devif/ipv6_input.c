@@ -289,6 +289,14 @@ int ipv6_input(FAR struct net_driver_s *dev)
   g_netstats.ipv6.recv++;
 #endif
 
+#ifdef CONFIG_NET_COPYCHKSUM
+  /* Any payload sum left from an earlier transmission is not valid for
+   * the received packet.
+   */
+
+  dev->d_sndchklen = 0;
+#endif
+
   /* Start of IP input header processing code.
    *
    * Check validity of the IP header.
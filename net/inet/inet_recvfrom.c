@@ -69,6 +69,7 @@
 #include "local/local.h"
 #include "socket/socket.h"
 #include "usrsock/usrsock.h"
+#include "utils/utils.h"
 #include "inet/inet.h"
 
 /****************************************************************************
@@ -308,7 +309,7 @@ static inline void inet_udp_newdata(FAR struct net_driver_s *dev,
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The read-ahead lock of the connection is held.
  *
  ****************************************************************************/
 
@@ -317,6 +318,9 @@ static inline void inet_tcp_readahead(struct inet_recvfrom_s *pstate)
 {
   FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)pstate->ir_sock->s_conn;
   FAR struct iob_s *iob;
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  int nfreed = 0;
+#endif
   int recvlen;
 
   /* Check there is any TCP data already buffered in a read-ahead
@@ -335,6 +339,9 @@ static inline void inet_tcp_readahead(struct inet_recvfrom_s *pstate)
       recvlen = iob_copyout(pstate->ir_buffer, iob, pstate->ir_buflen, 0);
       ninfo("Received %d bytes (of %d)\n", recvlen, iob->io_pktlen);
 
+      DEBUGASSERT(conn->rcv_queued >= recvlen);
+      conn->rcv_queued -= recvlen;
+
       /* Update the accumulated size of the data read */
 
       inet_update_recvlen(pstate, recvlen);
@@ -359,6 +366,9 @@ static inline void inet_tcp_readahead(struct inet_recvfrom_s *pstate)
 
           /* And free the I/O buffer chain */
 
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+          nfreed += tcp_iob_chainlen(iob);
+#endif
           (void)iob_free_chain(iob, IOBUSER_NET_TCP_READAHEAD);
         }
       else
@@ -368,10 +378,23 @@ static inline void inet_tcp_readahead(struct inet_recvfrom_s *pstate)
            * buffer queue).
            */
 
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+          nfreed += tcp_iob_chainlen(iob);
+          iob     = iob_trimhead_queue(&conn->readahead, recvlen,
+                                       IOBUSER_NET_TCP_READAHEAD);
+          nfreed -= tcp_iob_chainlen(iob);
+#else
           (void)iob_trimhead_queue(&conn->readahead, recvlen,
                                    IOBUSER_NET_TCP_READAHEAD);
+#endif
         }
     }
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  /* IOBs were returned to the pool; update the budget of the connection */
+
+  tcp_iob_rcvadjust(conn, -nfreed);
+#endif
 }
 #endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCP_READAHEAD */
 
@@ -1179,6 +1202,7 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags (only MSG_DONTWAIT is supported)
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1191,26 +1215,63 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
 
 #ifdef NET_UDP_HAVE_STACK
 static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                                 FAR struct sockaddr *from, FAR socklen_t *fromlen)
+                                 int flags, FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
   FAR struct net_driver_s *dev;
   struct inet_recvfrom_s state;
+#ifdef CONFIG_NET_UDP_READAHEAD
+  bool nonblock;
+#endif
   int ret;
 
+#ifdef CONFIG_NET_UDP_READAHEAD
+  /* MSG_DONTWAIT makes this one receive non-blocking */
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+#endif
+
   /* Perform the UDP recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
+  /* Initialize the state structure. */
+
+  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
+
+#if defined(CONFIG_NET_UDP_READAHEAD) && defined(CONFIG_NET_CONNLOCK)
+  /* Try to take a datagram from the read-ahead buffers while holding only
+   * the read-ahead lock of the connection.  The network lock is needed only
+   * if we have to wait for a datagram to arrive.  A datagram that was taken
+   * is returned even if it is empty:  Falling through would consume a
+   * second one.
+   */
+
+  if (net_connlock(&conn->ralock) >= 0)
+    {
+      inet_udp_readahead(&state);
+      net_connunlock(&conn->ralock);
+
+      if (state.ir_recvlen >= 0)
+        {
+          ret = state.ir_recvlen;
+          inet_recvfrom_uninitialize(&state);
+          return ret;
+        }
+    }
+#endif
+
+  /* Lock the network because we don't want anything to happen until we are
+   * ready.
    */
 
   net_lock();
-  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
 
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Copy the read-ahead data from the packet */
 
+  (void)net_connlock(&conn->ralock);
   inet_udp_readahead(&state);
+  net_connunlock(&conn->ralock);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -1231,7 +1292,7 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Handle non-blocking UDP sockets */
 
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (nonblock)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1245,14 +1306,16 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
         }
     }
 
-  /* It is okay to block if we need to.  If there is space to receive anything
-   * more, then we will wait to receive the data.  Otherwise return the number
-   * of bytes read from the read-ahead buffer (already in 'ret').
+  /* It is okay to block if we need to.  If no datagram was taken from the
+   * read-ahead buffer, then we will wait to receive one.  Otherwise return
+   * the number of bytes read from it (already in 'ret'), which is zero for
+   * an empty datagram.
    *
-   * NOTE: that inet_udp_readahead() may set state.ir_recvlen == -1.
+   * NOTE: that inet_udp_readahead() sets state.ir_recvlen == -1 if there
+   * was no datagram.
    */
 
-  else if (state.ir_recvlen <= 0)
+  else if (state.ir_recvlen < 0)
 #endif
     {
       /* Get the device that will handle the packet transfers.  This may be
@@ -1321,15 +1384,45 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                                  FAR struct sockaddr *from, FAR socklen_t *fromlen)
 {
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
   struct inet_recvfrom_s state;
   int               ret;
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
+  /* Initialize the state structure. */
+
+  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
+
+#if defined(CONFIG_NET_TCP_READAHEAD) && defined(CONFIG_NET_CONNLOCK)
+  /* Try to satisfy the request from the read-ahead buffers while holding
+   * only the read-ahead lock of the connection.  The network lock is needed
+   * only if we may have to wait for more data.  The conditions for
+   * returning here are the same as those below.
+   */
+
+  if (net_connlock(&conn->ralock) >= 0)
+    {
+      inet_tcp_readahead(&state);
+      net_connunlock(&conn->ralock);
+
+#if CONFIG_NET_TCP_RECVDELAY == 0
+      if (state.ir_recvlen > 0)
+#else
+      if (state.ir_recvlen > 0 &&
+          (state.ir_buflen == 0 || _SS_ISNONBLOCK(psock->s_flags)))
+#endif
+        {
+          ret = state.ir_recvlen;
+          inet_recvfrom_uninitialize(&state);
+          return (ssize_t)ret;
+        }
+    }
+#endif
+
+  /* Lock the network because we don't want anything to happen until we are
+   * ready.
    */
 
   net_lock();
-  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
 
   /* Handle any any TCP data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
@@ -1337,7 +1430,9 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
    */
 
 #ifdef CONFIG_NET_TCP_READAHEAD
+  (void)net_connlock(&conn->ralock);
   inet_tcp_readahead(&state);
+  net_connunlock(&conn->ralock);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -1435,8 +1530,6 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
   if (state.ir_buflen > 0)
 #endif
     {
-      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
-
       /* Set up the callback in the connection */
 
       state.ir_cb = tcp_callback_alloc(conn);
@@ -1572,7 +1665,7 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     case SOCK_DGRAM:
       {
 #ifdef NET_UDP_HAVE_STACK
-        ret = inet_udp_recvfrom(psock, buf, len, from, fromlen);
+        ret = inet_udp_recvfrom(psock, buf, len, flags, from, fromlen);
 #else
         ret = -ENOSYS;
 #endif
@@ -42,7 +42,12 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
+
+#include <netinet/in.h>
+#include <net/ethernet.h>
 
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
@@ -62,6 +67,15 @@
 #define ipfwd_callback_alloc(dev)   devif_callback_alloc(dev, &(dev)->d_conncb)
 #define ipfwd_callback_free(dev,cb) devif_dev_callback_free(dev, cb)
 
+/* The flow cache can remember the link layer address of the next hop only
+ * if it is resolved by ARP.
+ */
+
+#undef HAVE_FLOW_L2
+#if defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && defined(CONFIG_NET_ARP)
+#  define HAVE_FLOW_L2 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -81,14 +95,48 @@ struct forward_s
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
   uint8_t                      f_domain;  /* Domain: PF_INET or PF_INET6 */
 #endif
+#ifdef HAVE_FLOW_L2
+  bool                         f_hasl2;   /* True: f_ethaddr is valid */
+  uint8_t                      f_ethaddr[ETHER_ADDR_LEN]; /* Next hop MAC */
+#endif
+};
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+/* The 5-tuple that identifies one forwarded flow */
+
+struct ipv4_flowkey_s
+{
+  in_addr_t srcipaddr;                    /* Source IPv4 address */
+  in_addr_t destipaddr;                   /* Destination IPv4 address */
+  uint16_t  srcport;                      /* TCP/UDP source port */
+  uint16_t  destport;                     /* TCP/UDP destination port */
+  uint8_t   proto;                        /* IP protocol */
 };
 
+/* One entry in the flow cache.  This holds the forwarding decision that
+ * was made for the first packet of the flow.
+ */
+
+struct ipv4_flow_s
+{
+  struct ipv4_flowkey_s    f_key;         /* Identifies the flow */
+  FAR struct net_driver_s *f_outdev;      /* Egress device.  NULL: Unused */
+  clock_t                  f_time;        /* Time the flow was added */
+#ifdef HAVE_FLOW_L2
+  in_addr_t                f_nexthop;     /* IPv4 address of the next hop */
+  bool                     f_hasl2;       /* True: f_ethaddr is valid */
+  uint8_t                  f_ethaddr[ETHER_ADDR_LEN]; /* Next hop MAC */
+#endif
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
-struct ipv4_hdr_s; /* Forward reference */
-struct ipv6_hdr_s; /* Forward reference */
+struct ipv4_hdr_s;  /* Forward reference */
+struct ipv6_hdr_s;  /* Forward reference */
+struct ipv4_flow_s; /* Forward reference */
 
 /****************************************************************************
  * Name: ipfwd_initialize
@@ -267,6 +315,55 @@ void ipfwd_poll(FAR struct net_driver_s *dev);
  *
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ipv4_flow_lookup
+ *
+ * Description:
+ *   Find the cached forwarding decision for the flow of an IPv4 packet.
+ *
+ * Input Parameters:
+ *   dev  - The device on which the packet was received.
+ *   ipv4 - A pointer to the IPv4 header in within the IPv4 packet
+ *
+ * Returned Value:
+ *   The flow cache entry or NULL if the flow is not cached or the cached
+ *   decision is no longer valid.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && defined(CONFIG_NET_IPv4)
+FAR struct ipv4_flow_s *ipv4_flow_lookup(FAR struct net_driver_s *dev,
+                                         FAR struct ipv4_hdr_s *ipv4);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flow_add
+ *
+ * Description:
+ *   Remember the forwarding decision for the flow of an IPv4 packet.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received.
+ *   ipv4   - A pointer to the IPv4 header in within the IPv4 packet
+ *   fwddev - The device on which the flow is forwarded
+ *
+ * Returned Value:
+ *   The new flow cache entry.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && defined(CONFIG_NET_IPv4)
+FAR struct ipv4_flow_s *ipv4_flow_add(FAR struct net_driver_s *dev,
+                                      FAR struct ipv4_hdr_s *ipv4,
+                                      FAR struct net_driver_s *fwddev);
+#endif
+
 #ifdef CONFIG_NET_STATISTICS
 void ipfwd_dropstats(FAR struct forward_s *fwd);
 #else
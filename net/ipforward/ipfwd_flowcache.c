@@ -0,0 +1,313 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "arp/arp.h"
+#include "route/route.h"
+#include "ipforward/ipforward.h"
+
+#if defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && defined(CONFIG_NET_IPv4)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLOW_LIFETIME SEC2TICK(CONFIG_NET_IPFORWARD_FLOWCACHE_LIFETIME)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The flow cache.  This is a direct-mapped table:  Each flow can only be
+ * held in the one entry selected by the hash of its 5-tuple.  A new flow
+ * simply replaces the flow that it collides with.
+ */
+
+static struct ipv4_flow_s g_ipv4_flows[CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_key
+ *
+ * Description:
+ *   Extract the 5-tuple that identifies the flow of an IPv4 packet.  The
+ *   ports are only available in TCP and UDP packets that are not trailing
+ *   fragments.  Zero is used for the ports in all other cases.
+ *
+ ****************************************************************************/
+
+static void ipv4_flow_key(FAR struct net_driver_s *dev,
+                          FAR struct ipv4_hdr_s *ipv4,
+                          FAR struct ipv4_flowkey_s *key)
+{
+  uint16_t iphdrlen;
+
+  memset(key, 0, sizeof(struct ipv4_flowkey_s));
+  key->srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  key->proto      = ipv4->proto;
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+
+  if ((ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP) &&
+      (ipv4->ipoffset[0] & 0x1f) == 0 && ipv4->ipoffset[1] == 0 &&
+      dev->d_len >= iphdrlen + 4)
+    {
+      /* The source and destination ports are the first four bytes of both
+       * the TCP and the UDP header.
+       */
+
+      memcpy(&key->srcport, (FAR uint8_t *)ipv4 + iphdrlen, 2);
+      memcpy(&key->destport, (FAR uint8_t *)ipv4 + iphdrlen + 2, 2);
+    }
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_hash
+ *
+ * Description:
+ *   Select the flow cache entry for a 5-tuple.
+ *
+ ****************************************************************************/
+
+static FAR struct ipv4_flow_s *
+ipv4_flow_hash(FAR const struct ipv4_flowkey_s *key)
+{
+  uint32_t hash;
+
+  hash  = key->srcipaddr ^ key->destipaddr ^ key->proto;
+  hash ^= ((uint32_t)key->srcport << 16) | key->destport;
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+
+  return &g_ipv4_flows[hash % CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_match
+ ****************************************************************************/
+
+static bool ipv4_flow_match(FAR const struct ipv4_flowkey_s *key1,
+                            FAR const struct ipv4_flowkey_s *key2)
+{
+  return net_ipv4addr_cmp(key1->srcipaddr, key2->srcipaddr) &&
+         net_ipv4addr_cmp(key1->destipaddr, key2->destipaddr) &&
+         key1->srcport == key2->srcport &&
+         key1->destport == key2->destport &&
+         key1->proto == key2->proto;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_resolve
+ *
+ * Description:
+ *   Look up the link layer address of the next hop of a flow in the ARP
+ *   table.  This is the same address that arp_out() would select when the
+ *   packet is sent.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_FLOW_L2
+static void ipv4_flow_resolve(FAR struct ipv4_flow_s *flow)
+{
+  FAR struct net_driver_s *dev = flow->f_outdev;
+  in_addr_t destipaddr = flow->f_key.destipaddr;
+  struct ether_addr ethaddr;
+
+  if (dev->d_lltype != NET_LL_ETHERNET)
+    {
+      return;
+    }
+
+  /* Broadcast and multicast destinations are left to arp_out() */
+
+  if (net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST) ||
+      (NTOHL(destipaddr) & 0xf0000000) == 0xe0000000)
+    {
+      return;
+    }
+
+  if (!net_ipv4addr_maskcmp(destipaddr, dev->d_ipaddr, dev->d_netmask))
+    {
+      /* Not on the local network.  Use the router on the local network. */
+
+#ifdef CONFIG_NET_ROUTE
+      netdev_ipv4_router(dev, destipaddr, &flow->f_nexthop);
+#else
+      net_ipv4addr_copy(flow->f_nexthop, dev->d_draddr);
+#endif
+    }
+  else if (net_ipv4addr_broadcast(destipaddr, dev->d_netmask))
+    {
+      return;
+    }
+  else
+    {
+      net_ipv4addr_copy(flow->f_nexthop, destipaddr);
+    }
+
+  if (arp_find(flow->f_nexthop, &ethaddr) >= 0)
+    {
+      memcpy(flow->f_ethaddr, ethaddr.ether_addr_octet, ETHER_ADDR_LEN);
+      flow->f_hasl2 = true;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_lookup
+ *
+ * Description:
+ *   Find the cached forwarding decision for the flow of an IPv4 packet.
+ *
+ * Input Parameters:
+ *   dev  - The device on which the packet was received.
+ *   ipv4 - A pointer to the IPv4 header in within the IPv4 packet
+ *
+ * Returned Value:
+ *   The flow cache entry or NULL if the flow is not cached or the cached
+ *   decision is no longer valid.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipv4_flow_s *ipv4_flow_lookup(FAR struct net_driver_s *dev,
+                                         FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flowkey_s key;
+
+  ipv4_flow_key(dev, ipv4, &key);
+  flow = ipv4_flow_hash(&key);
+
+  if (flow->f_outdev == NULL || !ipv4_flow_match(&flow->f_key, &key))
+    {
+      return NULL;
+    }
+
+  /* The decision is re-made periodically so that route and ARP table
+   * changes are picked up, and immediately if the egress device has gone
+   * away or down.
+   */
+
+  if (clock_systimer() - flow->f_time >= FLOW_LIFETIME ||
+      !netdev_verify(flow->f_outdev) || !IFF_IS_UP(flow->f_outdev->d_flags))
+    {
+      flow->f_outdev = NULL;
+      return NULL;
+    }
+
+#ifdef HAVE_FLOW_L2
+  if (!flow->f_hasl2)
+    {
+      /* The next hop was not yet resolved when the flow was added */
+
+      ipv4_flow_resolve(flow);
+    }
+#endif
+
+  return flow;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_add
+ *
+ * Description:
+ *   Remember the forwarding decision for the flow of an IPv4 packet.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received.
+ *   ipv4   - A pointer to the IPv4 header in within the IPv4 packet
+ *   fwddev - The device on which the flow is forwarded
+ *
+ * Returned Value:
+ *   The new flow cache entry.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipv4_flow_s *ipv4_flow_add(FAR struct net_driver_s *dev,
+                                      FAR struct ipv4_hdr_s *ipv4,
+                                      FAR struct net_driver_s *fwddev)
+{
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flowkey_s key;
+
+  ipv4_flow_key(dev, ipv4, &key);
+  flow = ipv4_flow_hash(&key);
+
+  memset(flow, 0, sizeof(struct ipv4_flow_s));
+  memcpy(&flow->f_key, &key, sizeof(struct ipv4_flowkey_s));
+  flow->f_outdev = fwddev;
+  flow->f_time   = clock_systimer();
+
+#ifdef HAVE_FLOW_L2
+  ipv4_flow_resolve(flow);
+#endif
+
+  return flow;
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE && CONFIG_NET_IPv4 */
@@ -140,6 +140,10 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
  *   undeliverable datagram keeps circulating on an Internet system, and
  *   such a system eventually becoming swamped by such "immortals".
  *
+ *   The IPv4 header checksum is updated incrementally (RFC 1624):  The TTL
+ *   is the high byte of a 16-bit word of the header so decrementing it
+ *   always adds the same constant to the checksum.
+ *
  * Input Parameters:
  *   ipv4  - A pointer to the IPv4 header in within the IPv4 packet to be
  *           forwarded.
@@ -152,8 +156,7 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t iphdrlen;
-  uint16_t sum;
+  uint32_t sum;
   int ttl;
 
   /* Check time-to-live (TTL) */
@@ -176,27 +179,13 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   ipv4->ttl = ttl;
 
-  /* Get the IP header length (accounting for possible options). */
-
-  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
-
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Update the IPv4 checksum.  The one's complement sum of the header
+   * dropped by 0x0100 so the complemented checksum grows by the same
+   * amount, with the carry folded back in.
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, iphdrlen);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = htons(sum);
-    }
-
-  ipv4->ipchksum = ~sum;
+  sum            = (uint32_t)ipv4->ipchksum + HTONS(0x0100);
+  ipv4->ipchksum = (uint16_t)(sum + (sum >> 16));
   return ttl;
 }
 
@@ -214,6 +203,7 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
  *              contains the IPv4 packet.
  *   fwdddev  - The device on which the packet must be forwarded.
  *   ipv4     - A pointer to the IPv4 header in within the IPv4 packet
+ *   flow     - The flow cache entry of the packet or NULL
  *
  * Returned Value:
  *   Zero is returned if the packet was successfully forward;  A negated
@@ -224,7 +214,8 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_dev_forward(FAR struct net_driver_s *dev,
                             FAR struct net_driver_s *fwddev,
-                            FAR struct ipv4_hdr_s *ipv4)
+                            FAR struct ipv4_hdr_s *ipv4,
+                            FAR struct ipv4_flow_s *flow)
 {
   FAR struct forward_s *fwd = NULL;
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -262,6 +253,18 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
   fwd->f_domain = PF_INET; /* IPv64 address domain */
 #endif
 
+#ifdef HAVE_FLOW_L2
+  /* If the MAC address of the next hop is known, then the Ethernet header
+   * can be built without consulting the routing and ARP tables again.
+   */
+
+  if (flow != NULL && flow->f_hasl2)
+    {
+      memcpy(fwd->f_ethaddr, flow->f_ethaddr, ETHER_ADDR_LEN);
+      fwd->f_hasl2 = true;
+    }
+#endif
+
 #ifdef CONFIG_DEBUG_NET_WARN
   /* Get the size of the IPv4 + L3 header. */
 
@@ -394,7 +397,7 @@ int ipv4_forward_callback(FAR struct net_driver_s *fwddev, FAR void *arg)
 
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, NULL);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
@@ -444,18 +447,40 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
+  FAR struct ipv4_flow_s *flow = NULL;
   int ret;
 
-  /* Search for a device that can forward this packet. */
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Check if the forwarding decision for this flow is already known */
 
-  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
-  srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-
-  fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
-  if (fwddev == NULL)
+  flow = ipv4_flow_lookup(dev, ipv4);
+  if (flow != NULL)
+    {
+      fwddev = flow->f_outdev;
+    }
+  else
+#endif
     {
-      nwarn("WARNING: Not routable\n");
-      return (ssize_t)-ENETUNREACH;
+      /* Search for a device that can forward this packet. */
+
+      destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+      srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+
+      fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          return (ssize_t)-ENETUNREACH;
+        }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* Remember the decision for the following packets of the flow */
+
+      if (fwddev != dev)
+        {
+          flow = ipv4_flow_add(dev, ipv4, fwddev);
+        }
+#endif
     }
 
   /* Check if we are forwarding on the same device that we received the
@@ -466,7 +491,7 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
     {
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, flow);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
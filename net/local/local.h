@@ -63,7 +63,7 @@
 #define HAVE_LOCAL_POLL 1
 #define LOCAL_ACCEPT_NPOLLWAITERS 2
 
-/* Packet format in FIFO:
+/* Packet format in the SOCK_DGRAM FIFO (SOCK_STREAM data is not framed):
  *
  * 1. Sync bytes (7 at most)
  * 2. End/Start byte
@@ -193,16 +193,8 @@ struct local_conn_s
 
     struct
     {
-      uint16_t lc_remaining;   /* (For binary compatibility with peer) */
       volatile int lc_result;  /* Result of the connection operation (client) */
     } client;
-
-    /* Fields common to connected peers (connected or accepted) */
-
-    struct
-    {
-      uint16_t lc_remaining;   /* Bytes remaining in the incoming stream */
-    } peer;
   } u;
 #endif /* CONFIG_NET_LOCAL_STREAM */
 };
@@ -303,6 +295,26 @@ int psock_local_bind(FAR struct socket *psock,
 int psock_local_connect(FAR struct socket *psock,
                         FAR const struct sockaddr *addr);
 
+/****************************************************************************
+ * Name: psock_local_socketpair
+ *
+ * Description:
+ *   Connect two new, unbound local stream sockets to each other.  This
+ *   function implements the low-level parts of the standard socketpair()
+ *   operation.
+ *
+ * Input Parameters:
+ *   psocks - The two socket structures to be connected
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+int psock_local_socketpair(FAR struct socket *psocks[2]);
+#endif
+
 /****************************************************************************
  * Name: local_release
  *
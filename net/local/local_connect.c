@@ -360,4 +360,126 @@ int psock_local_connect(FAR struct socket *psock,
   return -EADDRNOTAVAIL;
 }
 
+/****************************************************************************
+ * Name: psock_local_socketpair
+ *
+ * Description:
+ *   Connect two new, unbound local stream sockets to each other.  This
+ *   function implements the low-level parts of the standard socketpair()
+ *   operation.
+ *
+ *   The connection uses the same FIFO pair as a connect()/accept()
+ *   connection, but the first socket plays the role of the client and the
+ *   second the role of the server so no listener is needed.  The FIFOs are
+ *   unlinked as soon as both ends have been opened.  They will be freed
+ *   when the last end is closed.
+ *
+ * Input Parameters:
+ *   psocks - The two socket structures to be connected
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int psock_local_socketpair(FAR struct socket *psocks[2])
+{
+  FAR struct local_conn_s *client;
+  FAR struct local_conn_s *server;
+  int ret;
+
+  DEBUGASSERT(psocks[0] != NULL && psocks[0]->s_conn != NULL &&
+              psocks[1] != NULL && psocks[1]->s_conn != NULL);
+
+  client = (FAR struct local_conn_s *)psocks[0]->s_conn;
+  server = (FAR struct local_conn_s *)psocks[1]->s_conn;
+
+  if (client->lc_state != LOCAL_STATE_UNBOUND ||
+      server->lc_state != LOCAL_STATE_UNBOUND)
+    {
+      return -EISCONN;
+    }
+
+  /* Both ends share the same FIFO names */
+
+  net_lock();
+  client->lc_proto       = SOCK_STREAM;
+  client->lc_type        = LOCAL_TYPE_UNNAMED;
+  client->lc_instance_id = local_generate_instance_id();
+  strncpy(client->lc_path, CONFIG_NET_LOCAL_SOCKETPAIR_PATH,
+          UNIX_PATH_MAX - 1);
+  client->lc_path[UNIX_PATH_MAX - 1] = '\0';
+
+  server->lc_proto       = SOCK_STREAM;
+  server->lc_type        = LOCAL_TYPE_UNNAMED;
+  server->lc_instance_id = client->lc_instance_id;
+  strncpy(server->lc_path, client->lc_path, UNIX_PATH_MAX);
+
+  /* Create the FIFOs needed for the connection */
+
+  ret = local_create_fifos(client);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create FIFOs for %s: %d\n",
+           client->lc_path, ret);
+      goto errout_with_lock;
+    }
+
+  /* Open the write-only side of each FIFO before its read-only side so
+   * that none of the open() calls will block.
+   */
+
+  ret = local_open_client_tx(client, false);
+  if (ret < 0)
+    {
+      goto errout_with_fifos;
+    }
+
+  ret = local_open_server_rx(server, false);
+  if (ret < 0)
+    {
+      goto errout_with_fifos;
+    }
+
+  ret = local_open_server_tx(server, false);
+  if (ret < 0)
+    {
+      goto errout_with_fifos;
+    }
+
+  ret = local_open_client_rx(client, false);
+  if (ret < 0)
+    {
+      goto errout_with_fifos;
+    }
+
+  DEBUGASSERT(client->lc_infile.f_inode != NULL &&
+              client->lc_outfile.f_inode != NULL &&
+              server->lc_infile.f_inode != NULL &&
+              server->lc_outfile.f_inode != NULL);
+
+  /* The FIFOs are not needed in the namespace any longer */
+
+  (void)local_release_fifos(client);
+
+  client->lc_state = LOCAL_STATE_CONNECTED;
+  server->lc_state = LOCAL_STATE_CONNECTED;
+
+  net_unlock();
+  return OK;
+
+errout_with_fifos:
+  nerr("ERROR: Failed to open FIFOs for %s: %d\n", client->lc_path, ret);
+
+  /* local_free() will close any FIFO that was opened when the sockets are
+   * closed.
+   */
+
+  (void)local_release_fifos(client);
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+
 #endif /* CONFIG_NET_LOCAL_STREAM */
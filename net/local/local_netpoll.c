@@ -53,6 +53,25 @@
 
 #ifdef HAVE_LOCAL_POLL
 
+/****************************************************************************
+ * Name: local_shadow_notify
+ *
+ * Description:
+ *   Forward events posted on a shadow pollfd to the caller's pollfd so that
+ *   any notification callback on the caller's pollfd is honored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+static void local_shadow_notify(FAR struct pollfd *fds)
+{
+  FAR struct pollfd *originfds = (FAR struct pollfd *)fds->ptr;
+
+  originfds->revents |= fds->revents;
+  poll_notify(originfds);
+}
+#endif
+
 /****************************************************************************
  * Name: local_accept_pollsetup
  ****************************************************************************/
@@ -152,7 +171,7 @@ void local_accept_pollnotify(FAR struct local_conn_s *conn,
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -224,11 +243,15 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
             }
 
           shadowfds[0].fd     = 0; /* Does not matter */
+          shadowfds[0].ptr    = fds;
           shadowfds[0].sem    = fds->sem;
+          shadowfds[0].cb     = local_shadow_notify;
           shadowfds[0].events = fds->events & ~POLLOUT;
 
           shadowfds[1].fd     = 1; /* Does not matter */
+          shadowfds[1].ptr    = fds;
           shadowfds[1].sem    = fds->sem;
+          shadowfds[1].cb     = local_shadow_notify;
           shadowfds[1].events = fds->events & ~POLLIN;
 
           /* Setup poll for both shadow pollfds. */
@@ -295,7 +318,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
 pollerr:
   fds->revents |= POLLERR;
-  nxsem_post(fds->sem);
+  poll_notify(fds);
   return OK;
 }
 
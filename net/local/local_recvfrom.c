@@ -47,6 +47,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -73,6 +74,7 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
 static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
                            FAR size_t *readlen)
 {
@@ -118,6 +120,7 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
 
   return OK;
 }
+#endif /* CONFIG_NET_LOCAL_DGRAM */
 
 /****************************************************************************
  * Name: psock_stream_recvfrom
@@ -148,7 +151,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       FAR socklen_t *fromlen)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
-  size_t readlen;
+  ssize_t nread;
   int ret;
 
   /* Verify that this is a connected peer socket */
@@ -163,42 +166,34 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   DEBUGASSERT(conn->lc_infile.f_inode != NULL);
 
-  /* Are there still bytes in the FIFO from the last packet? */
+  /* Stream data is not framed so just return whatever is available in the
+   * FIFO.  This will wait until at least one byte is available (unless the
+   * FIFO was opened non-blocking).
+   */
 
-  if (conn->u.peer.lc_remaining == 0)
+  do
     {
-      /* No.. Sync to the start of the next packet in the stream and get
-       * the size of the next packet.
-       */
-
-      ret = local_sync(&conn->lc_infile);
-      if (ret < 0)
-        {
-          nerr("ERROR: Failed to get packet length: %d\n", ret);
-          return ret;
-        }
-      else if (ret > UINT16_MAX)
-        {
-          nerr("ERROR: Packet is too big: %d\n", ret);
-          return -E2BIG;
-        }
-
-      conn->u.peer.lc_remaining = (uint16_t)ret;
+      nread = file_read(&conn->lc_infile, buf, len);
     }
+  while (nread == -EINTR);
 
-  /* Read the packet */
-
-  readlen = MIN(conn->u.peer.lc_remaining, len);
-  ret     = psock_fifo_read(psock, buf, &readlen);
-  if (ret < 0)
+  if (nread < 0)
     {
-      return ret;
+      nerr("ERROR: Failed to read from the FIFO: %d\n", (int)nread);
+      return nread;
     }
+  else if (nread == 0 && len > 0)
+    {
+      /* The FIFO returns zero if the peer has closed its end of the
+       * connection.  Report an orderly shutdown.
+       */
 
-  /* Adjust the number of bytes remaining to be read from the packet */
+      ninfo("Peer closed the connection\n");
 
-  DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
-  conn->u.peer.lc_remaining -= readlen;
+      psock->s_flags &= ~(_SF_CONNECTED | _SF_CLOSED);
+      conn->lc_state  = LOCAL_STATE_DISCONNECTED;
+      return 0;
+    }
 
   /* Return the address family */
 
@@ -211,7 +206,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         }
     }
 
-  return readlen;
+  return nread;
 }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
@@ -44,6 +44,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "local/local.h"
@@ -77,7 +78,7 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags)
 {
   FAR struct local_conn_s *peer;
-  int ret;
+  ssize_t nwritten;
 
   DEBUGASSERT(psock && psock->s_conn && buf);
   peer = (FAR struct local_conn_s *)psock->s_conn;
@@ -93,13 +94,24 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
       return -ENOTCONN;
     }
 
-  /* Send the packet */
+  /* A stream has no message boundaries so, unlike datagrams, the data is
+   * written to the FIFO as is, without the packet preamble and length.  A
+   * blocking write returns only when all of the data has been written; a
+   * non-blocking write may return a partial count.
+   */
 
-  ret = local_send_packet(&peer->lc_outfile, (FAR uint8_t *)buf, len);
+  do
+    {
+      nwritten = file_write(&peer->lc_outfile, buf, len);
+    }
+  while (nwritten == -EINTR);
 
-  /* If the send was successful, then the full packet will have been sent */
+  if (nwritten < 0)
+    {
+      nerr("ERROR: file_write failed: %d\n", (int)nwritten);
+    }
 
-  return ret < 0 ? ret : len;
+  return nwritten;
 }
 
 #endif /* CONFIG_NET_LOCAL_STREAM */
@@ -87,6 +87,7 @@ static ssize_t    local_sendto(FAR struct socket *psock, FAR const void *buf,
                     size_t len, int flags, FAR const struct sockaddr *to,
                     socklen_t tolen);
 static int        local_close(FAR struct socket *psock);
+static int        local_socketpair(FAR struct socket *psocks[2]);
 
 /****************************************************************************
  * Public Data
@@ -114,7 +115,11 @@ const struct sock_intf_s g_local_sockif =
   NULL,              /* si_recvmsg */
   NULL,              /* si_sendmsg */
 #endif
-  local_close        /* si_close */
+  local_close,       /* si_close */
+#ifdef CONFIG_NET_USRSOCK
+  NULL,              /* si_ioctl */
+#endif
+  local_socketpair   /* si_socketpair */
 };
 
 /****************************************************************************
@@ -836,6 +841,34 @@ static int local_close(FAR struct socket *psock)
     }
 }
 
+/****************************************************************************
+ * Name: local_socketpair
+ *
+ * Description:
+ *   Connect two new, unbound local sockets to each other.
+ *
+ * Input Parameters:
+ *   psocks  The two socket instances
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+static int local_socketpair(FAR struct socket *psocks[2])
+{
+  switch (psocks[0]->s_type)
+    {
+#ifdef CONFIG_NET_LOCAL_STREAM
+      case SOCK_STREAM:
+        return psock_local_socketpair(psocks);
+#endif
+
+      default:
+        return -EOPNOTSUPP;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
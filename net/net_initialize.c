@@ -48,6 +48,7 @@
 #include "socket/socket.h"
 #include "devif/devif.h"
 #include "netdev/netdev.h"
+#include "arp/arp.h"
 #include "ipforward/ipforward.h"
 #include "sixlowpan/sixlowpan.h"
 #include "icmp/icmp.h"
@@ -117,6 +118,12 @@ void net_initialize(void)
 
   devif_initialize();
 
+#ifdef CONFIG_NET_ARP
+  /* Initialize the ARP table */
+
+  arp_initialize();
+#endif
+
 #ifdef HAVE_FWDALLOC
   /* Initialize IP forwarding support */
 
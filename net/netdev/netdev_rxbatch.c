@@ -0,0 +1,92 @@
+/****************************************************************************
+ * net/netdev/netdev_rxbatch.c
+ *
+ *   Copyright (C) 2026 agent. All rights reserved.
+ *   Author: agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxbatch
+ *
+ * Description:
+ *   Pass a batch of received frames to the network.  The network is locked
+ *   once for the whole batch and rxfunc() is called repeatedly to receive
+ *   and dispatch one frame at a time until either there are no more frames
+ *   or the budget is exhausted.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure
+ *   rxfunc - Driver function that receives and dispatches one frame
+ *   budget - The maximum number of frames to process
+ *
+ * Returned Value:
+ *   The number of frames processed.  If this is equal to the budget, then
+ *   more frames may be waiting.
+ *
+ ****************************************************************************/
+
+int netdev_rxbatch(FAR struct net_driver_s *dev, netdev_rxfunc_t rxfunc,
+                   int budget)
+{
+  int nrx = 0;
+
+  DEBUGASSERT(dev != NULL && rxfunc != NULL && budget > 0);
+
+  net_lock();
+  while (nrx < budget && rxfunc(dev) >= 0)
+    {
+      nrx++;
+    }
+
+  net_unlock();
+
+  ninfo("%d frames received\n", nrx);
+  return nrx;
+}
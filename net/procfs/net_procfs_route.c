@@ -85,6 +85,19 @@
 #  define IPv6_INDEX  0
 #endif
 
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define ROUTE_NTABLES 2
+#else
+#  define ROUTE_NTABLES 1
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#  define STATS_INDEX     ROUTE_NTABLES
+#  define ROUTE_NENTRIES  (ROUTE_NTABLES + 1)
+#else
+#  define ROUTE_NENTRIES  ROUTE_NTABLES
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -102,6 +115,9 @@ enum route_node_e
 #ifdef CONFIG_NET_IPv6
   , PROC_ROUTE_IPv6                  /* IPv6 routing table */
 #endif
+#ifdef CONFIG_NET_STATISTICS
+  , PROC_ROUTE_STATS                 /* Routing table lookup statistics */
+#endif
 };
 
 /* This structure describes one open "file" */
@@ -162,6 +178,10 @@ static ssize_t route_ipv4_table(FAR struct route_file_s *procfile,
 static ssize_t route_ipv6_table(FAR struct route_file_s *procfile,
                  FAR char *buffer, size_t buflen, off_t offset);
 #endif
+#ifdef CONFIG_NET_STATISTICS
+static ssize_t route_stats(FAR struct route_file_s *procfile,
+                 FAR char *buffer, size_t buflen, off_t offset);
+#endif
 
 /* File system methods */
 
@@ -221,6 +241,9 @@ static const char g_route_ipv4_path[]   = "net/route/ipv4";
 #ifdef CONFIG_NET_IPv6
 static const char g_route_ipv6_path[]   = "net/route/ipv6";
 #endif
+#ifdef CONFIG_NET_STATISTICS
+static const char g_route_stats_path[]  = "net/route/stats";
+#endif
 
 /* Subdirectory names */
 
@@ -230,6 +253,9 @@ static const char g_route_ipv4_subdir[] = "ipv4";
 #ifdef CONFIG_NET_IPv6
 static const char g_route_ipv6_subdir[] = "ipv6";
 #endif
+#ifdef CONFIG_NET_STATISTICS
+static const char g_route_stats_subdir[] = "stats";
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -435,6 +461,59 @@ static ssize_t route_ipv6_table(FAR struct route_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: route_stats
+ *
+ * Description:
+ *   Format:
+ *
+ *            1111111111222222222233333333334444444444555
+ *   1234567890123456789012345678901234567890123456789012
+ *          LOOKUPS     HITS   MISSES  NOROUTE REBUILDS
+ *   IPv4  nnnnnnnn nnnnnnnn nnnnnnnn nnnnnnnn nnnnnnnn
+ *   IPv6  nnnnnnnn nnnnnnnn nnnnnnnn nnnnnnnn nnnnnnnn
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+static ssize_t route_stats(FAR struct route_file_s *procfile,
+                           FAR char *buffer, size_t buflen, off_t offset)
+{
+  struct route_info_s info;
+
+  memset(&info, 0, sizeof(struct route_info_s));
+  info.line      = procfile->line;
+  info.buffer    = buffer;
+  info.linelen   = STATUS_LINELEN;
+  info.buflen    = buflen;
+  info.remaining = buflen;
+  info.offset    = offset;
+
+  route_sprintf(&info, "      %8s %8s %8s %8s %8s\n",
+                "LOOKUPS", "HITS", "MISSES", "NOROUTE", "REBUILDS");
+
+#ifdef CONFIG_NET_IPv4
+  route_sprintf(&info, "IPv4  %8lu %8lu %8lu %8lu %8lu\n",
+                (unsigned long)g_ipv4_routestats.lookups,
+                (unsigned long)g_ipv4_routestats.hits,
+                (unsigned long)g_ipv4_routestats.misses,
+                (unsigned long)g_ipv4_routestats.noroute,
+                (unsigned long)g_ipv4_routestats.rebuilds);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  route_sprintf(&info, "IPv6  %8lu %8lu %8lu %8lu %8lu\n",
+                (unsigned long)g_ipv6_routestats.lookups,
+                (unsigned long)g_ipv6_routestats.hits,
+                (unsigned long)g_ipv6_routestats.misses,
+                (unsigned long)g_ipv6_routestats.noroute,
+                (unsigned long)g_ipv6_routestats.rebuilds);
+#endif
+
+  return info.totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: route_open
  ****************************************************************************/
@@ -460,8 +539,16 @@ static int route_open(FAR struct file *filep, FAR const char *relpath,
       return -EACCES;
     }
 
-  /* There are only two possibilities */
+  /* There are only a few possibilities */
 
+#ifdef CONFIG_NET_STATISTICS
+  if (strcmp(relpath, g_route_stats_path) == 0)
+    {
+      name = g_route_stats_subdir;
+      node = PROC_ROUTE_STATS;
+    }
+  else
+#endif
 #ifdef CONFIG_NET_IPv4
   if (strcmp(relpath, g_route_ipv4_path) == 0)
     {
@@ -557,6 +644,12 @@ static ssize_t route_read(FAR struct file *filep, FAR char *buffer,
       break;
 #endif
 
+#ifdef CONFIG_NET_STATISTICS
+    case PROC_ROUTE_STATS: /* Routing table lookup statistics */
+      ret = route_stats(procfile, buffer, buflen, filep->f_pos);
+      break;
+#endif
+
      default:
       ret = -EINVAL;
       break;
@@ -646,6 +739,13 @@ static int route_opendir(FAR const char *relpath,
         }
 #endif
 
+#ifdef CONFIG_NET_STATISTICS
+      if (strcmp(relpath, g_route_stats_path) == 0)
+        {
+          return -ENOTDIR;
+        }
+#endif
+
       return -ENOENT;
     }
 
@@ -660,7 +760,7 @@ static int route_opendir(FAR const char *relpath,
   /* This is a second level directory */
 
   level2->base.level       = 2;
-  level2->base.nentries    = 2;
+  level2->base.nentries    = ROUTE_NENTRIES;
   level2->name             = "";
   level2->node             = PROC_ROUTE;
   dir->u.procfs            = (FAR void *)level2;
@@ -722,6 +822,13 @@ static int route_readdir(struct fs_dirent_s *dir)
       dname = g_route_ipv6_subdir;
     }
   else
+#endif
+#ifdef CONFIG_NET_STATISTICS
+  if (index == STATS_INDEX)
+    {
+      dname = g_route_stats_subdir;
+    }
+  else
 #endif
     {
       /* We signal the end of the directory by returning the special
@@ -792,6 +899,13 @@ static int route_stat(const char *relpath, struct stat *buf)
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
     }
   else
+#endif
+#ifdef CONFIG_NET_STATISTICS
+  if (strcmp(relpath, g_route_stats_path) == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
 #endif
     {
       return -ENOENT;
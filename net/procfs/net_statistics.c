@@ -75,6 +75,9 @@ static int     netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+static int     netprocfs_tcp_iobs(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_TCP_IOB_BUDGET */
 static int     netprocfs_prototype(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
@@ -108,6 +111,10 @@ static const linegen_t g_stat_linegen[] =
   netprocfs_tcp_dropped_2,
 #endif /* CONFIG_NET_TCP */
 
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  netprocfs_tcp_iobs,
+#endif /* CONFIG_NET_TCP_IOB_BUDGET */
+
   netprocfs_prototype,
   netprocfs_sent
 
@@ -325,6 +332,21 @@ static int netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_tcp_iobs
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP_IOB_BUDGET)
+static int netprocfs_tcp_iobs(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  TCP IOBs     RA: %04x    WB: %04x  Drop: %04x  "
+                  "Wait: %04x\n",
+                  g_netstats.tcp.rcviobs, g_netstats.tcp.sndiobs,
+                  g_netstats.tcp.iobdrop, g_netstats.tcp.iobwait);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP_IOB_BUDGET */
+
 /****************************************************************************
  * Name: netprocfs_prototype
  ****************************************************************************/
@@ -49,6 +49,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/fileroute.h"
+#include "route/routetrie.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -99,6 +100,7 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   nwritten = net_writeroute_ipv4(&fshandle, &route);
 
   (void)net_closeroute_ipv4(&fshandle);
+  net_invalidate_routetrie_ipv4();
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
 #endif
@@ -133,6 +135,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   nwritten = net_writeroute_ipv6(&fshandle, &route);
 
   (void)net_closeroute_ipv6(&fshandle);
+  net_invalidate_routetrie_ipv6();
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
 #endif
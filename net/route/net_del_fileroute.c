@@ -53,6 +53,7 @@
 
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
+#include "route/routetrie.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -329,6 +330,13 @@ errout_with_fshandle:
 
 errout_with_lock:
   (void)net_unlockroute_ipv4();
+
+  /* The routing table may have been modified, even on failure.  This must
+   * follow the release of the routing table lock because the trie is
+   * re-built with the network locked and then the routing table locked.
+   */
+
+  net_invalidate_routetrie_ipv4();
   return ret;
 }
 #endif
@@ -478,6 +486,13 @@ errout_with_fshandle:
 
 errout_with_lock:
   (void)net_unlockroute_ipv6();
+
+  /* The routing table may have been modified, even on failure.  This must
+   * follow the release of the routing table lock because the trie is
+   * re-built with the network locked and then the routing table locked.
+   */
+
+  net_invalidate_routetrie_ipv6();
   return ret;
 }
 #endif
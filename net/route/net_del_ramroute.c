@@ -48,6 +48,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/ramroute.h"
+#include "route/routetrie.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -125,6 +126,7 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
+      net_invalidate_routetrie_ipv4();
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -178,6 +180,7 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
+      net_invalidate_routetrie_ipv6();
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -49,6 +49,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/routetrie.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -57,7 +58,7 @@
  * Pre-processor defintions
  ****************************************************************************/
 
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
 #  define IPv4_ROUTER entry.router
 #else
 #  define IPv4_ROUTER router
@@ -97,6 +98,20 @@ struct route_ipv6_match_s
 };
 #endif
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+#ifdef CONFIG_NET_IPv4
+struct net_route_stats_s g_ipv4_routestats;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct net_route_stats_s g_ipv6_routestats;
+#endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -221,6 +236,33 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_NET_STATISTICS
+  g_ipv4_routestats.lookups++;
+#endif
+
+#ifdef CONFIG_ROUTE_LPMTRIE
+  /* Find the longest matching prefix in the routing table trie.  The
+   * routing table is searched only if it could not be indexed.
+   */
+
+  ret = net_lookup_routetrie_ipv4(target, router);
+  if (ret >= 0)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      if (ret > 0)
+        {
+          g_ipv4_routestats.hits++;
+        }
+      else
+        {
+          g_ipv4_routestats.noroute++;
+        }
+#endif
+
+      return ret > 0 ? OK : -ENOENT;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -237,8 +279,17 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_NET_STATISTICS
+      g_ipv4_routestats.misses++;
+#endif
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
     }
+#if defined(CONFIG_ROUTE_IPv4_CACHEROUTE) && defined(CONFIG_NET_STATISTICS)
+  else
+    {
+      g_ipv4_routestats.hits++;
+    }
+#endif
 
   /* Did we find a route? */
 
@@ -246,6 +297,9 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
     {
       /* No.. there is no route for this address */
 
+#ifdef CONFIG_NET_STATISTICS
+      g_ipv4_routestats.noroute++;
+#endif
       return -ENOENT;
     }
 
@@ -296,6 +350,33 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_NET_STATISTICS
+  g_ipv6_routestats.lookups++;
+#endif
+
+#ifdef CONFIG_ROUTE_LPMTRIE
+  /* Find the longest matching prefix in the routing table trie.  The
+   * routing table is searched only if it could not be indexed.
+   */
+
+  ret = net_lookup_routetrie_ipv6(target, router);
+  if (ret >= 0)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      if (ret > 0)
+        {
+          g_ipv6_routestats.hits++;
+        }
+      else
+        {
+          g_ipv6_routestats.noroute++;
+        }
+#endif
+
+      return ret > 0 ? OK : -ENOENT;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
@@ -312,8 +393,17 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_NET_STATISTICS
+      g_ipv6_routestats.misses++;
+#endif
       ret = net_foreachroute_ipv6(net_ipv6_match, &match);
     }
+#if defined(CONFIG_ROUTE_IPv6_CACHEROUTE) && defined(CONFIG_NET_STATISTICS)
+  else
+    {
+      g_ipv6_routestats.hits++;
+    }
+#endif
 
   /* Did we find a route? */
 
@@ -321,6 +411,9 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
     {
       /* No.. there is no route for this address */
 
+#ifdef CONFIG_NET_STATISTICS
+      g_ipv6_routestats.noroute++;
+#endif
       return -ENOENT;
     }
 
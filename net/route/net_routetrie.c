@@ -0,0 +1,623 @@
+/****************************************************************************
+ * net/route/net_routetrie.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/routetrie.h"
+#include "route/route.h"
+
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_ROUTE_LPMTRIE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of one trie node holding addresses of 'n' bytes */
+
+#define SIZEOF_ROUTE_TRIE_S(n) (sizeof(struct route_trie_s) - 1 + 2 * (n))
+
+/* The prefix and the router address held in a trie node */
+
+#define TRIE_KEY(n)            (&(n)->rt_addr[0])
+#define TRIE_ROUTER(l,n)       (&(n)->rt_addr[(l)->addrlen])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path-compressed binary (Patricia) trie.  Each node holds
+ * a prefix of 'rt_plen' bits.  The nodes below it hold longer prefixes
+ * that begin with the same bits and are selected by the value of the bit
+ * following the prefix.  Nodes that only join two sub-tries do not hold a
+ * route.
+ */
+
+struct route_trie_s
+{
+  FAR struct route_trie_s *rt_child[2]; /* Sub-tries for the next bit = 0/1 */
+  uint8_t rt_plen;                      /* Length of the prefix in bits */
+  bool    rt_route;                     /* True: A route ends at this node */
+  uint8_t rt_addr[1];                   /* Prefix then router address */
+};
+
+/* The trie for one address family */
+
+struct route_lpm_s
+{
+  FAR struct route_trie_s *root;        /* Root of the trie */
+  uint8_t addrlen;                      /* Size of one address in bytes */
+  bool    valid;                        /* True: The trie has been built */
+  bool    usable;                       /* True: All routes were indexed */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct route_lpm_s g_ipv4_lpm =
+{
+  NULL, sizeof(in_addr_t), false, false
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct route_lpm_s g_ipv6_lpm =
+{
+  NULL, sizeof(net_ipv6addr_t), false, false
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return the value of one bit of an address in network order.  Bit zero
+ *   is the most significant bit of the first byte.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *addr, unsigned int bit)
+{
+  return (addr[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'nbits', that are the same in
+ *   two addresses.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_common(FAR const uint8_t *addr1,
+                                FAR const uint8_t *addr2,
+                                unsigned int nbits)
+{
+  unsigned int bit = 0;
+  uint8_t diff;
+
+  /* Compare whole bytes first */
+
+  while (bit + 8 <= nbits && addr1[bit >> 3] == addr2[bit >> 3])
+    {
+      bit += 8;
+    }
+
+  if (bit >= nbits)
+    {
+      return nbits;
+    }
+
+  /* Then find the first bit that differs in the byte */
+
+  diff = addr1[bit >> 3] ^ addr2[bit >> 3];
+  while (bit < nbits && (diff & (0x80 >> (bit & 7))) == 0)
+    {
+      bit++;
+    }
+
+  return bit;
+}
+
+/****************************************************************************
+ * Name: trie_prefixlen
+ *
+ * Description:
+ *   Convert a network mask into a prefix length.
+ *
+ * Returned Value:
+ *   The prefix length in bits or -EINVAL if the mask is not contiguous.
+ *
+ ****************************************************************************/
+
+static int trie_prefixlen(FAR const uint8_t *netmask, unsigned int addrlen)
+{
+  unsigned int plen = 0;
+  unsigned int bit;
+
+  while (plen < 8 * addrlen && trie_bit(netmask, plen) != 0)
+    {
+      plen++;
+    }
+
+  for (bit = plen; bit < 8 * addrlen; bit++)
+    {
+      if (trie_bit(netmask, bit) != 0)
+        {
+          return -EINVAL;
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ *
+ * Description:
+ *   Allocate a node holding the first 'plen' bits of 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s *trie_alloc(FAR struct route_lpm_s *lpm,
+                                           FAR const uint8_t *key,
+                                           unsigned int plen)
+{
+  FAR struct route_trie_s *node;
+  FAR uint8_t *prefix;
+  unsigned int nbytes;
+
+  node = (FAR struct route_trie_s *)
+    kmm_zalloc(SIZEOF_ROUTE_TRIE_S(lpm->addrlen));
+  if (node == NULL)
+    {
+      return NULL;
+    }
+
+  /* Copy the prefix.  The bits following the prefix remain zero. */
+
+  prefix = TRIE_KEY(node);
+  nbytes = plen >> 3;
+  memcpy(prefix, key, nbytes);
+
+  if ((plen & 7) != 0)
+    {
+      prefix[nbytes] = key[nbytes] & (uint8_t)(0xff << (8 - (plen & 7)));
+    }
+
+  node->rt_plen = plen;
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_free
+ *
+ * Description:
+ *   Free a node and all of the nodes below it.  The depth of the recursion
+ *   is bounded by the number of bits in an address.
+ *
+ ****************************************************************************/
+
+static void trie_free(FAR struct route_trie_s *node)
+{
+  if (node != NULL)
+    {
+      trie_free(node->rt_child[0]);
+      trie_free(node->rt_child[1]);
+      kmm_free(node);
+    }
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Add one route to the trie.  If the table holds more than one route for
+ *   the same prefix, then the first one is kept as net_ipv4/6_router()
+ *   did without the trie.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct route_lpm_s *lpm,
+                       FAR const uint8_t *target,
+                       FAR const uint8_t *netmask,
+                       FAR const uint8_t *router)
+{
+  FAR struct route_trie_s **link;
+  FAR struct route_trie_s *node;
+  FAR struct route_trie_s *leaf;
+  FAR struct route_trie_s *glue;
+  unsigned int common = 0;
+  int plen;
+
+  plen = trie_prefixlen(netmask, lpm->addrlen);
+  if (plen < 0)
+    {
+      nwarn("WARNING: Non-contiguous netmask cannot be indexed\n");
+      return plen;
+    }
+
+  /* Walk down the trie while the prefix of each node is a prefix of the
+   * new route.
+   */
+
+  link = &lpm->root;
+  while ((node = *link) != NULL)
+    {
+      common = trie_common(target, TRIE_KEY(node),
+                           plen < node->rt_plen ? plen : node->rt_plen);
+
+      if (common < node->rt_plen)
+        {
+          /* The new route diverges from this node (or ends above it).  A
+           * new node must be placed above it.
+           */
+
+          break;
+        }
+
+      if (node->rt_plen == plen)
+        {
+          /* The node holds exactly this prefix */
+
+          if (!node->rt_route)
+            {
+              memcpy(TRIE_ROUTER(lpm, node), router, lpm->addrlen);
+              node->rt_route = true;
+            }
+
+          return OK;
+        }
+
+      link = &node->rt_child[trie_bit(target, node->rt_plen)];
+    }
+
+  leaf = trie_alloc(lpm, target, plen);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(TRIE_ROUTER(lpm, leaf), router, lpm->addrlen);
+  leaf->rt_route = true;
+
+  if (node == NULL)
+    {
+      /* Add the new route at the end of the path */
+
+      *link = leaf;
+    }
+  else if (common == plen)
+    {
+      /* The new route is a prefix of the node.  Insert it above the node. */
+
+      leaf->rt_child[trie_bit(TRIE_KEY(node), plen)] = node;
+      *link = leaf;
+    }
+  else
+    {
+      /* The new route and the node diverge at bit 'common'.  Join them
+       * with a new node holding their common prefix.
+       */
+
+      glue = trie_alloc(lpm, target, common);
+      if (glue == NULL)
+        {
+          kmm_free(leaf);
+          return -ENOMEM;
+        }
+
+      glue->rt_child[trie_bit(target, common)]         = leaf;
+      glue->rt_child[trie_bit(TRIE_KEY(node), common)] = node;
+      *link = glue;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_lookup
+ *
+ * Description:
+ *   Return the node holding the longest prefix route that matches the
+ *   target address or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s *trie_lookup(FAR struct route_lpm_s *lpm,
+                                            FAR const uint8_t *target)
+{
+  FAR struct route_trie_s *node = lpm->root;
+  FAR struct route_trie_s *best = NULL;
+
+  while (node != NULL &&
+         trie_common(target, TRIE_KEY(node), node->rt_plen) == node->rt_plen)
+    {
+      if (node->rt_route)
+        {
+          best = node;
+        }
+
+      if (node->rt_plen >= 8 * lpm->addrlen)
+        {
+          break;
+        }
+
+      node = node->rt_child[trie_bit(target, node->rt_plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: trie_invalidate
+ *
+ * Description:
+ *   Free the trie so that it will be re-built on the next lookup.
+ *
+ ****************************************************************************/
+
+static void trie_invalidate(FAR struct route_lpm_s *lpm)
+{
+  net_lock();
+  trie_free(lpm->root);
+  lpm->root   = NULL;
+  lpm->valid  = false;
+  lpm->usable = false;
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: trie_build_ipv4 and trie_build_ipv6
+ *
+ * Description:
+ *   Routing table traversal callbacks that add each route to the trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int trie_build_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  FAR int *result = (FAR int *)arg;
+
+  *result = trie_insert(&g_ipv4_lpm, (FAR const uint8_t *)&route->target,
+                        (FAR const uint8_t *)&route->netmask,
+                        (FAR const uint8_t *)&route->router);
+  return *result < 0 ? 1 : 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int trie_build_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  FAR int *result = (FAR int *)arg;
+
+  *result = trie_insert(&g_ipv6_lpm, (FAR const uint8_t *)route->target,
+                        (FAR const uint8_t *)route->netmask,
+                        (FAR const uint8_t *)route->router);
+  return *result < 0 ? 1 : 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: trie_built
+ *
+ * Description:
+ *   Record the outcome of building the trie.  If any route could not be
+ *   indexed, then the partial trie is discarded and lookups fall back to
+ *   searching the routing table until the table is next modified.
+ *
+ ****************************************************************************/
+
+static void trie_built(FAR struct route_lpm_s *lpm, int ret, int result)
+{
+  lpm->valid  = true;
+  lpm->usable = (ret >= 0 && result >= 0);
+
+  if (!lpm->usable)
+    {
+      nerr("ERROR: Failed to index the routing table: %d\n",
+           ret < 0 ? ret : result);
+
+      trie_free(lpm->root);
+      lpm->root = NULL;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lookup_routetrie_ipv4 and net_lookup_routetrie_ipv6
+ *
+ * Description:
+ *   Find the router for the longest prefix in the routing table that
+ *   matches the target address.  The trie is (re-)built from the routing
+ *   table on the first lookup after the routing table was modified.
+ *
+ * Input Parameters:
+ *   target - An IP address on a remote network to use in the lookup.
+ *   router - The location to return the address of the router
+ *
+ * Returned Value:
+ *   One (1) is returned if a route was found; zero (0) is returned if there
+ *   is no route to the target.  A negated errno value is returned if the
+ *   routing table could not be indexed.  In that case the caller must
+ *   fall back to searching the routing table.
+ *
+ * Assumptions:
+ *   Lookups are normally performed with the network locked by the caller
+ *   so that taking the lock again here costs no more than a count.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookup_routetrie_ipv4(in_addr_t target, FAR in_addr_t *router)
+{
+  FAR struct route_trie_s *node;
+  int result = OK;
+  int ret;
+
+  net_lock();
+  if (!g_ipv4_lpm.valid)
+    {
+      ret = net_foreachroute_ipv4(trie_build_ipv4, &result);
+      trie_built(&g_ipv4_lpm, ret, result);
+
+#ifdef CONFIG_NET_STATISTICS
+      g_ipv4_routestats.rebuilds++;
+#endif
+    }
+
+  if (!g_ipv4_lpm.usable)
+    {
+      ret = -ENOSYS;
+    }
+  else
+    {
+      node = trie_lookup(&g_ipv4_lpm, (FAR const uint8_t *)&target);
+      if (node != NULL)
+        {
+          memcpy(router, TRIE_ROUTER(&g_ipv4_lpm, node), sizeof(in_addr_t));
+          ret = 1;
+        }
+      else
+        {
+          ret = 0;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookup_routetrie_ipv6(const net_ipv6addr_t target,
+                              net_ipv6addr_t router)
+{
+  FAR struct route_trie_s *node;
+  int result = OK;
+  int ret;
+
+  net_lock();
+  if (!g_ipv6_lpm.valid)
+    {
+      ret = net_foreachroute_ipv6(trie_build_ipv6, &result);
+      trie_built(&g_ipv6_lpm, ret, result);
+
+#ifdef CONFIG_NET_STATISTICS
+      g_ipv6_routestats.rebuilds++;
+#endif
+    }
+
+  if (!g_ipv6_lpm.usable)
+    {
+      ret = -ENOSYS;
+    }
+  else
+    {
+      node = trie_lookup(&g_ipv6_lpm, (FAR const uint8_t *)target);
+      if (node != NULL)
+        {
+          memcpy(router, TRIE_ROUTER(&g_ipv6_lpm, node),
+                 sizeof(net_ipv6addr_t));
+          ret = 1;
+        }
+      else
+        {
+          ret = 0;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_invalidate_routetrie_ipv4 and net_invalidate_routetrie_ipv6
+ *
+ * Description:
+ *   Discard the trie after the routing table was modified.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_invalidate_routetrie_ipv4(void)
+{
+  trie_invalidate(&g_ipv4_lpm);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_invalidate_routetrie_ipv6(void)
+{
+  trie_invalidate(&g_ipv6_lpm);
+}
+#endif
+
+#endif /* CONFIG_NET_ROUTE && CONFIG_ROUTE_LPMTRIE */
@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <net/if.h>
 
 #include <nuttx/net/ip.h>
@@ -82,6 +83,19 @@ typedef int (*route_handler_ipv6_t)(FAR struct net_route_ipv6_s *route,
                                     FAR void *arg);
 #endif /* CONFIG_NET_IPv6 */
 
+#ifdef CONFIG_NET_STATISTICS
+/* Routing table lookup statistics */
+
+struct net_route_stats_s
+{
+  uint32_t lookups;          /* Number of routing table lookups */
+  uint32_t hits;             /* Lookups answered by the cache or trie */
+  uint32_t misses;           /* Lookups that had to search the table */
+  uint32_t noroute;          /* Lookups that found no route */
+  uint32_t rebuilds;         /* Number of times the trie was built */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -94,6 +108,18 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_NET_STATISTICS
+/* Lookup statistics for each routing table */
+
+#ifdef CONFIG_NET_IPv4
+EXTERN struct net_route_stats_s g_ipv4_routestats;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+EXTERN struct net_route_stats_s g_ipv6_routestats;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
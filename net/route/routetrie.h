@@ -0,0 +1,109 @@
+/****************************************************************************
+ * net/route/routetrie.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __NET_ROUTE_ROUTETRIE_H
+#define __NET_ROUTE_ROUTETRIE_H 1
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPMTRIE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lookup_routetrie_ipv4 and net_lookup_routetrie_ipv6
+ *
+ * Description:
+ *   Find the router for the longest prefix in the routing table that
+ *   matches the target address.  The trie is (re-)built from the routing
+ *   table on the first lookup after the routing table was modified.
+ *
+ * Input Parameters:
+ *   target - An IP address on a remote network to use in the lookup.
+ *   router - The location to return the address of the router
+ *
+ * Returned Value:
+ *   One (1) is returned if a route was found; zero (0) is returned if there
+ *   is no route to the target.  A negated errno value is returned if the
+ *   routing table could not be indexed.  In that case the caller must
+ *   fall back to searching the routing table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookup_routetrie_ipv4(in_addr_t target, FAR in_addr_t *router);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookup_routetrie_ipv6(const net_ipv6addr_t target,
+                              net_ipv6addr_t router);
+#endif
+
+/****************************************************************************
+ * Name: net_invalidate_routetrie_ipv4 and net_invalidate_routetrie_ipv6
+ *
+ * Description:
+ *   Discard the trie after the routing table was modified.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_invalidate_routetrie_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_invalidate_routetrie_ipv6(void);
+#endif
+
+#else
+#  define net_invalidate_routetrie_ipv4()
+#  define net_invalidate_routetrie_ipv6()
+#endif /* CONFIG_ROUTE_LPMTRIE */
+#endif /* __NET_ROUTE_ROUTETRIE_H */
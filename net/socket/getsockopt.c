@@ -274,14 +274,64 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#if defined(CONFIG_NET_TCP_READAHEAD) || defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+#ifdef CONFIG_NET_TCP_READAHEAD
+      case SO_RCVBUF:     /* Reports receive buffer size */
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      case SO_SNDBUF:     /* Reports send buffer size */
+#endif
+        {
+          FAR struct tcp_conn_s *conn;
+          int buffersize = 0;
+
+          /* Only TCP sockets have buffers that can be sized */
+
+          if (psock->s_type != SOCK_STREAM ||
+              (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+            {
+              return -ENOPROTOOPT;
+            }
+
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          conn = (FAR struct tcp_conn_s *)psock->s_conn;
+          DEBUGASSERT(conn != NULL);
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+          if (option == SO_RCVBUF)
+            {
+              buffersize = conn->rcv_bufs;
+            }
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+          if (option == SO_SNDBUF)
+            {
+              buffersize = conn->snd_bufs;
+            }
+#endif
+
+          *(FAR int *)value = buffersize;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       /* The following are not yet implemented (return values other than {0,1) */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
       case SO_ERROR:      /* Reports and clears error status. */
       case SO_LINGER:     /* Lingers on a close() if data is present */
+#ifndef CONFIG_NET_TCP_READAHEAD
       case SO_RCVBUF:     /* Sets receive buffer size */
-      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
+#endif
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
       case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       default:
@@ -47,6 +47,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -133,7 +134,16 @@ int psock_close(FAR struct socket *psock)
 
 int net_close(int sockfd)
 {
-  return psock_close(sockfd_socket(sockfd));
+  FAR struct socket *psock = sockfd_socket(sockfd);
+
+  /* Remove the descriptor from any epoll interest sets */
+
+  if (psock != NULL)
+    {
+      epoll_fdclose(psock);
+    }
+
+  return psock_close(psock);
 }
 
 #endif /* CONFIG_NET */
@@ -46,6 +46,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/kmalloc.h>
 
@@ -127,6 +128,7 @@ void net_releaselist(FAR struct socketlist *list)
       FAR struct socket *psock = &list->sl_sockets[ndx];
       if (psock->s_crefs > 0)
         {
+          epoll_fdclose(psock);
           (void)psock_close(psock);
         }
     }
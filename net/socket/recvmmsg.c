@@ -0,0 +1,252 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg_one
+ *
+ * Description:
+ *   Receive one message of a batch.
+ *
+ ****************************************************************************/
+
+static ssize_t psock_recvmmsg_one(FAR struct socket *psock,
+                                  FAR struct msghdr *msg, int flags)
+{
+  if (msg->msg_iovlen != 1)
+    {
+      return -ENOTSUP;
+    }
+
+#ifdef CONFIG_NET_CMSG
+  if (psock->s_sockif->si_recvmsg != NULL)
+    {
+      return psock->s_sockif->si_recvmsg(psock, msg, flags);
+    }
+#endif
+
+  return psock_recvfrom(psock, msg->msg_iov->iov_base,
+                        msg->msg_iov->iov_len, flags, msg->msg_name,
+                        (FAR socklen_t *)&msg->msg_namelen);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a batch of up to 'vlen' messages from a
+ *   socket with the network locked only once.  This is an internal OS
+ *   interface.  It is functionally equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - The array of messages to receive
+ *   vlen    - The number of messages in msgvec
+ *   flags   - Receive flags
+ *   timeout - The time limit for the whole batch (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  The number of
+ *   bytes received in each message is returned in its msg_len field.  If
+ *   the very first receive fails, a negated errno value is returned (see
+ *   comments with recvfrom() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  clock_t start = 0;
+  clock_t ticks = 0;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+      start = clock_systimer();
+    }
+
+  /* Keep the network locked for the whole batch so that each message costs
+   * only a recursive lock count.  The lock is still given up if we have to
+   * wait for a message to arrive.
+   */
+
+  net_lock();
+  for (i = 0; i < vlen; i++)
+    {
+      ret = psock_recvmmsg_one(psock, &msgvec[i].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      /* With MSG_WAITFORONE, only the first message may be waited for */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      /* Like Linux, the timeout is checked only after each message has
+       * been received.  It does not interrupt a blocked receive.
+       */
+
+      if (timeout != NULL && clock_systimer() - start >= ticks)
+        {
+          i++;
+          break;
+        }
+    }
+
+  net_unlock();
+
+  /* As with Linux, an error after the first message is not reported */
+
+  if (i > 0)
+    {
+      return i;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() call receives multiple messages from a socket with one
+ *   call.  It is equivalent to calling recvmsg() for each message in
+ *   'msgvec'.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The array of messages to receive
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags.  MSG_WAITFORONE makes all but the first receive
+ *            non-blocking.
+ *   timeout  The time limit for the whole batch (may be NULL).  It is
+ *            checked after each message is received and it is not updated.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  The number of
+ *   bytes received in each message is returned in its msg_len field.  On
+ *   error, -1 is returned, and errno is set appropriately (see recvmsg()
+ *   for the complete list).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
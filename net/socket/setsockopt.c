@@ -306,11 +306,74 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 #endif
+#if defined(CONFIG_NET_TCP_READAHEAD) || defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+#ifdef CONFIG_NET_TCP_READAHEAD
+      case SO_RCVBUF:     /* Sets receive buffer size */
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+        {
+          FAR struct tcp_conn_s *conn;
+          int buffersize;
+
+          /* Only TCP sockets have buffers that can be sized */
+
+          if (psock->s_type != SOCK_STREAM ||
+              (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+            {
+              return -ENOPROTOOPT;
+            }
+
+          /* Verify that option is the size of an 'int'.  Should also check
+           * that 'value' is properly aligned for an 'int'
+           */
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* Get the value.  Zero removes the limit. */
+
+          buffersize = *(FAR int *)value;
+          if (buffersize < 0)
+            {
+              return -EINVAL;
+            }
+
+          net_lock();
+
+          conn = (FAR struct tcp_conn_s *)psock->s_conn;
+          DEBUGASSERT(conn != NULL);
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+          if (option == SO_RCVBUF)
+            {
+              conn->rcv_bufs = buffersize;
+            }
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+          if (option == SO_SNDBUF)
+            {
+              conn->snd_bufs = buffersize;
+            }
+#endif
+
+          net_unlock();
+        }
+        break;
+#endif
+
       /* The following are not yet implemented */
 
+#ifndef CONFIG_NET_TCP_READAHEAD
       case SO_RCVBUF:     /* Sets receive buffer size */
-      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
+#endif
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
       case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       /* There options are only valid when used with getopt */
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * net/socket/socketpair.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: socketpair
+ *
+ * Description:
+ *   socketpair() creates an unnamed pair of connected sockets in the
+ *   specified domain, of the specified type, and using the optionally
+ *   specified protocol.  The descriptors used in referencing the new
+ *   sockets are returned in sv[0] and sv[1].  The two sockets are
+ *   indistinguishable.
+ *
+ * Input Parameters:
+ *   domain   (see sys/socket.h)
+ *   type     (see sys/socket.h)
+ *   protocol (see sys/socket.h)
+ *   sv       The location to return the two socket descriptors
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  On failure, -1 (ERROR) is returned
+ *   and errno is set appropriately:
+ *
+ *   EAFNOSUPPORT
+ *     The specified address family is not supported.
+ *   EFAULT
+ *     The address sv does not specify valid memory.
+ *   EMFILE
+ *     Process file table overflow.
+ *   ENFILE
+ *     The system limit on the total number of open files has been reached.
+ *   EOPNOTSUPP
+ *     The specified protocol does not support creation of socket pairs.
+ *   EPROTONOSUPPORT
+ *     The specified protocol is not supported on this machine.
+ *
+ ****************************************************************************/
+
+int socketpair(int domain, int type, int protocol, int sv[2])
+{
+  FAR struct socket *psocks[2];
+  int errcode;
+  int ret;
+  int i;
+
+  if (sv == NULL)
+    {
+      errcode = EFAULT;
+      goto errout;
+    }
+
+  /* Allocate and initialize the two sockets */
+
+  for (i = 0; i < 2; i++)
+    {
+      sv[i] = sockfd_allocate(0);
+      if (sv[i] < 0)
+        {
+          nerr("ERROR: Failed to allocate a socket descriptor\n");
+          errcode = ENFILE;
+          goto errout_with_sockets;
+        }
+
+      psocks[i] = sockfd_socket(sv[i]);
+      if (psocks[i] == NULL)
+        {
+          errcode = ENOSYS; /* should not happen */
+          goto errout_with_sockfd;
+        }
+
+      ret = psock_socket(domain, type, protocol, psocks[i]);
+      if (ret < 0)
+        {
+          nerr("ERROR: psock_socket() failed: %d\n", ret);
+          errcode = -ret;
+          goto errout_with_sockfd;
+        }
+    }
+
+  /* Then let the address family connect them to each other */
+
+  if (psocks[0]->s_sockif->si_socketpair == NULL)
+    {
+      errcode = EOPNOTSUPP;
+      goto errout_with_sockets;
+    }
+
+  ret = psocks[0]->s_sockif->si_socketpair(psocks);
+  if (ret < 0)
+    {
+      nerr("ERROR: si_socketpair() failed: %d\n", ret);
+      errcode = -ret;
+      goto errout_with_sockets;
+    }
+
+  psocks[0]->s_flags |= _SF_CONNECTED;
+  psocks[1]->s_flags |= _SF_CONNECTED;
+  return OK;
+
+errout_with_sockfd:
+  sockfd_release(sv[i]);
+
+errout_with_sockets:
+  while (--i >= 0)
+    {
+      (void)net_close(sv[i]);
+    }
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+#endif /* CONFIG_NET */
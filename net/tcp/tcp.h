@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
@@ -53,6 +54,10 @@
 #  include <nuttx/wqueue.h>
 #endif
 
+#ifdef CONFIG_NET_TCP_GSO
+#  include <nuttx/net/netdev.h>
+#endif
+
 #if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
 
 /****************************************************************************
@@ -61,6 +66,12 @@
 
 #define NET_TCP_HAVE_STACK 1
 
+/* Number of buckets in the connection lookup hash tables */
+
+#ifndef CONFIG_NET_TCP_HASHSIZE
+#  define CONFIG_NET_TCP_HASHSIZE 16
+#endif
+
 /* Conditions for support TCP poll/select operations */
 
 #ifdef CONFIG_NET_TCP_READAHEAD
@@ -106,6 +117,41 @@
 #  endif
 #endif
 
+/* Modulo 2**32 comparison of TCP sequence numbers */
+
+#define TCP_SEQ_LT(a,b)  ((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
+#define TCP_SEQ_LTE(a,b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)) <= 0)
+#define TCP_SEQ_GT(a,b)  TCP_SEQ_LT(b,a)
+#define TCP_SEQ_GTE(a,b) TCP_SEQ_LTE(b,a)
+
+#ifdef CONFIG_NET_TCP_CC
+/* Congestion control state flags (see struct tcp_cc_s) */
+
+#  define TCP_CC_RECOVERY    (1 << 0) /* Fast recovery is in progress */
+#  define TCP_CC_REXMIT      (1 << 1) /* Retransmit the first hole now */
+#  define TCP_CC_HOLE        (1 << 2) /* Retransmit a hole below the
+                                       * highest SACKed sequence number */
+#  define TCP_CC_SACKOK      (1 << 3) /* The peer permits SACK */
+
+/* The number of duplicate ACKs that trigger a fast retransmission */
+
+#  define TCP_CC_DUPTHRESH   3
+
+/* An upper bound on the congestion window that cannot be mistaken for a
+ * negative number.
+ */
+
+#  define TCP_CC_MAXWND      0x3fffffff
+
+/* The number of SACK blocks remembered from the peer */
+
+#  define TCP_SACK_NBLOCKS   4
+#endif
+
+/* The largest window scale shift permitted by RFC 7323 */
+
+#define TCP_MAX_WS           14
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -124,6 +170,70 @@ struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
 
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_conn_s;        /* Forward reference */
+struct tcp_cc_ops_s;      /* Forward reference */
+
+/* One block of data that the peer has reported as received (SACKed) */
+
+#ifdef CONFIG_NET_TCP_SACK
+struct tcp_sack_s
+{
+  uint32_t left;          /* First sequence number of the block */
+  uint32_t right;         /* Sequence number following the block */
+};
+#endif
+
+/* Congestion control state of one TCP connection.  All windows and
+ * thresholds are in bytes.
+ */
+
+struct tcp_cc_s
+{
+  FAR const struct tcp_cc_ops_s *ops; /* The congestion control algorithm */
+  uint32_t cwnd;          /* Congestion window */
+  uint32_t ssthresh;      /* Slow start threshold */
+  uint32_t snduna;        /* Oldest unacknowledged sequence number */
+  uint32_t recover;       /* sndseq_max when fast recovery was entered */
+  uint32_t rxtseq;        /* Next sequence number to be retransmitted */
+  uint32_t acked;         /* Bytes ACKed towards the next cwnd increase */
+  uint8_t  dupacks;       /* Number of consecutive duplicate ACKs */
+  uint8_t  flags;         /* See TCP_CC_* definitions */
+#ifdef CONFIG_NET_TCP_SACK
+  uint8_t  nsacks;        /* Number of valid entries in sacks[] */
+  struct tcp_sack_s sacks[TCP_SACK_NBLOCKS];
+#endif
+
+  /* CUBIC state */
+
+  clock_t  epoch;         /* Start of the current growth epoch (0: none) */
+  uint32_t wmax;          /* Window at the last loss event */
+  uint32_t origin;        /* Window that the cubic function starts from */
+  uint32_t west;          /* Window that Reno would have reached */
+  uint32_t k;             /* Time to reach origin from epoch (msec) */
+};
+
+/* A congestion control algorithm.  Slow start and fast recovery are
+ * common to all algorithms; an algorithm provides the congestion
+ * avoidance growth and the reaction to loss.
+ *
+ *   name       - The name of the algorithm
+ *   init       - Initialize the algorithm state when the connection is
+ *                established (optional)
+ *   cong_avoid - Grow cwnd in response to 'acked' newly ACKed bytes when
+ *                cwnd is at or above ssthresh
+ *   ssthresh   - Return the new slow start threshold after a loss
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+#endif /* CONFIG_NET_TCP_CC */
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -158,6 +268,20 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+  /* Connection lookup hash table links:
+   *
+   *   hnext - Links an active connection into the hash table keyed by the
+   *           connection's port numbers and remote address.
+   *   pnext - Links a connection with a bound local port into the hash
+   *           table keyed by the local port number.
+   *   lnext - Links a listening connection into the hash table of
+   *           listeners keyed by the local port number.
+   */
+
+  FAR struct tcp_conn_s *hnext;
+  FAR struct tcp_conn_s *pnext;
+  FAR struct tcp_conn_s *lnext;
+
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -179,7 +303,12 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
-  uint16_t winsize;       /* Current window size of the connection */
+  uint32_t winsize;       /* Current window size of the connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint8_t  snd_scale;     /* Shift applied to the window of the peer */
+  uint8_t  rcv_scale;     /* Shift applied to our advertised window */
+  bool     wscale;        /* True: Window scaling has been negotiated */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -201,6 +330,13 @@ struct tcp_conn_s
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+  uint32_t rcv_queued;            /* Bytes in the read-ahead queue */
+  uint32_t rcv_bufs;              /* Receive buffer size (SO_RCVBUF), zero
+                                   * if there is no limit */
+#ifdef CONFIG_NET_CONNLOCK
+  sem_t ralock;                   /* Protects the read-ahead queue and
+                                   * rcv_queued */
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -220,6 +356,18 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+  uint32_t   snd_bufs;    /* Send buffer size (SO_SNDBUF), zero if there is
+                           * no limit */
+  sem_t      snd_sem;     /* Wakes senders waiting for send buffer space */
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+  struct tcp_cc_s cc;     /* Congestion control state */
+#endif
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  uint16_t   rcv_iobs;    /* IOBs held for read-ahead data */
+  uint16_t   snd_iobs;    /* IOBs held in write buffers */
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -327,6 +475,13 @@ extern "C"
 
 EXTERN struct net_driver_s *g_netdevices;
 
+#ifdef CONFIG_NET_TCP_CC
+/* The built-in congestion control algorithms */
+
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_newreno;
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1375,14 +1530,38 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
  *   Calculate the TCP receive window for the specified device.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection that will advertise the window.
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The value of the TCP receive window to use.  This is the value for the
+ *   window field of the TCP header so, if window scaling is in effect, it
+ *   has already been scaled.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev);
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_get_wscale
+ *
+ * Description:
+ *   Select the window scale shift to offer in a SYN or SYNACK:  The
+ *   smallest shift that lets the largest receive window of the connection
+ *   be advertised.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection that will advertise the window.
+ *
+ * Returned Value:
+ *   The window scale shift (0-14).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_wscale(FAR struct tcp_conn_s *conn);
+#endif
 
 /****************************************************************************
  * Name: psock_tcp_cansend
@@ -1515,6 +1694,347 @@ void tcp_wrbuffer_dump(FAR const char *msg, FAR struct tcp_wrbuffer_s *wrb,
 #endif
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_gso_advance
+ *
+ * Description:
+ *   Account for one more segment of a super-segment that is being sent
+ *   from the write buffer at the head of the write queue.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection whose write buffer is being sent
+ *   len  - The size of the segment payload
+ *
+ * Returned Value:
+ *   The sequence number of the first byte of the segment.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+uint32_t tcp_gso_advance(FAR struct tcp_conn_s *conn, unsigned int len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_gso_enable
+ *
+ * Description:
+ *   Permit the next poll of a TCP connection to produce a super-segment if
+ *   the device can take one.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure that is being polled
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+void tcp_gso_enable(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: tcp_gso_output
+ *
+ * Description:
+ *   Pass the packet produced by a poll of a TCP connection to the device
+ *   driver and, if the poll produced a super-segment, then build and pass
+ *   each of the remaining segments as well.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure that is being polled
+ *   conn     - The TCP connection that was polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback.  Nonzero
+ *   means that the driver cannot accept more packets.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+int tcp_gso_output(FAR struct net_driver_s *dev,
+                   FAR struct tcp_conn_s *conn,
+                   devif_poll_callback_t callback);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   been established.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   snduna - The first sequence number that will carry data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn, uint32_t snduna);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state for an incoming ACK.  New data
+ *   ACKed opens the congestion window; duplicate ACKs lead to fast
+ *   retransmission and fast recovery.  When a retransmission is needed,
+ *   TCP_CC_REXMIT or TCP_CC_HOLE is set in conn->cc.flags and cc.rxtseq
+ *   tells where to retransmit from.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ackseq - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment is a possible duplicate ACK:  It carries
+ *            no data, no SYN or FIN, and does not change the window.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq, bool dupack);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control state when the retransmission timer
+ *   expires.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_sndwnd
+ *
+ * Description:
+ *   Return the number of bytes that may be sent now.  This is the smaller
+ *   of the congestion window and the peer's receive window, less the data
+ *   already in flight.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   seqno - The sequence number of the next byte to be sent
+ *
+ * Returned Value:
+ *   The number of bytes that may be sent.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+uint32_t tcp_cc_sndwnd(FAR struct tcp_conn_s *conn, uint32_t seqno);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Merge the blocks of a received SACK option into the connection's SACK
+ *   scoreboard.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   opt    - The SACK option data that follows the kind and length bytes
+ *   optlen - The length of the option data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR const uint8_t *opt,
+                    unsigned int optlen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_covered
+ *
+ * Description:
+ *   Check if the peer has reported all of a range of sequence numbers as
+ *   received.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   start - The first sequence number of the range
+ *   end   - The sequence number following the range
+ *
+ * Returned Value:
+ *   True if the whole range has been SACKed.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+bool tcp_sack_covered(FAR struct tcp_conn_s *conn, uint32_t start,
+                      uint32_t end);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_high
+ *
+ * Description:
+ *   Return the highest sequence number SACKed by the peer.  Un-SACKed data
+ *   below this is presumed lost once fast recovery has begun.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The sequence number following the highest SACK block or, if there are
+ *   no SACK blocks, the oldest unacknowledged sequence number.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+uint32_t tcp_sack_high(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_iob_chainlen
+ *
+ * Description:
+ *   Return the number of IOBs in an I/O buffer chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+unsigned int tcp_iob_chainlen(FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: tcp_iob_rcvadjust
+ *
+ * Description:
+ *   Adjust the number of IOBs that a connection holds for read-ahead data,
+ *   and the total for TCP, by the number of IOBs just added to or removed
+ *   from its read-ahead queue.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   niobs - The number of IOBs added (positive) or removed (negative)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the read-ahead lock of the connection held.  The network
+ *   need not be locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+void tcp_iob_rcvadjust(FAR struct tcp_conn_s *conn, int niobs);
+#endif
+
+/****************************************************************************
+ * Name: tcp_iob_trimcount
+ *
+ * Description:
+ *   Return the number of IOBs that iob_trimhead() will free when trimming
+ *   trimlen bytes from the head of an I/O buffer chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+unsigned int tcp_iob_trimcount(FAR struct iob_s *iob, unsigned int trimlen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_iob_sndadjust
+ *
+ * Description:
+ *   Adjust the number of IOBs that a connection holds in its write
+ *   buffers, and the total for TCP, by the number of IOBs just queued or
+ *   freed.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   niobs - The number of IOBs queued (positive) or freed (negative)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+void tcp_iob_sndadjust(FAR struct tcp_conn_s *conn, int niobs);
+#endif
+
+/****************************************************************************
+ * Name: tcp_iob_space
+ *
+ * Description:
+ *   Return the number of additional IOBs that a connection may take for
+ *   read-ahead data or for write buffers without exceeding its quota or
+ *   the limit for TCP.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   rcv  - True: Read-ahead data; false: Write buffers
+ *
+ * Returned Value:
+ *   The number of IOBs that may be taken.  Zero if the budget is exhausted.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+unsigned int tcp_iob_space(FAR struct tcp_conn_s *conn, bool rcv);
+#endif
+
 /****************************************************************************
  * Name: tcp_pollsetup
  *
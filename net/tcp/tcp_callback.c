@@ -49,6 +49,7 @@
 #include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
+#include "utils/utils.h"
 #include "tcp/tcp.h"
 
 #ifdef NET_TCP_HAVE_STACK
@@ -246,8 +247,27 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t buflen)
 {
   FAR struct iob_s *iob;
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  unsigned int niobs;
+#endif
   int ret;
 
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  /* Drop the packet if buffering it would exceed the IOB budget of the
+   * connection.
+   */
+
+  if ((buflen + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE >
+      tcp_iob_space(conn, true))
+    {
+      nwarn("WARNING: IOB budget exhausted, dropping %u bytes\n", buflen);
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.iobdrop++;
+#endif
+      return 0;
+    }
+#endif
+
   /* Try to allocate on I/O buffer to start the chain without waiting (and
    * throttling as necessary).  If we would have to wait, then drop the
    * packet.
@@ -279,7 +299,24 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
    * without waiting).
    */
 
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  /* Count the IOBs now.  Once queued, they may be consumed at any time. */
+
+  niobs = tcp_iob_chainlen(iob);
+#endif
+
+  (void)net_connlock(&conn->ralock);
   ret = iob_tryadd_queue(iob, &conn->readahead);
+  if (ret >= 0)
+    {
+      conn->rcv_queued += buflen;
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+      tcp_iob_rcvadjust(conn, (int)niobs);
+#endif
+    }
+
+  net_connunlock(&conn->ralock);
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
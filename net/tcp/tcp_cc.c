@@ -0,0 +1,391 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The algorithm used by new connections */
+
+#ifdef CONFIG_NET_TCP_CC_DEFAULT_CUBIC
+#  define TCP_CC_DEFAULT  (&g_tcp_cc_cubic)
+#else
+#  define TCP_CC_DEFAULT  (&g_tcp_cc_newreno)
+#endif
+
+/* The initial window of RFC 3390 */
+
+#define TCP_CC_INITWND(mss) \
+  ((mss) > 1095 ? ((mss) > 2190 ? 2 * (mss) : 4380) : 4 * (mss))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_enter_recovery
+ *
+ * Description:
+ *   Enter fast recovery after the third duplicate ACK (RFC 6582).
+ *
+ ****************************************************************************/
+
+static void tcp_cc_enter_recovery(FAR struct tcp_conn_s *conn,
+                                  uint32_t ackseq)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+
+  cc->ssthresh = cc->ops->ssthresh(conn);
+  cc->cwnd     = cc->ssthresh + TCP_CC_DUPTHRESH * conn->mss;
+  cc->acked    = 0;
+  cc->recover  = conn->sndseq_max;
+  cc->rxtseq   = ackseq;
+  cc->flags   |= TCP_CC_RECOVERY | TCP_CC_REXMIT;
+
+  ninfo("Fast retransmit: ackseq=%u recover=%u cwnd=%u ssthresh=%u\n",
+        ackseq, cc->recover, cc->cwnd, cc->ssthresh);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rexmit++;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_cc_newack
+ *
+ * Description:
+ *   Handle an ACK that acknowledges new data.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_newack(FAR struct tcp_conn_s *conn, uint32_t ackseq)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  uint32_t acked = ackseq - cc->snduna;
+
+  cc->snduna  = ackseq;
+  cc->dupacks = 0;
+
+  if ((cc->flags & TCP_CC_RECOVERY) != 0)
+    {
+      if (TCP_SEQ_GTE(ackseq, cc->recover))
+        {
+          /* A full ACK.  Leave fast recovery and deflate the window to
+           * ssthresh, but never let it permit a burst of more than one
+           * segment beyond the data still in flight.
+           */
+
+          cc->flags &= ~(TCP_CC_RECOVERY | TCP_CC_REXMIT | TCP_CC_HOLE);
+          cc->cwnd   = cc->ssthresh;
+          if (cc->cwnd > conn->unacked + conn->mss)
+            {
+              cc->cwnd = conn->unacked + conn->mss;
+            }
+
+          ninfo("Recovered: ackseq=%u cwnd=%u\n", ackseq, cc->cwnd);
+        }
+      else
+        {
+          /* A partial ACK.  The segment at ackseq was lost as well.
+           * Deflate the window by the amount ACKed, add back one segment,
+           * and retransmit.  With SACK, holes that have already been
+           * retransmitted are not sent again.
+           */
+
+          cc->cwnd = (cc->cwnd > acked ? cc->cwnd - acked : 0) + conn->mss;
+
+#ifdef CONFIG_NET_TCP_SACK
+          if ((cc->flags & TCP_CC_SACKOK) != 0)
+            {
+              if (TCP_SEQ_LT(cc->rxtseq, ackseq))
+                {
+                  cc->rxtseq = ackseq;
+                }
+
+              cc->flags |= TCP_CC_HOLE;
+            }
+          else
+#endif
+            {
+              cc->rxtseq = ackseq;
+              cc->flags |= TCP_CC_REXMIT;
+            }
+        }
+
+      return;
+    }
+
+  /* Open the window:  Slow start below ssthresh, otherwise whatever the
+   * algorithm does in congestion avoidance.
+   */
+
+  if (cc->cwnd < cc->ssthresh)
+    {
+      cc->cwnd += acked < conn->mss ? acked : conn->mss;
+    }
+  else
+    {
+      cc->ops->cong_avoid(conn, acked);
+    }
+
+  if (cc->cwnd > TCP_CC_MAXWND)
+    {
+      cc->cwnd = TCP_CC_MAXWND;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   been established.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   snduna - The first sequence number that will carry data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn, uint32_t snduna)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+
+  if (cc->ops == NULL)
+    {
+      cc->ops = TCP_CC_DEFAULT;
+    }
+
+  cc->cwnd     = TCP_CC_INITWND(conn->mss);
+  cc->ssthresh = TCP_CC_MAXWND;
+  cc->snduna   = snduna;
+  cc->recover  = snduna - 1;
+  cc->rxtseq   = snduna;
+  cc->acked    = 0;
+  cc->dupacks  = 0;
+  cc->flags   &= TCP_CC_SACKOK;
+#ifdef CONFIG_NET_TCP_SACK
+  cc->nsacks   = 0;
+#endif
+
+  if (cc->ops->init != NULL)
+    {
+      cc->ops->init(conn);
+    }
+
+  ninfo("%s: cwnd=%u mss=%u sack=%d\n", cc->ops->name, cc->cwnd, conn->mss,
+        (cc->flags & TCP_CC_SACKOK) != 0);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state for an incoming ACK.  New data
+ *   ACKed opens the congestion window; duplicate ACKs lead to fast
+ *   retransmission and fast recovery.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ackseq - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment is a possible duplicate ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked and with conn->unacked already updated
+ *   for this ACK.
+ *
+ ****************************************************************************/
+
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq, bool dupack)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+
+  if (cc->ops == NULL)
+    {
+      /* Not yet established */
+
+      return;
+    }
+
+  if (TCP_SEQ_GT(ackseq, cc->snduna))
+    {
+      tcp_cc_newack(conn, ackseq);
+    }
+  else if (dupack && ackseq == cc->snduna && conn->unacked > 0)
+    {
+      if ((cc->flags & TCP_CC_RECOVERY) != 0)
+        {
+          /* Each further duplicate ACK means that another segment has
+           * left the network.  Inflate the window to let a new one in.
+           */
+
+          cc->cwnd += conn->mss;
+
+#ifdef CONFIG_NET_TCP_SACK
+          /* With SACK, also retransmit the next hole, if any */
+
+          if ((cc->flags & TCP_CC_SACKOK) != 0)
+            {
+              cc->flags |= TCP_CC_HOLE;
+            }
+#endif
+        }
+      else if (++cc->dupacks == TCP_CC_DUPTHRESH &&
+               TCP_SEQ_GT(ackseq, cc->recover))
+        {
+          tcp_cc_enter_recovery(conn, ackseq);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control state when the retransmission timer
+ *   expires.  The window collapses to one segment and slow start begins
+ *   again.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+
+  if (cc->ops == NULL)
+    {
+      return;
+    }
+
+  cc->ssthresh = cc->ops->ssthresh(conn);
+  cc->cwnd     = conn->mss;
+  cc->acked    = 0;
+  cc->dupacks  = 0;
+  cc->recover  = conn->sndseq_max;
+  cc->flags   &= ~(TCP_CC_RECOVERY | TCP_CC_REXMIT | TCP_CC_HOLE);
+#ifdef CONFIG_NET_TCP_SACK
+  cc->nsacks   = 0;
+#endif
+
+  ninfo("Timeout: cwnd=%u ssthresh=%u\n", cc->cwnd, cc->ssthresh);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_sndwnd
+ *
+ * Description:
+ *   Return the number of bytes that may be sent now.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   seqno - The sequence number of the next byte to be sent
+ *
+ * Returned Value:
+ *   The number of bytes that may be sent.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_sndwnd(FAR struct tcp_conn_s *conn, uint32_t seqno)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  uint32_t wnd;
+  uint32_t avail;
+
+  if (cc->ops == NULL)
+    {
+      return conn->winsize;
+    }
+
+  wnd   = cc->cwnd < conn->winsize ? cc->cwnd : conn->winsize;
+  avail = wnd > conn->unacked ? wnd - conn->unacked : 0;
+
+  /* The oldest unacknowledged segment may always be (re)sent if the peer
+   * has any window at all.  Otherwise a fast retransmission could be
+   * held back by the data that it is meant to recover.
+   */
+
+  if (seqno == cc->snduna && avail < conn->mss)
+    {
+      avail = conn->mss < conn->winsize ? conn->mss : conn->winsize;
+    }
+
+  return avail;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
@@ -0,0 +1,281 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CUBIC (RFC 8312) with C = 0.4 and beta = 0.7.  The window is kept in
+ * bytes and time in milliseconds so that the cubic function becomes:
+ *
+ *   W(t) = origin + mss * 4 * (t - K)^3 / 10^10
+ *   K    = cbrt((wmax - cwnd) * 2.5 * 10^9 / mss)
+ */
+
+#define CUBIC_BETA_NUM     7     /* beta = 7/10 */
+#define CUBIC_BETA_DEN     10
+#define CUBIC_K_SCALE      2500000000ull
+
+/* Limit |t - K| so that the cube cannot overflow */
+
+#define CUBIC_MAXDELTA     1000000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                 /* name */
+  cubic_init,              /* init */
+  cubic_cong_avoid,        /* cong_avoid */
+  cubic_ssthresh           /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Return the integer cube root of a 64-bit value.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t value)
+{
+  uint64_t root = 0;
+  int shift;
+
+  /* Bitwise digit-by-digit cube root */
+
+  for (shift = 63; shift >= 0; shift -= 3)
+    {
+      uint64_t trial;
+
+      root <<= 1;
+      trial  = 3 * root * (root + 1) + 1;
+      if ((value >> shift) >= trial)
+        {
+          value -= trial << shift;
+          root++;
+        }
+    }
+
+  return (uint32_t)root;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+
+  cc->epoch  = 0;
+  cc->wmax   = 0;
+  cc->origin = 0;
+  cc->west   = 0;
+  cc->k      = 0;
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Grow the congestion window towards the cubic function of the time since
+ *   the last loss, but never more slowly than Reno would (TCP-friendly
+ *   region).
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  clock_t now = clock_systimer();
+  uint32_t target;
+  int64_t delta;
+  int64_t offset;
+
+  if (cc->epoch == 0)
+    {
+      /* Start a new epoch */
+
+      cc->epoch = now != 0 ? now : 1;
+      cc->west  = cc->cwnd;
+      cc->acked = 0;
+
+      if (cc->cwnd < cc->wmax)
+        {
+          cc->k      = cubic_cbrt((uint64_t)(cc->wmax - cc->cwnd) *
+                                  CUBIC_K_SCALE / conn->mss);
+          cc->origin = cc->wmax;
+        }
+      else
+        {
+          cc->k      = 0;
+          cc->origin = cc->cwnd;
+        }
+    }
+
+  /* Evaluate the cubic function at the current time */
+
+  delta = (int64_t)TICK2MSEC(now - cc->epoch) - cc->k;
+  if (delta > CUBIC_MAXDELTA)
+    {
+      delta = CUBIC_MAXDELTA;
+    }
+  else if (delta < -CUBIC_MAXDELTA)
+    {
+      delta = -CUBIC_MAXDELTA;
+    }
+
+  /* Clamp the target before it is narrowed to 32 bits:  Long after K the
+   * cubic term is far larger than any window.
+   */
+
+  offset = ((delta * delta / 1000) * delta / 1000) * 4 * conn->mss / 10000;
+  if (offset < 0 && (uint32_t)-offset >= cc->origin)
+    {
+      target = conn->mss;
+    }
+  else if ((int64_t)cc->origin + offset > TCP_CC_MAXWND)
+    {
+      target = TCP_CC_MAXWND;
+    }
+  else
+    {
+      target = (uint32_t)((int64_t)cc->origin + offset);
+    }
+
+  /* The window of a Reno flow with the same loss rate:  It grows by
+   * 3 * (1 - beta) / (1 + beta) segments per window ACKed.
+   */
+
+  cc->west += (uint32_t)((uint64_t)conn->mss * acked * 9 /
+                         ((uint64_t)cc->cwnd * 17));
+  if (target < cc->west)
+    {
+      target = cc->west;
+    }
+
+  if (target > cc->cwnd)
+    {
+      uint32_t incr = (uint32_t)((uint64_t)(target - cc->cwnd) * acked /
+                                 cc->cwnd);
+
+      cc->cwnd += incr > 0 ? incr : 1;
+    }
+  else
+    {
+      /* Plateau around wmax:  Grow by at most one segment per 100
+       * windows.
+       */
+
+      cc->acked += acked;
+      if (cc->acked >= 100 * cc->cwnd)
+        {
+          cc->acked = 0;
+          cc->cwnd += conn->mss;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss and reduce it by beta.  If the window
+ *   is still below the previous wmax then the available bandwidth has
+ *   dropped and wmax is reduced further to release it sooner (fast
+ *   convergence).
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  uint32_t ssthresh;
+
+  cc->epoch = 0;
+
+  if (cc->cwnd < cc->wmax)
+    {
+      cc->wmax = (uint32_t)((uint64_t)cc->cwnd *
+                            (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                            (2 * CUBIC_BETA_DEN));
+    }
+  else
+    {
+      cc->wmax = cc->cwnd;
+    }
+
+  ssthresh = (uint32_t)((uint64_t)cc->cwnd * CUBIC_BETA_NUM /
+                        CUBIC_BETA_DEN);
+  if (ssthresh < 2 * (uint32_t)conn->mss)
+    {
+      ssthresh = 2 * (uint32_t)conn->mss;
+    }
+
+  return ssthresh;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
@@ -55,14 +55,17 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/mm/mempool.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "utils/utils.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -72,6 +75,10 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Select the port hash table bucket for a port number */
+
+#define TCP_PORTHASH(p) ((unsigned int)(p) % CONFIG_NET_TCP_HASHSIZE)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -80,14 +87,28 @@
 
 static struct tcp_conn_s g_tcp_connections[CONFIG_NET_TCP_CONNS];
 
-/* A list of all free TCP connections */
+/* The pool of all free TCP connections.  The pool does not grow. */
 
-static dq_queue_t g_free_tcp_connections;
+static struct mempool_s g_tcp_connpool;
 
 /* A list of all connected TCP connections */
 
 static dq_queue_t g_active_tcp_connections;
 
+/* All active connections are also retained in a hash table keyed by the
+ * port numbers and the remote address so that incoming segments can be
+ * matched with a connection quickly.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_connhash[CONFIG_NET_TCP_HASHSIZE];
+
+/* All allocated connections that are bound to a local port are retained in
+ * a hash table keyed by the local port number.  This is used to determine
+ * if a port number is available.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_porthash[CONFIG_NET_TCP_HASHSIZE];
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
@@ -96,6 +117,170 @@ static uint16_t g_last_tcp_port;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_ipv4_hash
+ *
+ * Description:
+ *   Select the connection hash table bucket for an IPv4 connection with
+ *   the given remote address and port numbers (network byte order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline unsigned int tcp_ipv4_hash(in_addr_t raddr, uint16_t lport,
+                                         uint16_t rport)
+{
+  uint32_t hash = (uint32_t)raddr ^ ((uint32_t)lport << 16 | rport);
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash % CONFIG_NET_TCP_HASHSIZE;
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Name: tcp_ipv6_hash
+ *
+ * Description:
+ *   Select the connection hash table bucket for an IPv6 connection with
+ *   the given remote address and port numbers (network byte order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline unsigned int tcp_ipv6_hash(const net_ipv6addr_t raddr,
+                                         uint16_t lport, uint16_t rport)
+{
+  uint32_t hash = (uint32_t)lport << 16 | rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      hash ^= (uint32_t)raddr[i] << 16 | raddr[i + 1];
+    }
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash % CONFIG_NET_TCP_HASHSIZE;
+}
+#endif /* CONFIG_NET_IPv6 */
+
+/****************************************************************************
+ * Name: tcp_connhash
+ *
+ * Description:
+ *   Select the connection hash table bucket for a connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_connhash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_hash(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_hash(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_connhash_add and tcp_connhash_remove
+ *
+ * Description:
+ *   Add or remove an active connection to/from the connection hash table.
+ *   Connections are added at the end of the hash chain so that, as with
+ *   g_active_tcp_connections, the oldest matching connection is found
+ *   first.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_connhash_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **prev = &g_tcp_connhash[tcp_connhash(conn)];
+
+  while (*prev != NULL)
+    {
+      prev = &(*prev)->hnext;
+    }
+
+  conn->hnext = NULL;
+  *prev       = conn;
+}
+
+static void tcp_connhash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **prev = &g_tcp_connhash[tcp_connhash(conn)];
+
+  for (; *prev != NULL; prev = &(*prev)->hnext)
+    {
+      if (*prev == conn)
+        {
+          *prev = conn->hnext;
+          break;
+        }
+    }
+
+  conn->hnext = NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_setlport
+ *
+ * Description:
+ *   Set the local port number (network byte order) of a connection and
+ *   keep the port hash table consistent.  A port number of zero removes the
+ *   connection from the port hash table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_setlport(FAR struct tcp_conn_s *conn, uint16_t portno)
+{
+  FAR struct tcp_conn_s **prev;
+
+  if (conn->lport != 0)
+    {
+      for (prev = &g_tcp_porthash[TCP_PORTHASH(conn->lport)];
+           *prev != NULL;
+           prev = &(*prev)->pnext)
+        {
+          if (*prev == conn)
+            {
+              *prev = conn->pnext;
+              break;
+            }
+        }
+    }
+
+  conn->pnext = NULL;
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      for (prev = &g_tcp_porthash[TCP_PORTHASH(portno)];
+           *prev != NULL;
+           prev = &(*prev)->pnext);
+
+      *prev = conn;
+    }
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -113,14 +298,15 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
-  /* Check if this port number is in use by any active UIP TCP connection */
+  /* Check if this port number is in use by any active UIP TCP connection.
+   * Only connections bound to this port number can be in its hash chain.
+   */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = g_tcp_porthash[TCP_PORTHASH(portno)];
+       conn != NULL;
+       conn = conn->pnext)
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -164,14 +350,15 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
-  /* Check if this port number is in use by any active UIP TCP connection */
+  /* Check if this port number is in use by any active UIP TCP connection.
+   * Only connections bound to this port number can be in its hash chain.
+   */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = g_tcp_porthash[TCP_PORTHASH(portno)];
+       conn != NULL;
+       conn = conn->pnext)
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -327,10 +514,16 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
+  /* Only connections with this remote address and these port numbers can
+   * be in the selected hash chain.
+   */
+
+  conn = g_tcp_connhash[tcp_ipv4_hash(srcipaddr, tcp->destport,
+                                      tcp->srcport)];
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -364,9 +557,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = conn->hnext;
     }
 
   return conn;
@@ -394,10 +587,16 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
+  /* Only connections with this remote address and these port numbers can
+   * be in the selected hash chain.
+   */
+
+  conn = g_tcp_connhash[tcp_ipv6_hash(*srcipaddr, tcp->destport,
+                                      tcp->srcport)];
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -431,9 +630,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = conn->hnext;
     }
 
   return conn;
@@ -474,12 +673,13 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 
   /* Find the device that can receive packets on the network associated with
@@ -495,8 +695,9 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv4addr_copy(conn->u.ipv4.laddr, INADDR_ANY);
+      net_unlock();
       return ret;
     }
 
@@ -541,12 +742,13 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 
   /* Find the device that can receive packets on the network
@@ -562,8 +764,9 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv6addr_copy(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
+      net_unlock();
       return ret;
     }
 
@@ -589,21 +792,33 @@ void tcp_initialize(void)
 {
   int i;
 
-  /* Initialize the queues */
+  /* Initialize the active connection list */
 
-  dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+  /* And the connection and port hash tables */
+
+  for (i = 0; i < CONFIG_NET_TCP_HASHSIZE; i++)
+    {
+      g_tcp_connhash[i] = NULL;
+      g_tcp_porthash[i] = NULL;
+    }
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
     {
-      /* Mark the connection closed and move it to the free list */
+      /* Mark the connection closed */
 
       g_tcp_connections[i].tcpstateflags = TCP_CLOSED;
-      dq_addlast(&g_tcp_connections[i].node, &g_free_tcp_connections);
     }
 
+  /* And put all of them into the pool of free connections */
+
+  (void)mempool_initialize(&g_tcp_connpool, "tcp", g_tcp_connections,
+                           sizeof(struct tcp_conn_s), CONFIG_NET_TCP_CONNS,
+                           0, 0);
+
   g_last_tcp_port = 1024;
 }
 
@@ -624,14 +839,14 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
   /* Because this routine is called from both event processing (with the
    * network locked) and and from user level.  Make sure that the network
-   * locked in any cased while accessing g_free_tcp_connections[];
+   * locked in any cased while accessing g_tcp_connpool;
    */
 
   net_lock();
 
-  /* Return the entry from the head of the free list */
+  /* Take a connection from the pool of free connections */
 
-  conn = (FAR struct tcp_conn_s *)dq_remfirst(&g_free_tcp_connections);
+  conn = (FAR struct tcp_conn_s *)mempool_alloc(&g_tcp_connpool);
 
 #ifndef CONFIG_NET_SOLINGER
   /* Is the free list empty? */
@@ -701,8 +916,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
           /* Now there is guaranteed to be one free connection.  Get it! */
 
-          conn = (FAR struct tcp_conn_s *)
-            dq_remfirst(&g_free_tcp_connections);
+          conn = (FAR struct tcp_conn_s *)mempool_alloc(&g_tcp_connpool);
         }
     }
 #endif
@@ -723,6 +937,15 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->keepidle      = 2 * DSEC_PER_HOUR;
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
+#endif
+#ifdef CONFIG_NET_TCP_READAHEAD
+      net_connlock_init(&conn->ralock);
+      conn->rcv_bufs      = CONFIG_NET_TCP_RCVBUF;
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      conn->snd_bufs      = CONFIG_NET_TCP_SNDBUF;
+      (void)nxsem_init(&conn->snd_sem, 0, 0);
+      (void)nxsem_setprotocol(&conn->snd_sem, SEM_PRIO_NONE);
 #endif
     }
 
@@ -746,7 +969,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   FAR struct tcp_wrbuffer_s *wrbuffer;
 #endif
 
-  /* Because g_free_tcp_connections is accessed from user level and event
+  /* Because g_tcp_connpool is accessed from user level and event
    * processing logic, it is necessary to keep the network locked during this
    * operation.
    */
@@ -770,15 +993,27 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
   if (conn->tcpstateflags != TCP_ALLOCATED)
     {
-      /* Remove the connection from the active list */
+      /* Remove the connection from the active list and from the
+       * connection hash table.
+       */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_connhash_remove(conn);
     }
 
+  /* Release the local port number */
+
+  tcp_setlport(conn, 0);
+
 #ifdef CONFIG_NET_TCP_READAHEAD
-  /* Release any read-ahead buffers attached to the connection */
+  /* Release any read-ahead buffers attached to the connection.  There can
+   * be no other user of the connection now, so the read-ahead lock is not
+   * needed.
+   */
 
   iob_free_queue(&conn->readahead, IOBUSER_NET_TCP_READAHEAD);
+  conn->rcv_queued = 0;
+  net_connlock_destroy(&conn->ralock);
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -795,6 +1030,15 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       tcp_wrbuffer_release(wrbuffer);
     }
+
+  (void)nxsem_destroy(&conn->snd_sem);
+#endif
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  /* Return the IOBs of the connection to the budget of TCP */
+
+  tcp_iob_rcvadjust(conn, -(int)conn->rcv_iobs);
+  tcp_iob_sndadjust(conn, -(int)conn->snd_iobs);
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -815,10 +1059,10 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     }
 #endif
 
-  /* Mark the connection available and put it into the free list */
+  /* Mark the connection available and return it to the pool */
 
   conn->tcpstateflags = TCP_CLOSED;
-  dq_addlast(&conn->node, &g_free_tcp_connections);
+  mempool_free(&g_tcp_connpool, conn);
   net_unlock();
 }
 
@@ -1003,7 +1247,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->sa            = 0;
       conn->sv            = 4;
       conn->nrtx          = 0;
-      conn->lport         = tcp->destport;
+      tcp_setlport(conn, tcp->destport);
       conn->rport         = tcp->srcport;
       conn->tcpstateflags = TCP_SYN_RCVD;
 
@@ -1033,11 +1277,13 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       sq_init(&conn->unacked_q);
 #endif
 
-      /* And, finally, put the connection structure into the active list.
-       * Interrupts should already be disabled in this context.
+      /* And, finally, put the connection structure into the active list
+       * and the connection hash table.  Interrupts should already be
+       * disabled in this context.
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_connhash_add(conn);
     }
 
   return conn;
@@ -1249,7 +1495,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
-  conn->lport      = htons((uint16_t)port);
+  tcp_setlport(conn, htons((uint16_t)port));
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -1270,9 +1516,12 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   sq_init(&conn->unacked_q);
 #endif
 
-  /* And, finally, put the connection structure into the active list. */
+  /* And, finally, put the connection structure into the active list and
+   * the connection hash table.
+   */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_connhash_add(conn);
   ret = OK;
 
 errout_with_lock:
@@ -0,0 +1,332 @@
+/****************************************************************************
+ * net/tcp/tcp_gso.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_GSO)
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF    ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF    ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/* The largest IP + TCP header that may have to be replicated */
+
+#ifdef CONFIG_NET_IPv6
+#  define GSO_MAXHDRLEN (IPv6_HDRLEN + TCP_MAX_HDRLEN)
+#else
+#  define GSO_MAXHDRLEN (IPv4_HDRLEN + TCP_MAX_HDRLEN)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_complete
+ *
+ * Description:
+ *   Finish the headers of one segment of a super-segment.  The headers
+ *   were copied from the first segment so only the fields that differ
+ *   between segments are updated:  The lengths, the IPv4 ID, the sequence
+ *   number, and the checksums.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the segment
+ *   tcp    - The TCP header of the segment
+ *   seqno  - The sequence number of the segment
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void tcp_gso_complete(FAR struct net_driver_s *dev,
+                             FAR struct tcp_hdr_s *tcp, uint32_t seqno)
+{
+  tcp->seqno[0] = seqno >> 24;
+  tcp->seqno[1] = seqno >> 16;
+  tcp->seqno[2] = seqno >> 8;
+  tcp->seqno[3] = seqno;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+      uint16_t iplen = dev->d_len - IPv6_HDRLEN;
+
+      ipv6->len[0]   = (iplen >> 8);
+      ipv6->len[1]   = (iplen & 0xff);
+
+      tcp->tcpchksum = 0;
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      ipv4->len[0]   = (dev->d_len >> 8);
+      ipv4->len[1]   = (dev->d_len & 0xff);
+
+      tcp->tcpchksum = 0;
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+
+      ++g_ipid;
+      ipv4->ipid[0]  = g_ipid >> 8;
+      ipv4->ipid[1]  = g_ipid & 0xff;
+
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.sent++;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_enable
+ *
+ * Description:
+ *   Permit the next poll of a TCP connection to produce a super-segment if
+ *   the device can take one.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure that is being polled
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_gso_enable(FAR struct net_driver_s *dev)
+{
+  dev->d_gsolen  = 0;
+  dev->d_gsosegs = CONFIG_NET_TCP_GSO_MAXSEGS;
+
+#ifdef CONFIG_NET_6LOWPAN
+  /* Outgoing 6LoWPAN packets are compressed and fragmented after the poll
+   * so the IPv6 headers in d_buf cannot be re-used for further segments.
+   */
+
+  if (dev->d_lltype == NET_LL_IEEE802154 || dev->d_lltype == NET_LL_PKTRADIO)
+    {
+      dev->d_gsosegs = 0;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_gso_output
+ *
+ * Description:
+ *   Pass the packet produced by a poll of a TCP connection to the device
+ *   driver and, if the poll produced a super-segment, then build and pass
+ *   each of the remaining segments as well.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure that is being polled
+ *   conn     - The TCP connection that was polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback.  Nonzero
+ *   means that the driver cannot accept more packets.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+int tcp_gso_output(FAR struct net_driver_s *dev,
+                   FAR struct tcp_conn_s *conn,
+                   devif_poll_callback_t callback)
+{
+  uint8_t hdr[GSO_MAXHDRLEN];
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int remaining;
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+  unsigned int sndlen;
+  uint32_t seqno;
+  bool ipv6;
+  int bstop;
+
+  /* No more super-segments until the next connection is polled */
+
+  dev->d_gsosegs = 0;
+
+  if (dev->d_gsolen == 0)
+    {
+      /* Nothing beyond the packet in d_buf (if any) */
+
+      return callback(dev);
+    }
+
+  /* Save the IP and TCP headers of the first segment.  The driver will
+   * add its link layer header in d_buf and may even replace d_buf with a
+   * different buffer before it returns.
+   */
+
+  ipv6     = IFF_IS_IPv6(dev->d_flags);
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  iphdrlen = ipv6 ? IPv6_HDRLEN : IPv4_HDRLEN;
+#elif defined(CONFIG_NET_IPv6)
+  iphdrlen = IPv6_HDRLEN;
+#else
+  iphdrlen = IPv4_HDRLEN;
+#endif
+  tcp      = (FAR struct tcp_hdr_s *)
+             &dev->d_buf[NET_LL_HDRLEN(dev) + iphdrlen];
+  hdrlen   = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+
+  DEBUGASSERT(hdrlen <= GSO_MAXHDRLEN);
+  memcpy(hdr, &dev->d_buf[NET_LL_HDRLEN(dev)], hdrlen);
+
+  /* Send the first segment.  A driver that can segment in hardware will
+   * also send the remainder of the payload and then clear d_gsolen.
+   */
+
+  remaining = dev->d_gsolen;
+  bstop     = callback(dev);
+
+  if (IFF_IS_TSO(dev->d_flags) && dev->d_gsolen == 0)
+    {
+      /* The driver sent the whole super-segment.  Account for the part of
+       * the payload that it segmented itself.
+       */
+
+      ninfo("TSO: %u bytes segmented by the driver\n", remaining);
+      (void)tcp_gso_advance(conn, remaining);
+    }
+
+  /* Then build each remaining segment from the saved headers and the next
+   * slice of the write buffer until the super-segment is exhausted or the
+   * driver can take no more.  Any data that is not sent is left in the
+   * write buffer for the next poll.
+   */
+
+  while (bstop == 0 && dev->d_gsolen > 0)
+    {
+      sndlen = dev->d_gsolen;
+      if (sndlen > dev->d_gsosize)
+        {
+          sndlen = dev->d_gsosize;
+        }
+
+      if (ipv6)
+        {
+          IFF_SET_IPv6(dev->d_flags);
+        }
+      else
+        {
+          IFF_SET_IPv4(dev->d_flags);
+        }
+
+      memcpy(&dev->d_buf[NET_LL_HDRLEN(dev)], hdr, hdrlen);
+      tcp = (FAR struct tcp_hdr_s *)
+            &dev->d_buf[NET_LL_HDRLEN(dev) + iphdrlen];
+
+      /* Copy (and sum) the payload of the segment directly behind the
+       * headers.
+       */
+
+      dev->d_appdata = &dev->d_buf[NET_LL_HDRLEN(dev) + hdrlen];
+      devif_iob_send(dev, dev->d_gsoiob, sndlen, dev->d_gsooffset);
+
+      seqno          = tcp_gso_advance(conn, sndlen);
+      dev->d_len     = hdrlen + sndlen;
+      tcp_gso_complete(dev, tcp, seqno);
+      dev->d_sndlen  = 0;
+
+      dev->d_gsooffset += sndlen;
+      dev->d_gsolen    -= sndlen;
+
+      bstop = callback(dev);
+    }
+
+  dev->d_gsolen = 0;
+  dev->d_gsoiob = NULL;
+  return bstop;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_GSO */
@@ -72,6 +72,122 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parse_option
+ *
+ * Description:
+ *   Parse the options of an incoming TCP segment.  The MSS, window scale
+ *   and SACK permitted options are only honored in a SYN segment; SACK
+ *   blocks are only honored outside of a SYN segment and if SACK was
+ *   negotiated.
+ *
+ * Input Parameters:
+ *   dev   - The device driver structure containing the received TCP packet.
+ *   conn  - The TCP connection that the segment is for
+ *   iplen - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_parse_option(FAR struct net_driver_s *dev,
+                             FAR struct tcp_conn_s *conn,
+                             unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp;
+  FAR uint8_t *options;
+  unsigned int optlen;
+  unsigned int i;
+  uint16_t tmp16;
+  uint8_t opt;
+  bool syn;
+
+  tcp     = (FAR struct tcp_hdr_s *)&dev->d_buf[iplen + NET_LL_HDRLEN(dev)];
+  options = &dev->d_buf[iplen + NET_LL_HDRLEN(dev) + TCP_HDRLEN];
+  optlen  = ((tcp->tcpoffset >> 4) - 5) << 2;
+  syn     = (tcp->flags & TCP_SYN) != 0;
+
+  if ((tcp->tcpoffset & 0xf0) <= 0x50)
+    {
+      /* No options */
+
+      return;
+    }
+
+  for (i = 0; i < optlen; )
+    {
+      opt = options[i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          ++i;
+          continue;
+        }
+
+      /* All other options have a length field, so that we easily can skip
+       * past them.  If the length field is zero or runs past the end of the
+       * header, the options are malformed and we don't process them
+       * further.
+       */
+
+      if (i + 1 >= optlen || options[i + 1] < 2 ||
+          i + options[i + 1] > optlen)
+        {
+          break;
+        }
+
+      if (syn && opt == TCP_OPT_MSS && options[i + 1] == TCP_OPT_MSS_LEN)
+        {
+          uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+          /* An MSS option with the right option length. */
+
+          tmp16 = ((uint16_t)options[i + 2] << 8) |
+                   (uint16_t)options[i + 3];
+          conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+        }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      else if (syn && opt == TCP_OPT_WS && options[i + 1] == TCP_OPT_WS_LEN)
+        {
+          /* The peer will scale the windows that it advertises */
+
+          conn->wscale    = true;
+          conn->snd_scale = options[i + 2] > TCP_MAX_WS ?
+                            TCP_MAX_WS : options[i + 2];
+        }
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+      else if (syn && opt == TCP_OPT_SACK_PERM &&
+               options[i + 1] == TCP_OPT_SACK_PERM_LEN)
+        {
+          /* The peer will report the segments that it received out of
+           * order.
+           */
+
+          conn->cc.flags |= TCP_CC_SACKOK;
+        }
+      else if (!syn && opt == TCP_OPT_SACK &&
+               (conn->cc.flags & TCP_CC_SACKOK) != 0)
+        {
+          tcp_sack_input(conn, &options[i + 2], options[i + 1] - 2);
+        }
+#endif
+
+      i += options[i + 1];
+    }
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -97,13 +213,13 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   FAR struct tcp_hdr_s *tcp;
   FAR struct tcp_conn_s *conn = NULL;
   unsigned int tcpiplen;
-  unsigned int hdrlen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
+#ifdef CONFIG_NET_TCP_CC
+  uint32_t winsize;
+#endif
   int      len;
-  int      i;
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -127,10 +243,6 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   tcpiplen = iplen + TCP_HDRLEN;
 
-  /* Get the size of the link layer header, the IP header, and the TCP header */
-
-  hdrlen = tcpiplen + NET_LL_HDRLEN(dev);
-
   /* Start of TCP input header processing code. */
 
   if (tcp_chksum(dev) != 0xffff)
@@ -239,59 +351,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP options, if present. */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we
-                       * easily can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are
-                           * malformed and we don't process them further.
-                           */
-
-                          break;
-                        }
-
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_parse_option(dev, conn, iplen);
 
           /* Our response will be a SYNACK. */
 
@@ -325,8 +387,20 @@ found:
 
   /* Update the connection's window size */
 
+#ifdef CONFIG_NET_TCP_CC
+  winsize       = conn->winsize;
+#endif
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window is never scaled in a SYN or SYNACK */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_scale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -534,6 +608,19 @@ found:
             tcp_getsequence(conn->sndseq), ackseq, unackseq, conn->unacked);
       tcp_setsequence(conn->sndseq, ackseq);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Let congestion control see the ACK.  A segment that carries no
+       * data, no SYN or FIN, and does not change the window may be a
+       * duplicate ACK (RFC 5681).
+       */
+
+      tcp_cc_ack(conn, ackseq,
+                 dev->d_len == 0 &&
+                 (tcp->flags & (TCP_SYN | TCP_FIN)) == 0 &&
+                 conn->winsize == winsize &&
+                 (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED);
+#endif
+
       /* Do RTT estimation, unless we have done retransmissions. */
 
       if (conn->nrtx == 0)
@@ -564,6 +651,16 @@ found:
       conn->timer = conn->rto;
     }
 
+#ifdef CONFIG_NET_TCP_SACK
+  /* Update the SACK scoreboard from the blocks reported by the peer */
+
+  if ((conn->cc.flags & TCP_CC_SACKOK) != 0 &&
+      (tcp->flags & TCP_SYN) == 0)
+    {
+      tcp_parse_option(dev, conn, iplen);
+    }
+#endif
+
   /* Do different things depending on in what state the connection is. */
 
   switch (conn->tcpstateflags & TCP_STATE_MASK)
@@ -618,6 +715,9 @@ found:
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
             conn->sndseq_max    = 0;
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn, conn->isn);
+#endif
 #endif
             conn->unacked       = 0;
             flags               = TCP_CONNECTED;
@@ -655,60 +755,9 @@ found:
         if ((flags & TCP_ACKDATA) != 0 &&
             (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP options, if present. */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_parse_option(dev, conn, iplen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -719,6 +768,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn, conn->isn);
+#endif
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -0,0 +1,274 @@
+/****************************************************************************
+ * net/tcp/tcp_iobbudget.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_IOB_BUDGET)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netstats.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of IOBs held by all TCP connections.  The read-ahead count is
+ * adjusted without the network lock, so both are protected by
+ * spin_lock_irqsave().
+ */
+
+static unsigned int g_tcp_rcviobs;
+static unsigned int g_tcp_sndiobs;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_iob_update
+ *
+ * Description:
+ *   Set the number of IOBs held by a connection and adjust the total for
+ *   TCP to match.
+ *
+ ****************************************************************************/
+
+static void tcp_iob_update(FAR uint16_t *held, FAR unsigned int *total,
+                           unsigned int niobs)
+{
+  irqstate_t flags;
+
+  flags  = spin_lock_irqsave();
+  *total = *total - *held + niobs;
+  *held  = niobs;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rcviobs = g_tcp_rcviobs;
+  g_netstats.tcp.sndiobs = g_tcp_sndiobs;
+#endif
+
+  spin_unlock_irqrestore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_iob_chainlen
+ *
+ * Description:
+ *   Return the number of IOBs in an I/O buffer chain.
+ *
+ ****************************************************************************/
+
+unsigned int tcp_iob_chainlen(FAR struct iob_s *iob)
+{
+  unsigned int niobs = 0;
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      niobs++;
+    }
+
+  return niobs;
+}
+
+/****************************************************************************
+ * Name: tcp_iob_rcvadjust
+ *
+ * Description:
+ *   Adjust the number of IOBs that a connection holds for read-ahead data,
+ *   and the total for TCP, by the number of IOBs just added to or removed
+ *   from its read-ahead queue.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   niobs - The number of IOBs added (positive) or removed (negative)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the read-ahead lock of the connection held.  The network
+ *   need not be locked.
+ *
+ ****************************************************************************/
+
+void tcp_iob_rcvadjust(FAR struct tcp_conn_s *conn, int niobs)
+{
+  DEBUGASSERT(conn != NULL && (int)conn->rcv_iobs + niobs >= 0);
+
+  if (niobs != 0)
+    {
+      tcp_iob_update(&conn->rcv_iobs, &g_tcp_rcviobs,
+                     (unsigned int)((int)conn->rcv_iobs + niobs));
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_iob_trimcount
+ *
+ * Description:
+ *   Return the number of IOBs that iob_trimhead() will free when trimming
+ *   trimlen bytes from the head of an I/O buffer chain.  Only the IOBs to
+ *   be freed are visited.
+ *
+ ****************************************************************************/
+
+unsigned int tcp_iob_trimcount(FAR struct iob_s *iob, unsigned int trimlen)
+{
+  unsigned int niobs = 0;
+
+  /* iob_trimhead() always keeps the last IOB of the chain */
+
+  for (; trimlen > 0 && iob != NULL && iob->io_flink != NULL &&
+         iob->io_len <= trimlen;
+       iob = iob->io_flink)
+    {
+      trimlen -= iob->io_len;
+      niobs++;
+    }
+
+  return niobs;
+}
+
+/****************************************************************************
+ * Name: tcp_iob_sndadjust
+ *
+ * Description:
+ *   Adjust the number of IOBs that a connection holds in its write
+ *   buffers, and the total for TCP, by the number of IOBs just queued or
+ *   freed.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   niobs - The number of IOBs queued (positive) or freed (negative)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_iob_sndadjust(FAR struct tcp_conn_s *conn, int niobs)
+{
+  DEBUGASSERT(conn != NULL && (int)conn->snd_iobs + niobs >= 0);
+
+  if (niobs != 0)
+    {
+      tcp_iob_update(&conn->snd_iobs, &g_tcp_sndiobs,
+                     (unsigned int)((int)conn->snd_iobs + niobs));
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_iob_space
+ *
+ * Description:
+ *   Return the number of additional IOBs that a connection may take for
+ *   read-ahead data or for write buffers without exceeding its quota or
+ *   the limit for TCP.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   rcv  - True: Read-ahead data; false: Write buffers
+ *
+ * Returned Value:
+ *   The number of IOBs that may be taken.  Zero if the budget is exhausted.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+unsigned int tcp_iob_space(FAR struct tcp_conn_s *conn, bool rcv)
+{
+#if CONFIG_NET_TCP_IOB_QUOTA > 0 || CONFIG_NET_TCP_IOB_LIMIT > 0
+  unsigned int held  = rcv ? conn->rcv_iobs : conn->snd_iobs;
+#endif
+  unsigned int space = CONFIG_IOB_NBUFFERS;
+#if CONFIG_NET_TCP_IOB_LIMIT > 0
+  unsigned int total = g_tcp_rcviobs + g_tcp_sndiobs;
+  unsigned int share;
+#endif
+
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+  /* The quota of the connection */
+
+  space = held < CONFIG_NET_TCP_IOB_QUOTA ?
+          CONFIG_NET_TCP_IOB_QUOTA - held : 0;
+#endif
+
+#if CONFIG_NET_TCP_IOB_LIMIT > 0
+  /* What is left of the limit for TCP.  But the connection may always
+   * have its reserved minimum, even if the limit has been reached.
+   */
+
+  share = total < CONFIG_NET_TCP_IOB_LIMIT ?
+          CONFIG_NET_TCP_IOB_LIMIT - total : 0;
+
+  if (held < CONFIG_NET_TCP_IOB_MINIMUM &&
+      share < CONFIG_NET_TCP_IOB_MINIMUM - held)
+    {
+      share = CONFIG_NET_TCP_IOB_MINIMUM - held;
+    }
+
+  if (space > share)
+    {
+      space = share;
+    }
+#endif
+
+  return space;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_IOB_BUDGET */
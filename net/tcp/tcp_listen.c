@@ -54,13 +54,29 @@
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Select the listener hash table bucket for a port number */
+
+#define TCP_LISTENHASH(p) ((unsigned int)(p) % CONFIG_NET_TCP_HASHSIZE)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* The tcp_listenhash table holds all currently listening connections,
+ * hashed by local port number and chained through the lnext field.
+ */
+
+static FAR struct tcp_conn_s *tcp_listenhash[CONFIG_NET_TCP_HASHSIZE];
 
-static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+/* The number of listening connections.  This may not exceed
+ * CONFIG_NET_MAX_LISTENPORTS.
+ */
+
+static int tcp_nlisteners;
 
 /****************************************************************************
  * Private Functions
@@ -83,21 +99,20 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain)
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 #endif
 {
-  int ndx;
+  FAR struct tcp_conn_s *conn;
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine each listening connection in the hash chain for this port */
 
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (conn = tcp_listenhash[TCP_LISTENHASH(portno)];
+       conn != NULL;
+       conn = conn->lnext)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+      /* Does the connection have the same local port number? */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
+      if (conn->lport == portno && conn->domain == domain)
 #else
-      if (conn && conn->lport == portno)
+      if (conn->lport == portno)
 #endif
         {
           /* Yes.. we found a listener on this port */
@@ -130,10 +145,12 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 void tcp_listen_initialize(void)
 {
   int ndx;
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (ndx = 0; ndx < CONFIG_NET_TCP_HASHSIZE; ndx++)
     {
-      tcp_listenports[ndx] = NULL;
+      tcp_listenhash[ndx] = NULL;
     }
+
+  tcp_nlisteners = 0;
 }
 
 /****************************************************************************
@@ -149,15 +166,19 @@ void tcp_listen_initialize(void)
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR struct tcp_conn_s **prev;
   int ret = -EINVAL;
 
   net_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (prev = &tcp_listenhash[TCP_LISTENHASH(conn->lport)];
+       *prev != NULL;
+       prev = &(*prev)->lnext)
     {
-      if (tcp_listenports[ndx] == conn)
+      if (*prev == conn)
         {
-          tcp_listenports[ndx] = NULL;
+          *prev       = conn->lnext;
+          conn->lnext = NULL;
+          tcp_nlisteners--;
           ret = OK;
           break;
         }
@@ -180,7 +201,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR struct tcp_conn_s **head;
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -201,29 +222,23 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -EADDRINUSE;
     }
+  else if (tcp_nlisteners >= CONFIG_NET_MAX_LISTENPORTS)
+    {
+      /* There are already too many listening connections */
+
+      ret = -ENOBUFS;
+    }
   else
     {
       /* Otherwise, save a reference to the connection structure in the
-       * "listener" list.
+       * "listener" hash table.
        */
 
-      ret = -ENOBUFS; /* Assume failure */
-
-      /* Search all slots until an available slot is found */
-
-      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
-        {
-          /* Is the next slot available? */
-
-          if (!tcp_listenports[ndx])
-            {
-              /* Yes.. we found it */
-
-              tcp_listenports[ndx] = conn;
-              ret = OK;
-              break;
-            }
-        }
+      head        = &tcp_listenhash[TCP_LISTENHASH(conn->lport)];
+      conn->lnext = *head;
+      *head       = conn;
+      tcp_nlisteners++;
+      ret = OK;
     }
 
   net_unlock();
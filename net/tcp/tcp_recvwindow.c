@@ -63,18 +63,22 @@
  *   Calculate the TCP receive window for the specified device.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection that will advertise the window.
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The value of the TCP receive window to use.  This is the value for the
+ *   window field of the TCP header so, if window scaling is in effect, it
+ *   has already been scaled.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
 {
   uint16_t iplen;
   uint16_t mss;
-  uint16_t recvwndo;
+  uint32_t recvwndo;
 #ifdef CONFIG_NET_TCP_READAHEAD
   int  niob_avail;
   int  nqentry_avail;
@@ -158,14 +162,10 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
        */
 
       rwnd = (niob_avail * CONFIG_IOB_BUFSIZE) + mss;
-      if (rwnd > UINT16_MAX)
-        {
-          rwnd = UINT16_MAX;
-        }
 
       /* Save the new receive window size */
 
-      recvwndo = (uint16_t)rwnd;
+      recvwndo = rwnd;
     }
   else /* nqentry_avail == 0 || niob_avail == 0 */
 #endif
@@ -181,5 +181,84 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
       recvwndo = mss;
     }
 
-  return recvwndo;
+#ifdef CONFIG_NET_TCP_READAHEAD
+  /* Never advertise more than the space left in the receive buffer */
+
+  if (conn->rcv_bufs > 0)
+    {
+      uint32_t used = conn->rcv_queued;
+      uint32_t space = conn->rcv_bufs > used ? conn->rcv_bufs - used : 0;
+
+      if (recvwndo > space)
+        {
+          recvwndo = space;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  /* Nor more than the IOB budget of the connection can hold */
+
+  if (recvwndo > tcp_iob_space(conn, true) * CONFIG_IOB_BUFSIZE)
+    {
+      recvwndo = tcp_iob_space(conn, true) * CONFIG_IOB_BUFSIZE;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window is scaled in all segments except SYN and SYNACK */
+
+  if (conn->wscale &&
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_SENT &&
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_RCVD)
+    {
+      recvwndo >>= conn->rcv_scale;
+    }
+#endif
+
+  if (recvwndo > UINT16_MAX)
+    {
+      recvwndo = UINT16_MAX;
+    }
+
+  return (uint16_t)recvwndo;
+}
+
+/****************************************************************************
+ * Name: tcp_get_wscale
+ *
+ * Description:
+ *   Select the window scale shift to offer in a SYN or SYNACK:  The
+ *   smallest shift that lets the largest receive window of the connection
+ *   be advertised.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection that will advertise the window.
+ *
+ * Returned Value:
+ *   The window scale shift (0-14).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_wscale(FAR struct tcp_conn_s *conn)
+{
+  uint32_t maxwnd;
+  uint8_t shift;
+
+  /* The receive window can be no larger than the receive buffer or, if
+   * that is not limited, than the whole I/O buffer pool.
+   */
+
+  maxwnd = conn->rcv_bufs;
+  if (maxwnd == 0)
+    {
+      maxwnd = (uint32_t)CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE;
+    }
+
+  for (shift = 0; shift < TCP_MAX_WS && (maxwnd >> shift) > UINT16_MAX;
+       shift++);
+
+  return shift;
 }
+#endif
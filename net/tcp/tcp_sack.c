@@ -0,0 +1,277 @@
+/****************************************************************************
+ * net/tcp/tcp_sack.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_SACK)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_sack_prune
+ *
+ * Description:
+ *   Discard the blocks that have since been cumulatively acknowledged.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_prune(FAR struct tcp_cc_s *cc)
+{
+  int i;
+  int j;
+
+  for (i = 0, j = 0; i < cc->nsacks; i++)
+    {
+      if (TCP_SEQ_GT(cc->sacks[i].right, cc->snduna))
+        {
+          if (TCP_SEQ_LT(cc->sacks[i].left, cc->snduna))
+            {
+              cc->sacks[i].left = cc->snduna;
+            }
+
+          cc->sacks[j++] = cc->sacks[i];
+        }
+    }
+
+  cc->nsacks = j;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_add
+ *
+ * Description:
+ *   Merge one block into the scoreboard.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_add(FAR struct tcp_cc_s *cc, uint32_t left,
+                         uint32_t right)
+{
+  int lowest;
+  int i;
+
+  /* Absorb every block that overlaps or abuts the new one */
+
+  for (i = 0; i < cc->nsacks; )
+    {
+      FAR struct tcp_sack_s *sack = &cc->sacks[i];
+
+      if (TCP_SEQ_LTE(sack->left, right) && TCP_SEQ_GTE(sack->right, left))
+        {
+          if (TCP_SEQ_LT(sack->left, left))
+            {
+              left = sack->left;
+            }
+
+          if (TCP_SEQ_GT(sack->right, right))
+            {
+              right = sack->right;
+            }
+
+          cc->sacks[i] = cc->sacks[--cc->nsacks];
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (cc->nsacks < TCP_SACK_NBLOCKS)
+    {
+      i = cc->nsacks++;
+    }
+  else
+    {
+      /* The scoreboard is full.  Forget the lowest block; it is the one
+       * that is most likely to be covered by a cumulative ACK soon.
+       */
+
+      for (i = 1, lowest = 0; i < TCP_SACK_NBLOCKS; i++)
+        {
+          if (TCP_SEQ_LT(cc->sacks[i].left, cc->sacks[lowest].left))
+            {
+              lowest = i;
+            }
+        }
+
+      i = lowest;
+    }
+
+  cc->sacks[i].left  = left;
+  cc->sacks[i].right = right;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Merge the blocks of a received SACK option into the connection's SACK
+ *   scoreboard.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   opt    - The SACK option data that follows the kind and length bytes
+ *   optlen - The length of the SACK option data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR const uint8_t *opt,
+                    unsigned int optlen)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  uint32_t left;
+  uint32_t right;
+
+  for (; optlen >= 8; optlen -= 8, opt += 8)
+    {
+      left  = ((uint32_t)opt[0] << 24) | ((uint32_t)opt[1] << 16) |
+              ((uint32_t)opt[2] << 8)  |  (uint32_t)opt[3];
+      right = ((uint32_t)opt[4] << 24) | ((uint32_t)opt[5] << 16) |
+              ((uint32_t)opt[6] << 8)  |  (uint32_t)opt[7];
+
+      /* Ignore blocks that are empty, already ACKed, or beyond anything
+       * that was ever sent (RFC 2883 D-SACKs fall in the first group).
+       */
+
+      if (TCP_SEQ_LT(left, right) && TCP_SEQ_GT(left, cc->snduna) &&
+          TCP_SEQ_LTE(right, conn->sndseq_max))
+        {
+          tcp_sack_add(cc, left, right);
+        }
+    }
+
+  tcp_sack_prune(cc);
+}
+
+/****************************************************************************
+ * Name: tcp_sack_covered
+ *
+ * Description:
+ *   Check if a range of sequence numbers has been SACKed by the peer.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   start - The first sequence number of the range
+ *   end   - The sequence number following the range
+ *
+ * Returned Value:
+ *   True if the whole range has been SACKed.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+bool tcp_sack_covered(FAR struct tcp_conn_s *conn, uint32_t start,
+                      uint32_t end)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  int i;
+
+  for (i = 0; i < cc->nsacks; i++)
+    {
+      if (TCP_SEQ_LTE(cc->sacks[i].left, start) &&
+          TCP_SEQ_GTE(cc->sacks[i].right, end))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_high
+ *
+ * Description:
+ *   Return the highest sequence number SACKed by the peer.  Un-SACKed data
+ *   below this point is presumed lost.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The sequence number following the highest SACK block or, if there are
+ *   no SACK blocks, the oldest unacknowledged sequence number.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_sack_high(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  uint32_t high = cc->snduna;
+  int i;
+
+  for (i = 0; i < cc->nsacks; i++)
+    {
+      if (TCP_SEQ_GT(cc->sacks[i].right, high))
+        {
+          high = cc->sacks[i].right;
+        }
+    }
+
+  return high;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_SACK */
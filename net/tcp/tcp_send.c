@@ -360,7 +360,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     {
       /* Update the TCP received window based on I/O buffer availability */
 
-      uint16_t recvwndo = tcp_get_recvwindow(dev);
+      uint16_t recvwndo = tcp_get_recvwindow(dev, conn);
 
       /* Set the TCP Window */
 
@@ -569,8 +569,35 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack)
 {
   struct tcp_hdr_s *tcp;
+  FAR uint8_t *optdata;
+  unsigned int optlen;
   uint16_t tcp_mss;
 
+  /* Get the length of the options sent with the SYN or SYNACK */
+
+  optlen = TCP_OPT_MSS_LEN;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Offer window scaling in a SYN.  Agree to it in a SYNACK only if it was
+   * offered.
+   */
+
+  if (ack == TCP_SYN || conn->wscale)
+    {
+      conn->rcv_scale = tcp_get_wscale(conn);
+      optlen += 1 + TCP_OPT_WS_LEN;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Offer SACK in a SYN.  Agree to it in a SYNACK only if it was offered. */
+
+  if (ack == TCP_SYN || (conn->cc.flags & TCP_CC_SACKOK) != 0)
+    {
+      optlen += 2 + TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+
   /* Get values that vary with the underlying IP domain */
 
 #ifdef CONFIG_NET_IPv6
@@ -585,7 +612,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       /* Set the packet length for the TCP Maximum Segment Size */
 
-      dev->d_len  = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv6TCP_HDRLEN + optlen;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -601,7 +628,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       /* Set the packet length for the TCP Maximum Segment Size */
 
-      dev->d_len  = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv4TCP_HDRLEN + optlen;
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -611,11 +638,37 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   /* We send out the TCP Maximum Segment Size option with our ack. */
 
-  tcp->optdata[0] = TCP_OPT_MSS;
-  tcp->optdata[1] = TCP_OPT_MSS_LEN;
-  tcp->optdata[2] = tcp_mss >> 8;
-  tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optdata         = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  optdata[0]      = TCP_OPT_MSS;
+  optdata[1]      = TCP_OPT_MSS_LEN;
+  optdata[2]      = tcp_mss >> 8;
+  optdata[3]      = tcp_mss & 0xff;
+  optdata        += TCP_OPT_MSS_LEN;
+
+  /* Each further option is padded to a 32-bit boundary */
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (ack == TCP_SYN || conn->wscale)
+    {
+      optdata[0]  = TCP_OPT_NOOP;
+      optdata[1]  = TCP_OPT_WS;
+      optdata[2]  = TCP_OPT_WS_LEN;
+      optdata[3]  = conn->rcv_scale;
+      optdata    += 1 + TCP_OPT_WS_LEN;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  if (ack == TCP_SYN || (conn->cc.flags & TCP_CC_SACKOK) != 0)
+    {
+      optdata[0]  = TCP_OPT_NOOP;
+      optdata[1]  = TCP_OPT_NOOP;
+      optdata[2]  = TCP_OPT_SACK_PERM;
+      optdata[3]  = TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
@@ -64,10 +64,12 @@
 #include <arch/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/net/net.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/net.h>
 
 #include "netdev/netdev.h"
@@ -105,6 +107,13 @@
 #  define TCP_WBDUMP(msg,wrb,len,offset)
 #endif
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static inline void send_txnotify(FAR struct socket *psock,
+                                 FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -189,6 +198,153 @@ static void psock_writebuffer_notify(FAR struct tcp_conn_s *conn)
 #  define psock_writebuffer_notify(conn)
 #endif
 
+/****************************************************************************
+ * Name: psock_sndbuf_notify
+ *
+ * Description:
+ *   Wake up a sender waiting for space in the send buffer of the
+ *   connection.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void psock_sndbuf_notify(FAR struct tcp_conn_s *conn)
+{
+  int val;
+
+  if (nxsem_getvalue(&conn->snd_sem, &val) >= 0 && val < 0)
+    {
+      nxsem_post(&conn->snd_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: psock_wrbuffer_free
+ *
+ * Description:
+ *   Return a queued write buffer to the free list and its IOBs to the IOB
+ *   budget of TCP.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *   wrb      The write buffer, already removed from its queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void psock_wrbuffer_free(FAR struct tcp_conn_s *conn,
+                                       FAR struct tcp_wrbuffer_s *wrb)
+{
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  tcp_iob_sndadjust(conn, -(int)tcp_iob_chainlen(TCP_WBIOB(wrb)));
+#endif
+  tcp_wrbuffer_release(wrb);
+}
+
+/****************************************************************************
+ * Name: psock_wrbuffer_trim
+ *
+ * Description:
+ *   Trim ACKed bytes from the beginning of a write buffer and return the
+ *   IOBs that are freed to the IOB budget of TCP.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *   wrb      The write buffer
+ *   trimlen  The number of bytes to trim
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void psock_wrbuffer_trim(FAR struct tcp_conn_s *conn,
+                                       FAR struct tcp_wrbuffer_s *wrb,
+                                       unsigned int trimlen)
+{
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  tcp_iob_sndadjust(conn, -(int)tcp_iob_trimcount(TCP_WBIOB(wrb), trimlen));
+#endif
+  TCP_WBTRIM(wrb, trimlen);
+}
+
+/****************************************************************************
+ * Name: psock_sndbuf_queued
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of the connection,
+ *   sent or not.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   The number of bytes queued.
+ *
+ ****************************************************************************/
+
+static uint32_t psock_sndbuf_queued(FAR struct tcp_conn_s *conn)
+{
+  FAR sq_entry_t *entry;
+  uint32_t queued = 0;
+
+  for (entry = sq_peek(&conn->write_q); entry; entry = sq_next(entry))
+    {
+      queued += TCP_WBPKTLEN((FAR struct tcp_wrbuffer_s *)entry);
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      queued += TCP_WBPKTLEN((FAR struct tcp_wrbuffer_s *)entry);
+    }
+
+  return queued;
+}
+
+/****************************************************************************
+ * Name: psock_sndbuf_space
+ *
+ * Description:
+ *   Return the number of bytes that may still be queued on the connection
+ *   without exceeding its send buffer size or its IOB budget.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   The number of bytes that may be queued; UINT32_MAX if there is no
+ *   limit.
+ *
+ ****************************************************************************/
+
+static uint32_t psock_sndbuf_space(FAR struct tcp_conn_s *conn)
+{
+  uint32_t space = UINT32_MAX;
+
+  if (conn->snd_bufs > 0)
+    {
+      uint32_t queued = psock_sndbuf_queued(conn);
+
+      space = queued < conn->snd_bufs ? conn->snd_bufs - queued : 0;
+    }
+
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+  if (space > tcp_iob_space(conn, false) * CONFIG_IOB_BUFSIZE)
+    {
+      space = tcp_iob_space(conn, false) * CONFIG_IOB_BUFSIZE;
+    }
+#endif
+
+  return space;
+}
+
 /****************************************************************************
  * Name: psock_lost_connection
  *
@@ -225,13 +381,13 @@ static inline void psock_lost_connection(FAR struct socket *psock,
       for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
         {
           next = sq_next(entry);
-          tcp_wrbuffer_release((FAR struct tcp_wrbuffer_s *)entry);
+          psock_wrbuffer_free(conn, (FAR struct tcp_wrbuffer_s *)entry);
         }
 
       for (entry = sq_peek(&conn->write_q); entry; entry = next)
         {
           next = sq_next(entry);
-          tcp_wrbuffer_release((FAR struct tcp_wrbuffer_s *)entry);
+          psock_wrbuffer_free(conn, (FAR struct tcp_wrbuffer_s *)entry);
         }
 
       /* Reset write buffering variables */
@@ -242,6 +398,7 @@ static inline void psock_lost_connection(FAR struct socket *psock,
       /* Notify any waiters if the write buffers have been drained. */
 
       psock_writebuffer_notify(conn);
+      psock_sndbuf_notify(conn);
 
       conn->sent       = 0;
       conn->sndseq_max = 0;
@@ -291,6 +448,267 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: send_advance
+ *
+ * Description:
+ *   Account for data that has been sent from the write buffer at the head
+ *   of the write queue.  The write buffer is moved to the un-acked queue
+ *   when the last of its data has been sent.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer at the head of the write queue
+ *   sndlen - The number of bytes sent from the write buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked and conn->sndseq holds the sequence number of
+ *   the first byte sent.
+ *
+ ****************************************************************************/
+
+static void send_advance(FAR struct tcp_conn_s *conn,
+                         FAR struct tcp_wrbuffer_s *wrb, size_t sndlen)
+{
+  uint32_t predicted_seqno;
+
+  /* Remember how much data we send out now so that we know
+   * when everything has been acknowledged.  Just increment
+   * the amount of data sent. This will be needed in sequence
+   * number calculations.
+   */
+
+  conn->unacked += sndlen;
+  conn->sent    += sndlen;
+
+  /* Below prediction will become true, unless retransmission occurrence */
+
+  predicted_seqno = tcp_getsequence(conn->sndseq) + sndlen;
+
+  if ((predicted_seqno > conn->sndseq_max) ||
+      (tcp_getsequence(conn->sndseq) > predicted_seqno)) /* overflow */
+    {
+       conn->sndseq_max = predicted_seqno;
+    }
+
+  ninfo("SEND: wrb=%p nrtx=%u unacked=%u sent=%u\n",
+        wrb, TCP_WBNRTX(wrb), conn->unacked, conn->sent);
+
+  /* Increment the count of bytes sent from this write buffer */
+
+  TCP_WBSENT(wrb) += sndlen;
+
+  ninfo("SEND: wrb=%p sent=%u pktlen=%u\n",
+        wrb, TCP_WBSENT(wrb), TCP_WBPKTLEN(wrb));
+
+  /* Remove the write buffer from the write queue if the
+   * last of the data has been sent from the buffer.
+   */
+
+  DEBUGASSERT(TCP_WBSENT(wrb) <= TCP_WBPKTLEN(wrb));
+  if (TCP_WBSENT(wrb) >= TCP_WBPKTLEN(wrb))
+    {
+      FAR struct tcp_wrbuffer_s *tmp;
+
+      ninfo("SEND: wrb=%p Move to unacked_q\n", wrb);
+
+      tmp = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&conn->write_q);
+      DEBUGASSERT(tmp == wrb);
+      UNUSED(tmp);
+
+      /* Put the I/O buffer chain in the un-acked queue; the
+       * segment is waiting for ACK again
+       */
+
+      psock_insert_segment(wrb, &conn->unacked_q);
+    }
+}
+
+/****************************************************************************
+ * Name: send_window
+ *
+ * Description:
+ *   Return the number of bytes that may be sent from the head of the write
+ *   queue now:  The receive window of the peer or, with congestion control,
+ *   the smaller of that and the congestion window less the data in flight.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The number of bytes that may be sent.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static uint32_t send_window(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CC
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t seqno;
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb == NULL)
+    {
+      return 0;
+    }
+
+  if (TCP_WBSEQNO(wrb) == (unsigned)-1)
+    {
+      seqno = conn->isn + conn->sent;
+    }
+  else
+    {
+      seqno = TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb);
+    }
+
+  return tcp_cc_sndwnd(conn, seqno);
+#else
+  return conn->winsize;
+#endif
+}
+
+/****************************************************************************
+ * Name: send_fastrexmit
+ *
+ * Description:
+ *   Prepare the fast retransmission of the oldest data at or after
+ *   conn->cc.rxtseq that the peer has not SACKed.  The write buffer holding
+ *   that data is moved back to the write queue and rewound so that the
+ *   normal send logic resends it on the next poll.  With SACK, only data
+ *   below the highest SACKed sequence number is presumed lost.
+ *
+ * Input Parameters:
+ *   psock - The socket structure
+ *   conn  - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static void send_fastrexmit(FAR struct socket *psock,
+                            FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cc_s *cc = &conn->cc;
+  FAR struct tcp_wrbuffer_s *wrb = NULL;
+  FAR sq_entry_t *entry;
+  uint32_t startseq;
+  uint32_t endseq;
+  uint32_t rewind;
+  bool unacked = false;
+#ifdef CONFIG_NET_TCP_SACK
+  uint32_t highseq = tcp_sack_high(conn);
+  bool hole = (cc->flags & (TCP_CC_HOLE | TCP_CC_REXMIT)) == TCP_CC_HOLE;
+#endif
+
+  /* Find the oldest sent write buffer that holds data at or after rxtseq
+   * that has not been SACKed.  The unacked_q is in sequence number order.
+   */
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb      = (FAR struct tcp_wrbuffer_s *)entry;
+      startseq = TCP_WBSEQNO(wrb);
+      endseq   = startseq + TCP_WBSENT(wrb);
+
+      if (TCP_SEQ_LT(startseq, cc->rxtseq))
+        {
+          startseq = cc->rxtseq;
+        }
+
+      if (TCP_SEQ_GTE(startseq, endseq))
+        {
+          continue;
+        }
+
+#ifdef CONFIG_NET_TCP_SACK
+      if (tcp_sack_covered(conn, startseq, endseq))
+        {
+          continue;
+        }
+#endif
+
+      unacked = true;
+      break;
+    }
+
+  if (!unacked)
+    {
+      /* Otherwise, the data may be in the partially sent head of the
+       * write_q.
+       */
+
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || TCP_WBSENT(wrb) == 0)
+        {
+          goto done;
+        }
+
+      startseq = TCP_WBSEQNO(wrb);
+      endseq   = startseq + TCP_WBSENT(wrb);
+
+      if (TCP_SEQ_LT(startseq, cc->rxtseq))
+        {
+          startseq = cc->rxtseq;
+        }
+
+      if (TCP_SEQ_GTE(startseq, endseq))
+        {
+          goto done;
+        }
+    }
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Without new evidence of loss, a hole above the highest SACK block may
+   * simply still be in flight.
+   */
+
+  if (hole && TCP_SEQ_GTE(startseq, highseq))
+    {
+      goto done;
+    }
+#endif
+
+  /* Rewind the write buffer to the first byte to be retransmitted */
+
+  rewind = endseq - startseq;
+  TCP_WBSENT(wrb) -= rewind;
+  conn->unacked    = conn->unacked > rewind ? conn->unacked - rewind : 0;
+  conn->sent       = conn->sent > rewind ? conn->sent - rewind : 0;
+
+  ninfo("FASTREXMIT: wrb=%p seqno=%u sent=%u rewind=%u\n",
+        wrb, TCP_WBSEQNO(wrb), TCP_WBSENT(wrb), rewind);
+
+  if (unacked)
+    {
+      /* Move the write buffer back into the write_q (in sequence number
+       * order) where it will be resent before any newer data.
+       */
+
+      sq_rem(&wrb->wb_node, &conn->unacked_q);
+      psock_insert_segment(wrb, &conn->write_q);
+    }
+
+  /* Retransmit each byte only once per recovery episode */
+
+  cc->rxtseq = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+  send_txnotify(psock, conn);
+
+done:
+  cc->flags &= ~(TCP_CC_REXMIT | TCP_CC_HOLE);
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -317,6 +735,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)pvconn;
   FAR struct socket *psock = (FAR struct socket *)pvpriv;
+  uint32_t sndwnd;
 
   /* The TCP socket is connected and, hence, should be bound to a device.
    * Make sure that the polling device is the one that we are bound to.
@@ -409,7 +828,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                   /* And return the write buffer to the pool of free buffers */
 
-                  tcp_wrbuffer_release(wrb);
+                  psock_wrbuffer_free(conn, wrb);
 
                   /* Notify any waiters if the write buffers have been
                    * drained.
@@ -437,7 +856,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                   ninfo("ACK: wrb=%p trim %u bytes\n", wrb, trimlen);
 
-                  TCP_WBTRIM(wrb, trimlen);
+                  psock_wrbuffer_trim(conn, wrb, trimlen);
                   TCP_WBSEQNO(wrb) = ackno;
                   TCP_WBSENT(wrb) -= trimlen;
 
@@ -474,13 +893,26 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
           /* Trim the ACKed bytes from the beginning of the write buffer. */
 
-          TCP_WBTRIM(wrb, nacked);
+          psock_wrbuffer_trim(conn, wrb, nacked);
           TCP_WBSEQNO(wrb) = ackno;
           TCP_WBSENT(wrb) -= nacked;
 
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+      /* ACKed data may have made room in the send buffer */
+
+      psock_sndbuf_notify(conn);
+
+#ifdef CONFIG_NET_TCP_CC
+      /* Has congestion control detected a loss? */
+
+      if ((conn->cc.flags & (TCP_CC_REXMIT | TCP_CC_HOLE)) != 0)
+        {
+          send_fastrexmit(psock, conn);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -516,6 +948,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Collapse the congestion window and start over in slow start */
+
+      tcp_cc_timeout(conn);
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -570,7 +1008,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
               /* And return the write buffer to the free list */
 
-              tcp_wrbuffer_release(wrb);
+              psock_wrbuffer_free(conn, wrb);
 
               /* Notify any waiters if the write buffers have been
                * drained.
@@ -634,7 +1072,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
               /* Return the write buffer to the free list */
 
-              tcp_wrbuffer_release(wrb);
+              psock_wrbuffer_free(conn, wrb);
 
               /* Notify any waiters if the write buffers have been
                * drained.
@@ -666,6 +1104,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               psock_insert_segment(wrb, &conn->write_q);
             }
         }
+
     }
 
   /* Check if the outgoing packet is available (it may have been claimed
@@ -687,14 +1126,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
    * will have to wait for the next polling cycle.
    */
 
+  sndwnd = send_window(conn);
+
   if ((conn->tcpstateflags & TCP_ESTABLISHED) &&
       (flags & (TCP_POLL | TCP_REXMIT)) &&
       !(sq_empty(&conn->write_q)) &&
-      conn->winsize > 0)
+      sndwnd > 0)
     {
       FAR struct tcp_wrbuffer_s *wrb;
-      uint32_t predicted_seqno;
       size_t sndlen;
+#ifdef CONFIG_NET_TCP_GSO
+      size_t maxlen;
+#endif
 
       /* Peek at the head of the write queue (but don't remove anything
        * from the write queue yet).  We know from the above test that
@@ -711,20 +1154,38 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
        */
 
       sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
+
+#ifdef CONFIG_NET_TCP_GSO
+      /* If the device will take a super-segment, then we may send up to
+       * d_gsosegs full-sized segments from the write buffer at once.
+       */
+
+      maxlen = conn->mss;
+      if (dev->d_gsosegs > 1)
+        {
+          maxlen *= dev->d_gsosegs;
+        }
+
+      if (sndlen > maxlen)
+        {
+          sndlen = maxlen;
+        }
+#else
       if (sndlen > conn->mss)
         {
           sndlen = conn->mss;
         }
+#endif
 
-      if (sndlen > conn->winsize)
+      if (sndlen > sndwnd)
         {
-          sndlen = conn->winsize;
+          sndlen = sndwnd;
         }
 
       ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u mss=%u "
-            "winsize=%u\n",
+            "winsize=%u sndwnd=%u\n",
             wrb, TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb), sndlen, conn->mss,
-            conn->winsize);
+            conn->winsize, sndwnd);
 
       /* Set the sequence number for this segment.  If we are
        * retransmitting, then the sequence number will already
@@ -759,58 +1220,29 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
        * won't actually happen until the polling cycle completes).
        */
 
-      devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
-
-      /* Remember how much data we send out now so that we know
-       * when everything has been acknowledged.  Just increment
-       * the amount of data sent. This will be needed in sequence
-       * number calculations.
-       */
-
-      conn->unacked += sndlen;
-      conn->sent    += sndlen;
-
-      /* Below prediction will become true, unless retransmission occurrence */
-
-      predicted_seqno = tcp_getsequence(conn->sndseq) + sndlen;
-
-      if ((predicted_seqno > conn->sndseq_max) ||
-          (tcp_getsequence(conn->sndseq) > predicted_seqno)) /* overflow */
+#ifdef CONFIG_NET_TCP_GSO
+      if (sndlen > conn->mss)
         {
-           conn->sndseq_max = predicted_seqno;
-        }
-
-      ninfo("SEND: wrb=%p nrtx=%u unacked=%u sent=%u\n",
-            wrb, TCP_WBNRTX(wrb), conn->unacked, conn->sent);
-
-      /* Increment the count of bytes sent from this write buffer */
-
-      TCP_WBSENT(wrb) += sndlen;
-
-      ninfo("SEND: wrb=%p sent=%u pktlen=%u\n",
-            wrb, TCP_WBSENT(wrb), TCP_WBPKTLEN(wrb));
-
-      /* Remove the write buffer from the write queue if the
-       * last of the data has been sent from the buffer.
-       */
+          /* Only the first segment goes into d_buf now.  The remainder is
+           * left in the write buffer to be sliced into further segments by
+           * tcp_gso_output() once this segment has been passed to the
+           * driver.
+           */
 
-      DEBUGASSERT(TCP_WBSENT(wrb) <= TCP_WBPKTLEN(wrb));
-      if (TCP_WBSENT(wrb) >= TCP_WBPKTLEN(wrb))
-        {
-          FAR struct tcp_wrbuffer_s *tmp;
+          dev->d_gsoiob    = TCP_WBIOB(wrb);
+          dev->d_gsooffset = TCP_WBSENT(wrb) + conn->mss;
+          dev->d_gsolen    = sndlen - conn->mss;
+          dev->d_gsosize   = conn->mss;
 
-          ninfo("SEND: wrb=%p Move to unacked_q\n", wrb);
+          sndlen           = conn->mss;
+        }
+#endif
 
-          tmp = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&conn->write_q);
-          DEBUGASSERT(tmp == wrb);
-          UNUSED(tmp);
+      devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
 
-          /* Put the I/O buffer chain in the un-acked queue; the
-           * segment is waiting for ACK again
-           */
+      /* Account for the data sent from the write buffer */
 
-          psock_insert_segment(wrb, &conn->unacked_q);
-        }
+      send_advance(conn, wrb, sndlen);
 
       /* Only one data can be sent by low level driver at once,
        * tell the caller stop polling the other connection.
@@ -1000,11 +1432,57 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+      net_lock();
+
+      /* Wait until the data queued on the connection is below the send
+       * buffer size and the IOB budget.  A blocking send may then queue
+       * all of its data; a non-blocking send queues only as much as fits.
+       */
+
+      for (; ; )
+        {
+          uint32_t space = psock_sndbuf_space(conn);
+
+          if (space > 0)
+            {
+              if (_SS_ISNONBLOCK(psock->s_flags) && len > space)
+                {
+                  len = space;
+                }
+
+              break;
+            }
+
+#if defined(CONFIG_NET_TCP_IOB_BUDGET) && defined(CONFIG_NET_STATISTICS)
+          if (tcp_iob_space(conn, false) == 0)
+            {
+              g_netstats.tcp.iobwait++;
+            }
+#endif
+
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = -EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = net_lockedwait(&conn->snd_sem);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+
+          if (!_SS_ISCONNECTED(psock->s_flags))
+            {
+              ret = -ENOTCONN;
+              goto errout_with_lock;
+            }
+        }
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           wrb = tcp_wrbuffer_tryalloc();
@@ -1118,6 +1596,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             wrb, TCP_WBPKTLEN(wrb),
             conn->write_q.head, conn->write_q.tail);
 
+#ifdef CONFIG_NET_TCP_IOB_BUDGET
+      tcp_iob_sndadjust(conn, tcp_iob_chainlen(TCP_WBIOB(wrb)));
+#endif
+
       /* Notify the device driver of the availability of TX data */
 
       send_txnotify(psock, conn);
@@ -1216,4 +1698,45 @@ int psock_tcp_cansend(FAR struct socket *psock)
   return OK;
 }
 
+/****************************************************************************
+ * Name: tcp_gso_advance
+ *
+ * Description:
+ *   Account for one more segment of a super-segment that is being sent
+ *   from the write buffer at the head of the write queue.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection whose write buffer is being sent
+ *   len  - The size of the segment payload
+ *
+ * Returned Value:
+ *   The sequence number of the first byte of the segment.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+uint32_t tcp_gso_advance(FAR struct tcp_conn_s *conn, unsigned int len)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t seqno;
+
+  /* The remainder of a super-segment is always taken from the write buffer
+   * that the first segment was taken from.  That write buffer remains at
+   * the head of the write queue until its last byte has been sent.
+   */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+  DEBUGASSERT(wrb != NULL && TCP_WBSENT(wrb) + len <= TCP_WBPKTLEN(wrb));
+
+  seqno = TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb);
+  tcp_setsequence(conn->sndseq, seqno);
+
+  send_advance(conn, wrb, len);
+  return seqno;
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_WRITE_BUFFERS */
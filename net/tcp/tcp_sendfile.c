@@ -58,6 +58,8 @@
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -105,6 +107,12 @@ struct sendfile_s
   ssize_t            snd_sent;    /* The number of bytes sent */
   uint32_t           snd_isn;     /* Initial sequence number */
   uint32_t           snd_acked;   /* The number of bytes acked */
+  FAR const uint8_t *snd_map;     /* Memory-mapped file data (or NULL) */
+#ifdef CONFIG_NET_SENDFILE_IOB
+  FAR struct iob_s  *snd_iob;     /* File data read into I/O buffers */
+  uint32_t           snd_iobpos;  /* Position of the I/O buffer data */
+  uint32_t           snd_ioblen;  /* Amount of data in the I/O buffers */
+#endif
 #ifdef CONFIG_NET_SOCKOPTS
   clock_t            snd_time;    /* Last send time for determining timeout */
 #endif
@@ -154,6 +162,293 @@ static inline int sendfile_timeout(FAR struct sendfile_s *pstate)
 }
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/****************************************************************************
+ * Name: sendfile_map
+ *
+ * Description:
+ *   If the input file can be memory-mapped (such as a file in an XIP
+ *   ROMFS file system), then get the address of the file data so that it
+ *   can be sent (and retransmitted) directly from there.  The length of the
+ *   transfer is limited to the size of the file.
+ *
+ * Input Parameters:
+ *   pstate - send state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void sendfile_map(FAR struct sendfile_s *pstate)
+{
+  FAR void *map = NULL;
+  off_t fpos;
+  off_t fsize;
+  int ret;
+
+  ret = file_ioctl(pstate->snd_file, FIOC_MMAP,
+                   (unsigned long)((uintptr_t)&map));
+  if (ret < 0 || map == NULL)
+    {
+      return;
+    }
+
+  /* Get the file size without disturbing the file position */
+
+  fpos = file_seek(pstate->snd_file, 0, SEEK_CUR);
+  if (fpos < 0)
+    {
+      return;
+    }
+
+  fsize = file_seek(pstate->snd_file, 0, SEEK_END);
+  ret   = file_seek(pstate->snd_file, fpos, SEEK_SET);
+  if (fsize < 0 || ret < 0)
+    {
+      return;
+    }
+
+  if (pstate->snd_foffset >= fsize)
+    {
+      pstate->snd_flen = 0;
+    }
+  else if (pstate->snd_flen > fsize - pstate->snd_foffset)
+    {
+      pstate->snd_flen = fsize - pstate->snd_foffset;
+    }
+
+  pstate->snd_map = (FAR const uint8_t *)map;
+}
+
+/****************************************************************************
+ * Name: sendfile_fill
+ *
+ * Description:
+ *   Release the file data that has been acknowledged and then read more
+ *   of the file into I/O buffers, up to CONFIG_NET_SENDFILE_NIOBS buffers.
+ *   The data is sent and, if necessary, retransmitted from these buffers
+ *   so that the file is read only once and never from the network poll.
+ *
+ * Input Parameters:
+ *   pstate - send state structure
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_IOB
+static int sendfile_fill(FAR struct sendfile_s *pstate)
+{
+  FAR struct iob_s *iob;
+  FAR struct iob_s *tail;
+  uint32_t trimlen;
+  uint32_t fpos;
+  ssize_t nread;
+  int niobs;
+  int ret;
+
+  /* Release the data that has been acknowledged */
+
+  if (pstate->snd_acked > pstate->snd_iobpos)
+    {
+      trimlen = pstate->snd_acked - pstate->snd_iobpos;
+      if (trimlen >= pstate->snd_ioblen)
+        {
+          if (pstate->snd_iob != NULL)
+            {
+              iob_free_chain(pstate->snd_iob, IOBUSER_NET_TCP_SENDFILE);
+              pstate->snd_iob = NULL;
+            }
+
+          pstate->snd_ioblen = 0;
+        }
+      else
+        {
+          pstate->snd_iob     = iob_trimhead(pstate->snd_iob, trimlen,
+                                             IOBUSER_NET_TCP_SENDFILE);
+          pstate->snd_ioblen -= trimlen;
+        }
+
+      pstate->snd_iobpos = pstate->snd_acked;
+    }
+
+  /* Find the end of the I/O buffer chain */
+
+  niobs = 0;
+  tail  = NULL;
+
+  for (iob = pstate->snd_iob; iob != NULL; iob = iob->io_flink)
+    {
+      tail = iob;
+      niobs++;
+    }
+
+  fpos = pstate->snd_iobpos + pstate->snd_ioblen;
+  if (niobs >= CONFIG_NET_SENDFILE_NIOBS || fpos >= pstate->snd_flen)
+    {
+      return OK;
+    }
+
+  ret = file_seek(pstate->snd_file, pstate->snd_foffset + fpos, SEEK_SET);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to lseek: %d\n", ret);
+      return ret;
+    }
+
+  /* Then read the file into new I/O buffers added to the end of the
+   * chain.
+   */
+
+  while (niobs < CONFIG_NET_SENDFILE_NIOBS && fpos < pstate->snd_flen)
+    {
+      /* Wait for an I/O buffer only if there is nothing else to send */
+
+      if (pstate->snd_ioblen > 0)
+        {
+          iob = iob_tryalloc(false, IOBUSER_NET_TCP_SENDFILE);
+          if (iob == NULL)
+            {
+              break;
+            }
+        }
+      else
+        {
+          iob = net_ioballoc(false, IOBUSER_NET_TCP_SENDFILE);
+        }
+
+      nread = pstate->snd_flen - fpos;
+      if (nread > CONFIG_IOB_BUFSIZE)
+        {
+          nread = CONFIG_IOB_BUFSIZE;
+        }
+
+      nread = file_read(pstate->snd_file, iob->io_data, nread);
+      if (nread <= 0)
+        {
+          iob_free(iob, IOBUSER_NET_TCP_SENDFILE);
+          if (nread < 0)
+            {
+              nerr("ERROR: Failed to read from input file: %d\n",
+                   (int)nread);
+              return (int)nread;
+            }
+
+          /* The end of the file was reached early.  Send only what there
+           * is.
+           */
+
+          pstate->snd_flen = fpos;
+          break;
+        }
+
+      iob->io_len = nread;
+      if (tail == NULL)
+        {
+          pstate->snd_iob = iob;
+        }
+      else
+        {
+          tail->io_flink = iob;
+        }
+
+      tail                      = iob;
+      pstate->snd_ioblen       += nread;
+      pstate->snd_iob->io_pktlen = pstate->snd_ioblen;
+      fpos                     += nread;
+      niobs++;
+    }
+
+  return OK;
+}
+#endif /* CONFIG_NET_SENDFILE_IOB */
+
+/****************************************************************************
+ * Name: sendfile_copyout
+ *
+ * Description:
+ *   Put up to sndlen bytes of file data, starting at the position
+ *   snd_sent, into the outgoing packet.  The data comes from the memory
+ *   mapped file, from the I/O buffers filled by sendfile_fill(), or is
+ *   read from the file into the packet.
+ *
+ * Input Parameters:
+ *   dev    - The network device that will send the packet
+ *   pstate - send state structure
+ *   sndlen - The maximum amount of data to send
+ *
+ * Returned Value:
+ *   The number of bytes put into the packet.  Zero is returned if the data
+ *   has not yet been read into the I/O buffers.  A negated errno value is
+ *   returned on a failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int sendfile_copyout(FAR struct net_driver_s *dev,
+                            FAR struct sendfile_s *pstate, uint32_t sndlen)
+{
+#ifndef CONFIG_NET_SENDFILE_IOB
+  ssize_t nread;
+  int ret;
+#endif
+
+  if (pstate->snd_map != NULL)
+    {
+      devif_send(dev, &pstate->snd_map[pstate->snd_foffset +
+                                       pstate->snd_sent], sndlen);
+      return sndlen;
+    }
+
+#ifdef CONFIG_NET_SENDFILE_IOB
+  if (pstate->snd_sent < pstate->snd_iobpos ||
+      pstate->snd_sent >= pstate->snd_iobpos + pstate->snd_ioblen)
+    {
+      return 0;
+    }
+
+  if (sndlen > pstate->snd_iobpos + pstate->snd_ioblen - pstate->snd_sent)
+    {
+      sndlen = pstate->snd_iobpos + pstate->snd_ioblen - pstate->snd_sent;
+    }
+
+  devif_iob_send(dev, pstate->snd_iob, sndlen,
+                 pstate->snd_sent - pstate->snd_iobpos);
+  return sndlen;
+#else
+  ret = file_seek(pstate->snd_file,
+                  pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to lseek: %d\n", ret);
+      return ret;
+    }
+
+  nread = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+  if (nread < 0)
+    {
+      nerr("ERROR: Failed to read from input file: %d\n", (int)nread);
+      return (int)nread;
+    }
+  else if (nread == 0)
+    {
+      /* The end of the file was reached early.  Send only what there is. */
+
+      pstate->snd_flen = pstate->snd_sent;
+      return 0;
+    }
+
+  dev->d_sndlen = nread;
+  return (int)nread;
+#endif
+}
+
 static uint16_t ack_eventhandler(FAR struct net_driver_s *dev,
                                  FAR void *pvconn,
                                  FAR void *pvpriv, uint16_t flags)
@@ -179,7 +474,7 @@ static uint16_t ack_eventhandler(FAR struct net_driver_s *dev,
       if (IFF_IS_IPv6(dev->d_flags))
 #endif
         {
-          DEBUGASSERT(pstate->snd_sock == PF_INET6);
+          DEBUGASSERT(pstate->snd_sock->s_domain == PF_INET6);
           tcp = TCPIPv6BUF;
         }
 #endif /* CONFIG_NET_IPv6 */
@@ -189,7 +484,7 @@ static uint16_t ack_eventhandler(FAR struct net_driver_s *dev,
       else
 #endif
         {
-          DEBUGASSERT(pstate->snd_sock == PF_INET);
+          DEBUGASSERT(pstate->snd_sock->s_domain == PF_INET);
           tcp = TCPIPv4BUF;
         }
 #endif /* CONFIG_NET_IPv4 */
@@ -355,24 +650,35 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+          ret = sendfile_copyout(dev, pstate, sndlen);
           if (ret < 0)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
               pstate->snd_sent = ret;
               goto end_wait;
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else if (ret == 0)
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
+#ifdef CONFIG_NET_SENDFILE_IOB
+              /* If everything in the I/O buffers has been sent but not
+               * yet ACKed, then the buffers cannot be refilled until the
+               * ACK arrives.  ack_eventhandler() will wake up the sending
+               * thread then.
+               */
+
+              if (pstate->snd_acked < pstate->snd_sent)
+                {
+                  goto wait;
+                }
+#endif
+
+              /* Wake up the sending thread to read more of the file (or
+               * to finish at the end of the file).
+               */
+
               goto end_wait;
             }
 
-          dev->d_sndlen = sndlen;
+          sndlen = ret;
 
           /* Set the sequence number for this packet.  NOTE:  The network
            * updates sndseq on recept of ACK *before* this function is
@@ -586,6 +892,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
 
+  /* Send directly from the file data if the file can be memory-mapped */
+
+  sendfile_map(&state);
+
   /* Allocate resources to receive a callback */
 
   state.snd_datacb = tcp_callback_alloc(conn);
@@ -622,16 +932,34 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_time         = clock_systimer();
 #endif
 
-  /* Set up the ACK callback in the connection */
-
-  state.snd_ackcb->flags = (TCP_ACKDATA | TCP_REXMIT | TCP_DISCONN_EVENTS);
-  state.snd_ackcb->priv  = (FAR void *)&state;
-  state.snd_ackcb->event = ack_eventhandler;
-
   /* Perform the TCP send operation */
 
   do
     {
+#ifdef CONFIG_NET_SENDFILE_IOB
+      /* Read the next part of the file into I/O buffers */
+
+      if (state.snd_map == NULL)
+        {
+          ret = sendfile_fill(&state);
+          if (ret < 0)
+            {
+              state.snd_sent = ret;
+              break;
+            }
+        }
+#endif
+
+      /* Set up the ACK callback in the connection.  The ACK callback
+       * disables itself after each event, so it must be set up again each
+       * time.
+       */
+
+      state.snd_ackcb->flags  = (TCP_ACKDATA | TCP_REXMIT |
+                                 TCP_DISCONN_EVENTS);
+      state.snd_ackcb->priv   = (FAR void *)&state;
+      state.snd_ackcb->event  = ack_eventhandler;
+
       state.snd_datacb->flags = TCP_POLL;
       state.snd_datacb->priv  = (FAR void *)&state;
       state.snd_datacb->event = sendfile_eventhandler;
@@ -649,6 +977,15 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 
   tcp_callback_free(conn, state.snd_ackcb);
 
+#ifdef CONFIG_NET_SENDFILE_IOB
+  /* Free any file data that was not acknowledged */
+
+  if (state.snd_iob != NULL)
+    {
+      iob_free_chain(state.snd_iob, IOBUSER_NET_TCP_SENDFILE);
+    }
+#endif
+
 errout_datacb:
   tcp_callback_free(conn, state.snd_datacb);
 
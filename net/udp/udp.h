@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
@@ -118,6 +119,7 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+  FAR struct udp_conn_s *pnext; /* Link in the hash table of bound ports */
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -139,6 +141,9 @@ struct udp_conn_s
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_CONNLOCK
+  sem_t ralock;                   /* Protects the read-ahead queue */
+#endif
 #endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
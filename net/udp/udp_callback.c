@@ -50,6 +50,7 @@
 #include <nuttx/net/udp.h>
 
 #include "devif/devif.h"
+#include "utils/utils.h"
 #include "udp/udp.h"
 
 /****************************************************************************
@@ -226,7 +227,10 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Add the new I/O buffer chain to the tail of the read-ahead queue */
 
+  (void)net_connlock(&conn->ralock);
   ret = iob_tryadd_queue(iob, &conn->readahead);
+  net_connunlock(&conn->ralock);
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
@@ -64,6 +64,7 @@
 #include "devif/devif.h"
 #include "netdev/netdev.h"
 #include "inet/inet.h"
+#include "utils/utils.h"
 #include "udp/udp.h"
 
 /****************************************************************************
@@ -73,6 +74,16 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Number of buckets in the port hash table */
+
+#ifndef CONFIG_NET_UDP_HASHSIZE
+#  define CONFIG_NET_UDP_HASHSIZE 16
+#endif
+
+/* Select the port hash table bucket for a port number */
+
+#define UDP_PORTHASH(p) ((unsigned int)(p) % CONFIG_NET_UDP_HASHSIZE)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -90,6 +101,14 @@ static sem_t g_free_sem;
 
 static dq_queue_t g_active_udp_connections;
 
+/* All connections that are bound to a local port are also retained in a
+ * hash table keyed by the local port number.  Only the connections in the
+ * hash chain for a port number need be examined when matching an incoming
+ * packet or when checking if the port number is available.
+ */
+
+static FAR struct udp_conn_s *g_udp_porthash[CONFIG_NET_UDP_HASHSIZE];
+
 /* Last port used by a UDP connection connection. */
 
 static uint16_t g_last_udp_port;
@@ -126,6 +145,51 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 #define _udp_semgive(sem) nxsem_post(sem)
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Set the local port number (network byte order) of a connection and
+ *   keep the port hash table consistent.  A port number of zero removes the
+ *   connection from the port hash table.  Connections are added at the end
+ *   of the hash chain so that the earliest bound connection is found first.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  FAR struct udp_conn_s **prev;
+
+  if (conn->lport != 0)
+    {
+      for (prev = &g_udp_porthash[UDP_PORTHASH(conn->lport)];
+           *prev != NULL;
+           prev = &(*prev)->pnext)
+        {
+          if (*prev == conn)
+            {
+              *prev = conn->pnext;
+              break;
+            }
+        }
+    }
+
+  conn->pnext = NULL;
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      for (prev = &g_udp_porthash[UDP_PORTHASH(portno)];
+           *prev != NULL;
+           prev = &(*prev)->pnext);
+
+      *prev = conn;
+    }
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -142,14 +206,13 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             uint16_t portno)
 {
   FAR struct udp_conn_s *conn;
-  int i;
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure bound to this port number. */
 
-  for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
+  for (conn = g_udp_porthash[UDP_PORTHASH(portno)];
+       conn != NULL;
+       conn = conn->pnext)
     {
-      conn = &g_udp_connections[i];
-
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -266,7 +329,11 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  /* Only connections bound to the destination port can be in its hash
+   * chain.
+   */
+
+  conn = g_udp_porthash[UDP_PORTHASH(udp->destport)];
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -377,9 +444,9 @@ static inline FAR struct udp_conn_s *
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = conn->pnext;
     }
 
   return conn;
@@ -405,7 +472,11 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  /* Only connections bound to the destination port can be in its hash
+   * chain.
+   */
+
+  conn = g_udp_porthash[UDP_PORTHASH(udp->destport)];
   while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -516,9 +587,9 @@ static inline FAR struct udp_conn_s *
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = conn->pnext;
     }
 
   return conn;
@@ -548,11 +619,17 @@ void udp_initialize(void)
   dq_init(&g_active_udp_connections);
   nxsem_init(&g_free_sem, 0, 1);
 
+  for (i = 0; i < CONFIG_NET_UDP_HASHSIZE; i++)
+    {
+      g_udp_porthash[i] = NULL;
+    }
+
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
       /* Mark the connection closed and move it to the free list */
 
       g_udp_connections[i].lport = 0;
+      g_udp_connections[i].pnext = NULL;
       dq_addlast(&g_udp_connections[i].node, &g_free_udp_connections);
     }
 
@@ -588,12 +665,16 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       conn->boundto = 0;  /* Not bound to any interface */
 #endif
       conn->lport   = 0;
+      conn->pnext   = NULL;
       conn->ttl     = IP_TTL;
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
 
       sq_init(&conn->write_q);
+#endif
+#ifdef CONFIG_NET_UDP_READAHEAD
+      net_connlock_init(&conn->ralock);
 #endif
       /* Enqueue the connection into the active list */
 
@@ -624,16 +705,25 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+
+  /* The port hash table is accessed from event processing logic */
+
+  net_lock();
+  udp_setlport(conn, 0);
+  net_unlock();
 
   /* Remove the connection from the active list */
 
   dq_rem(&conn->node, &g_active_udp_connections);
 
 #ifdef CONFIG_NET_UDP_READAHEAD
-  /* Release any read-ahead buffers attached to the connection */
+  /* Release any read-ahead buffers attached to the connection.  There can
+   * be no other user of the connection now, so the read-ahead lock is not
+   * needed.
+   */
 
   iob_free_queue(&conn->readahead, IOBUSER_NET_UDP_READAHEAD);
+  net_connlock_destroy(&conn->ralock);
 #endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
@@ -775,7 +865,9 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      net_lock();
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
+      net_unlock();
       ret         = OK;
     }
   else
@@ -790,7 +882,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
       else
@@ -843,7 +935,9 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      net_lock();
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
+      net_unlock();
     }
 
   /* Is there a remote port (rport)? */
@@ -42,8 +42,10 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <string.h>
 #include <debug.h>
 
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
@@ -58,6 +60,233 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Calculate the one's complement sum of the 16-bit words in a buffer
+ *   that begins on a 16-bit boundary.  The words are accumulated in host
+ *   byte order, a 32-bit word at a time if possible, and the carries are
+ *   folded back in only once at the end.  The one's complement sum does
+ *   not depend on byte order, so the result is just the byte-swapped
+ *   network order sum on a little-endian host.  An odd trailing byte is
+ *   padded with zero.
+ *
+ * Input Parameters:
+ *   data - Beginning of the data to include in the checksum.  This must
+ *          be 16-bit aligned.
+ *   len  - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The 16-bit one's complement sum in host byte order.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_RAWCHKSUM)
+static uint16_t chksum_native(FAR const uint8_t *data, uint16_t len)
+{
+  union
+  {
+    uint8_t  b[2];
+    uint16_t h;
+  } tail;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+  FAR const uint32_t *wptr;
+  uint64_t acc = 0;
+
+  /* Get to a 32-bit boundary */
+
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  /* Sum 32-bit words into the 64-bit accumulator.  Since len is at most
+   * 65535 bytes, the accumulator cannot overflow.
+   */
+
+  wptr = (FAR const uint32_t *)data;
+  while (len >= 16)
+    {
+      acc += wptr[0];
+      acc += wptr[1];
+      acc += wptr[2];
+      acc += wptr[3];
+      wptr += 4;
+      len  -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc += *wptr++;
+      len -= 4;
+    }
+
+  data = (FAR const uint8_t *)wptr;
+  if (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  /* Fold the 64-bit accumulator into 32 bits */
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+#else
+  FAR const uint16_t *hptr = (FAR const uint16_t *)data;
+  uint32_t acc = 0;
+
+  /* Sum 16-bit words into the 32-bit accumulator.  Since len is at most
+   * 65535 bytes, the accumulator cannot overflow.
+   */
+
+  while (len >= 8)
+    {
+      acc  += hptr[0];
+      acc  += hptr[1];
+      acc  += hptr[2];
+      acc  += hptr[3];
+      hptr += 4;
+      len  -= 8;
+    }
+
+  while (len >= 2)
+    {
+      acc += *hptr++;
+      len -= 2;
+    }
+
+  data = (FAR const uint8_t *)hptr;
+#endif
+
+  /* Add the odd trailing byte, if any, padded with a zero byte */
+
+  if (len > 0)
+    {
+      tail.b[0] = *data;
+      tail.b[1] = 0;
+      acc      += tail.h;
+    }
+
+  /* Fold the 32-bit sum into 16 bits */
+
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)acc;
+}
+#endif /* !CONFIG_NET_ARCH_CHKSUM && !CONFIG_NET_ARCH_RAWCHKSUM */
+
+/****************************************************************************
+ * Name: chksum_copy_native
+ *
+ * Description:
+ *   Copy the buffer at src to dest and return the one's complement sum of
+ *   the 16-bit words copied in host byte order, as chksum_native() does.
+ *   Both src and dest must be 16-bit aligned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_COPYCHKSUM
+static uint16_t chksum_copy_native(FAR uint8_t *dest,
+                                   FAR const uint8_t *src, uint16_t len)
+{
+  FAR const uint16_t *hsrc;
+  FAR uint16_t *hdest;
+  union
+  {
+    uint8_t  b[2];
+    uint16_t h;
+  } tail;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t acc = 0;
+
+  /* Word copies are only possible if both addresses can be brought to a
+   * 32-bit boundary together.
+   */
+
+  if ((((uintptr_t)src ^ (uintptr_t)dest) & 2) == 0)
+    {
+      FAR const uint32_t *wsrc;
+      FAR uint32_t *wdest;
+      uint32_t w0;
+      uint32_t w1;
+
+      if (((uintptr_t)src & 2) != 0 && len >= 2)
+        {
+          *(FAR uint16_t *)dest = *(FAR const uint16_t *)src;
+          acc  += *(FAR const uint16_t *)src;
+          src  += 2;
+          dest += 2;
+          len  -= 2;
+        }
+
+      wsrc  = (FAR const uint32_t *)src;
+      wdest = (FAR uint32_t *)dest;
+
+      while (len >= 8)
+        {
+          w0       = wsrc[0];
+          w1       = wsrc[1];
+          wdest[0] = w0;
+          wdest[1] = w1;
+          acc     += w0;
+          acc     += w1;
+          wsrc    += 2;
+          wdest   += 2;
+          len     -= 8;
+        }
+
+      src  = (FAR const uint8_t *)wsrc;
+      dest = (FAR uint8_t *)wdest;
+    }
+#else
+  uint32_t acc = 0;
+#endif
+
+  /* Copy and sum any remaining 16-bit words */
+
+  hsrc  = (FAR const uint16_t *)src;
+  hdest = (FAR uint16_t *)dest;
+
+  while (len >= 2)
+    {
+      *hdest++ = *hsrc;
+      acc     += *hsrc++;
+      len     -= 2;
+    }
+
+  /* Copy and add the odd trailing byte, if any, padded with a zero byte */
+
+  if (len > 0)
+    {
+      src       = (FAR const uint8_t *)hsrc;
+      dest      = (FAR uint8_t *)hdest;
+      *dest     = *src;
+      tail.b[0] = *src;
+      tail.b[1] = 0;
+      acc      += tail.h;
+    }
+
+#ifdef CONFIG_HAVE_LONG_LONG
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+#endif
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)acc;
+}
+#endif /* CONFIG_NET_COPYCHKSUM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -69,11 +298,15 @@
  *   Calculate the raw change some over the memory region described by
  *   data and len.
  *
+ *   If CONFIG_NET_ARCH_RAWCHKSUM is defined, then this function must be
+ *   provided by architecture-specific logic.
+ *
  * Input Parameters:
  *   sum  - Partial calculations carried over from a previous call to
  *          chksum().  This should be zero on the first time that check
  *          sum is called.
- *   data - Beginning of the data to include in the checksum.
+ *   data - Beginning of the data to include in the checksum.  There are
+ *          no alignment requirements.
  *   len  - Length of the data to include in the checksum.
  *
  * Returned Value:
@@ -81,45 +314,174 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_RAWCHKSUM)
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
+  uint32_t acc;
   uint16_t t;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  if (len == 0)
+    {
+      return sum;
+    }
 
-  while (dataptr < last_byte)
+  if (((uintptr_t)data & 1) == 0)
     {
-      /* At least two more bytes */
+      /* The data is 16-bit aligned.  Just convert the sum to network
+       * order.
+       */
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      t = ntohs(chksum_native(data, len));
+    }
+  else
+    {
+      /* The data is not 16-bit aligned.  Sum the data that follows the
+       * first byte, which is aligned.  In that sum, the bytes at even
+       * offsets in the original data are in the low half of each word and
+       * the bytes at odd offsets are in the high half, so the network order
+       * sum is swapped.  Swap it back and add the first byte in the high
+       * half of a word.
+       */
 
-      dataptr += 2;
+      t   = ntohs(chksum_native(data + 1, len - 1));
+      acc = ((uint32_t)data[0] << 8) + (uint16_t)((t << 8) | (t >> 8));
+      t   = (uint16_t)((acc & 0xffff) + (acc >> 16));
     }
 
-  if (dataptr == last_byte)
+  /* Add the result to the carried over sum */
+
+  acc = (uint32_t)sum + t;
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+#endif /* !CONFIG_NET_ARCH_CHKSUM && !CONFIG_NET_ARCH_RAWCHKSUM */
+
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy len bytes from src to dest and return the raw checksum of the data
+ *   copied.  The result is the same as a memcpy() followed by chksum(), but
+ *   each byte is read only once.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call.
+ *   dest - The location to copy the data to.
+ *   src  - The location to copy the data from.
+ *   len  - Length of the data to copy and include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_COPYCHKSUM
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len)
+{
+  uint32_t acc;
+  uint16_t t;
+
+  if (len == 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      return sum;
+    }
+
+  if ((((uintptr_t)src | (uintptr_t)dest) & 1) != 0)
+    {
+      /* The addresses do not permit 16-bit accesses.  Copy the data first
+       * and then sum the copy, which is now in the cache.
+       */
+
+      memcpy(dest, src, len);
+      return chksum(sum, dest, len);
+    }
+
+  t   = ntohs(chksum_copy_native(dest, src, len));
+  acc = (uint32_t)sum + t;
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+#endif /* CONFIG_NET_COPYCHKSUM */
+
+/****************************************************************************
+ * Name: chksum_iob_copyout
+ *
+ * Description:
+ *   Copy len bytes starting at offset in an I/O buffer chain into dest and
+ *   return the raw checksum of the data copied.  The buffers in the chain
+ *   may hold any number of bytes; a sum that is carried from one buffer
+ *   into the next across an odd byte boundary is handled.
+ *
+ * Input Parameters:
+ *   sum    - Partial calculations carried over from a previous call.  The
+ *            data covered by that sum must have been of even length.
+ *   dest   - The location to copy the data to.
+ *   iob    - The I/O buffer chain to copy the data from.
+ *   len    - Length of the data to copy and include in the checksum.
+ *   offset - The offset of the data in the I/O buffer chain.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_COPYCHKSUM) && defined(CONFIG_MM_IOB)
+uint16_t chksum_iob_copyout(uint16_t sum, FAR uint8_t *dest,
+                            FAR const struct iob_s *iob, unsigned int len,
+                            unsigned int offset)
+{
+  unsigned int ncopy;
+  unsigned int total = 0;
+  uint32_t acc;
+  uint16_t t;
+
+  /* Skip to the I/O buffer containing the offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  /* Then copy and sum the data in each I/O buffer */
+
+  while (iob != NULL && len > 0)
+    {
+      ncopy = iob->io_len - offset;
+      if (ncopy > len)
         {
-          sum++; /* carry */
+          ncopy = len;
         }
-    }
 
-  /* Return sum in host byte order. */
+      if ((total & 1) == 0)
+        {
+          sum = chksum_copy(sum, dest,
+                            &iob->io_data[iob->io_offset + offset], ncopy);
+        }
+      else
+        {
+          /* This data follows an odd number of bytes, so each byte that
+           * is at an even offset here is the low byte of a 16-bit word.
+           * The sum of this data is then the byte-swapped sum.  The odd
+           * byte that ended the preceding data was padded with a zero low
+           * byte, so the two sums can just be added.
+           */
+
+          t   = chksum_copy(0, dest,
+                            &iob->io_data[iob->io_offset + offset], ncopy);
+          acc = (uint32_t)sum + (uint16_t)((t << 8) | (t >> 8));
+          sum = (uint16_t)((acc & 0xffff) + (acc >> 16));
+        }
+
+      dest   += ncopy;
+      total  += ncopy;
+      len    -= ncopy;
+      iob     = iob->io_flink;
+      offset  = 0;
+    }
 
   return sum;
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif /* CONFIG_NET_COPYCHKSUM && CONFIG_MM_IOB */
 
 /****************************************************************************
  * Name: net_chksum
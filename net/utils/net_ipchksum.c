@@ -58,6 +58,66 @@
 #define IPv4BUF  ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF  ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: upperlayer_chksum
+ *
+ * Description:
+ *   Sum the protocol header and payload.  If the payload was summed when
+ *   it was copied into the packet by devif_send() or devif_iob_send(), then
+ *   only the protocol header is summed here and that payload sum is used.
+ *   The payload sum is used only once.
+ *
+ * Input Parameters:
+ *   dev      - The network driver instance.
+ *   proto    - The protocol being supported
+ *   sum      - The sum of the pseudo-header
+ *   upper    - The beginning of the protocol header
+ *   upperlen - The size of the protocol header and payload
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_COPYCHKSUM
+static uint16_t upperlayer_chksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto, uint16_t sum,
+                                  FAR uint8_t *upper, uint16_t upperlen)
+{
+  uint16_t sndlen = dev->d_sndchklen;
+  uint32_t acc;
+  uintptr_t hdrlen;
+
+  dev->d_sndchklen = 0;
+
+  /* The payload sum can be used only for TCP and UDP whose headers are an
+   * even number of bytes, and only if it covers exactly the payload
+   * following the header.
+   */
+
+  if (sndlen > 0 && sndlen == dev->d_sndlen &&
+      (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      dev->d_appdata >= upper)
+    {
+      hdrlen = dev->d_appdata - upper;
+      if ((hdrlen & 1) == 0 && hdrlen + sndlen == upperlen)
+        {
+          sum = chksum(sum, upper, (uint16_t)hdrlen);
+          acc = (uint32_t)sum + dev->d_sndchksum;
+          return (uint16_t)((acc & 0xffff) + (acc >> 16));
+        }
+    }
+
+  return chksum(sum, upper, upperlen);
+}
+#else
+#  define upperlayer_chksum(d,p,s,u,l) chksum(s,u,l)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -118,7 +178,9 @@ uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)], upperlen);
+  sum = upperlayer_chksum(dev, proto, sum,
+                          &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)],
+                          upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -185,7 +247,8 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[NET_LL_HDRLEN(dev) + iplen], upperlen);
+  sum = upperlayer_chksum(dev, proto, sum,
+                          &dev->d_buf[NET_LL_HDRLEN(dev) + iplen], upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
@@ -111,6 +112,36 @@ int net_breaklock(FAR unsigned int *count);
 
 int net_restorelock(unsigned int count);
 
+/****************************************************************************
+ * Name: net_connlock_init, net_connlock, net_connunlock, and
+ *       net_connlock_destroy
+ *
+ * Description:
+ *   Initialize, take, release, and destroy the lock that protects the
+ *   read-ahead queue of a single connection.  If the network lock is also
+ *   needed, then it must be taken before the connection lock.
+ *
+ *   If CONFIG_NET_CONNLOCK is not selected, then the read-ahead queues are
+ *   protected only by the network lock and these do nothing.
+ *
+ * Returned Value:
+ *   net_connlock() returns zero (OK) on success; a negated errno value is
+ *   returned on failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONNLOCK
+#  define net_connlock_init(l)    (void)nxsem_init(l, 0, 1)
+#  define net_connlock(l)         nxsem_wait_uninterruptible(l)
+#  define net_connunlock(l)       (void)nxsem_post(l)
+#  define net_connlock_destroy(l) (void)nxsem_destroy(l)
+#else
+#  define net_connlock_init(l)
+#  define net_connlock(l)         OK
+#  define net_connunlock(l)
+#  define net_connlock_destroy(l)
+#endif
+
 /****************************************************************************
  * Name: net_dsec2timeval
  *
@@ -238,6 +269,59 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy len bytes from src to dest and return the raw checksum of the data
+ *   copied.  The result is the same as a memcpy() followed by chksum(), but
+ *   each byte is read only once.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call.
+ *   dest - The location to copy the data to.
+ *   src  - The location to copy the data from.
+ *   len  - Length of the data to copy and include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_COPYCHKSUM
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len);
+#endif
+
+/****************************************************************************
+ * Name: chksum_iob_copyout
+ *
+ * Description:
+ *   Copy len bytes starting at offset in an I/O buffer chain into dest and
+ *   return the raw checksum of the data copied.  The buffers in the chain
+ *   may hold any number of bytes; a sum that is carried from one buffer
+ *   into the next across an odd byte boundary is handled.
+ *
+ * Input Parameters:
+ *   sum    - Partial calculations carried over from a previous call.  The
+ *            data covered by that sum must have been of even length.
+ *   dest   - The location to copy the data to.
+ *   iob    - The I/O buffer chain to copy the data from.
+ *   len    - Length of the data to copy and include in the checksum.
+ *   offset - The offset of the data in the I/O buffer chain.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_COPYCHKSUM) && defined(CONFIG_MM_IOB)
+struct iob_s; /* Forward reference */
+uint16_t chksum_iob_copyout(uint16_t sum, FAR uint8_t *dest,
+                            FAR const struct iob_s *iob, unsigned int len,
+                            unsigned int offset);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
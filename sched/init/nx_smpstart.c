@@ -163,6 +163,14 @@ int nx_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SCHED_CPUBALANCE
+      /* Pull any task that should be running on this CPU but has been
+       * left in the ready-to-run list.
+       */
+
+      sched_cpu_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -451,7 +451,9 @@ void nx_start(void)
   for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++, g_lastpid++)
 #endif
     {
+#if defined(CONFIG_SMP) || !defined(CONFIG_SCHED_READYTORUN_BITMAP)
       FAR dq_queue_t *tasklist;
+#endif
       int hashndx;
 
       /* Assign the process ID(s) of ZERO to the idle task(s) */
@@ -550,10 +552,15 @@ void nx_start(void)
 
 #ifdef CONFIG_SMP
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING, cpu);
+      dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+#elif defined(CONFIG_SCHED_READYTORUN_BITMAP)
+      /* The ready-to-run list is indexed by priority */
+
+      (void)sched_rtrbitmap_add(&g_idletcb[cpu].cmn);
 #else
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING);
-#endif
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+#endif
 
       /* Mark the idle task as the running task */
 
@@ -869,6 +876,14 @@ void nx_start(void)
         }
 #endif
 
+#ifdef CONFIG_SCHED_CPUBALANCE
+      /* Pull any task that should be running on this CPU but has been
+       * left in the ready-to-run list.
+       */
+
+      sched_cpu_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
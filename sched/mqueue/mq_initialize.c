@@ -41,6 +41,7 @@
 
 #include <stdint.h>
 #include <queue.h>
+#include <assert.h>
 #include <nuttx/kmalloc.h>
 
 #include "mqueue/mqueue.h"
@@ -61,18 +62,13 @@ struct mq_des_block_s
  * Public Data
  ****************************************************************************/
 
-/* The g_msgfree is a list of messages that are available for general
- * use.  The number of messages in this list is a system configuration
- * item.
+/* The g_msgpool memory pool holds the messages that are available for
+ * use.  The number of pre-allocated messages is a system configuration
+ * item; NUM_INTERRUPT_MSGS of these are reserved for use by interrupt
+ * handlers.
  */
 
-sq_queue_t  g_msgfree;
-
-/* The g_msgfreeInt is a list of messages that are reserved for use by
- * interrupt handlers.
- */
-
-sq_queue_t  g_msgfreeirq;
+struct mempool_s g_msgpool;
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -85,65 +81,10 @@ sq_queue_t  g_desfree;
  * Private Data
  ****************************************************************************/
 
-/* g_msgalloc is a pointer to the start of the allocated block of
- * messages.
- */
-
-static struct mqueue_msg_s  *g_msgalloc;
-
-/* g_msgfreeirqalloc is a pointer to the start of the allocated block of
- * messages.
- */
-
-static struct mqueue_msg_s  *g_msgfreeirqalloc;
-
 /* g_desalloc is a list of allocated block of message queue descriptors. */
 
 static sq_queue_t g_desalloc;
 
-/****************************************************************************
- * Private Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: mq_msgblockalloc
- *
- * Description:
- *   Allocate a block of messages and place them on the free list.
- *
- * Input Parameters:
- *  queue
- *
- ****************************************************************************/
-
-static struct mqueue_msg_s *
-mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nmsgs,
-                 uint8_t alloc_type)
-{
-  struct mqueue_msg_s *mqmsgblock;
-
-  /* The g_msgfree must be loaded at initialization time to hold the
-   * configured number of messages.
-   */
-
-  mqmsgblock = (FAR struct mqueue_msg_s *)
-    kmm_malloc(sizeof(struct mqueue_msg_s) * nmsgs);
-
-  if (mqmsgblock)
-    {
-      struct mqueue_msg_s *mqmsg = mqmsgblock;
-      int      i;
-
-      for (i = 0; i < nmsgs; i++)
-        {
-          mqmsg->type = alloc_type;
-          sq_addlast((FAR sq_entry_t *)mqmsg++, queue);
-        }
-    }
-
-  return mqmsgblock;
-}
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -166,25 +107,18 @@ mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nmsgs,
 
 void nxmq_initialize(void)
 {
-  /* Initialize the message free lists */
+  /* Initialize the message descriptor block list */
 
-  sq_init(&g_msgfree);
-  sq_init(&g_msgfreeirq);
   sq_init(&g_desalloc);
 
-  /* Allocate a block of messages for general use */
-
-  g_msgalloc =
-    mq_msgblockalloc(&g_msgfree, CONFIG_PREALLOC_MQ_MSGS,
-                     MQ_ALLOC_FIXED);
-
-  /* Allocate a block of messages for use exclusively by
-   * interrupt handlers
+  /* Allocate the pool of messages, including the messages reserved for use
+   * exclusively by interrupt handlers.
    */
 
-  g_msgfreeirqalloc =
-    mq_msgblockalloc(&g_msgfreeirq, NUM_INTERRUPT_MSGS,
-                     MQ_ALLOC_IRQ);
+  DEBUGVERIFY(mempool_initialize(&g_msgpool, "mqueue", NULL,
+                                 sizeof(struct mqueue_msg_s),
+                                 CONFIG_PREALLOC_MQ_MSGS + NUM_INTERRUPT_MSGS,
+                                 NUM_INTERRUPT_MSGS, MEMPOOL_FLAG_GROW));
 
   /* Allocate a block of message queue descriptors */
 
@@ -51,6 +51,7 @@
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/mm/mempool.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -78,19 +79,11 @@
  * Public Type Definitions
  ****************************************************************************/
 
-enum mqalloc_e
-{
-  MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
-  MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
-};
-
 /* This structure describes one buffered POSIX message. */
 
 struct mqueue_msg_s
 {
   FAR struct mqueue_msg_s *next;  /* Forward link to next message */
-  uint8_t type;                   /* (Used to manage allocations) */
   uint8_t priority;               /* priority of message */
 #if MQ_MAX_BYTES < 256
   uint8_t msglen;                 /* Message data length */
@@ -112,17 +105,13 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_msgfree is a list of messages that are available for general use.
- * The number of messages in this list is a system configuration item.
- */
-
-EXTERN sq_queue_t  g_msgfree;
-
-/* The g_msgfreeInt is a list of messages that are reserved for use by
- * interrupt handlers.
+/* The g_msgpool memory pool holds the messages that are available for
+ * use.  The number of pre-allocated messages is a system configuration
+ * item; NUM_INTERRUPT_MSGS of these are reserved for use by interrupt
+ * handlers.
  */
 
-EXTERN sq_queue_t  g_msgfreeirq;
+EXTERN struct mempool_s g_msgpool;
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -391,6 +391,40 @@ extern volatile cpu_set_t g_cpu_lockset SP_SECTION;
 
 extern volatile spinlock_t g_cpu_tasklistlock SP_SECTION;
 
+#ifdef CONFIG_SCHED_CPUBALANCE
+/* The set of CPUs that may run some task in the g_readytorun list.  This
+ * is only a hint for the IDLE loops:  A CPU is added whenever a task that
+ * may run on it enters the list, but it is removed only when
+ * sched_cpu_balance() rescans the list.  The tasklists must be locked to
+ * modify it.
+ */
+
+extern volatile cpu_set_t g_rtr_cpuset;
+
+#  define SCHED_RTR_CPUSET_ADD(t) \
+     do \
+       { \
+         g_rtr_cpuset |= (t)->affinity; \
+       } \
+     while (0)
+
+/* Count a migration if a task is about to start running on a CPU other
+ * than the one that it last ran on.  The tasklists must be locked.
+ */
+
+#  define SCHED_COUNT_MIGRATION(t, c) \
+     do \
+       { \
+         if ((t)->cpu != (c)) \
+           { \
+             g_cpu_migrations[c]++; \
+           } \
+       } \
+     while (0)
+#else
+#  define SCHED_COUNT_MIGRATION(t, c)
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_FETCHADD) && !defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
 /* This is part of the sched_lock() logic to handle atomic operations when
  * locking the scheduler.
@@ -413,6 +447,13 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
 void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                             uint8_t task_state);
 bool sched_mergepending(void);
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+bool sched_rtrbitmap_add(FAR struct tcb_s *tcb);
+void sched_rtrbitmap_remove(FAR struct tcb_s *tcb);
+void sched_remprioritized(FAR struct tcb_s *tcb, FAR dq_queue_t *list);
+#else
+#  define sched_remprioritized(t,l) dq_rem((FAR dq_entry_t *)(t), (l))
+#endif
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  nxsched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
@@ -469,9 +510,24 @@ FAR struct tcb_s *this_task(void);
 
 int  sched_cpu_select(cpu_set_t affinity);
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
+#ifdef CONFIG_SCHED_CPUBALANCE
+void sched_cpu_balance(void);
+#endif
+
+/* The tasklists are protected by nested locks.  When more than one of
+ * them is held, they must be taken in this order:
+ *
+ *   1. g_cpu_irqlock, taken by enter_critical_section().  All tasklist
+ *      changes are still made inside of a critical section.
+ *   2. sched_tasklist_lock() for g_readytorun, g_pendingtasks and
+ *      g_assignedtasks[].
+ *   3. sched_blocklist_lock() for the blocked tasklists.
+ */
 
 irqstate_t sched_tasklist_lock(void);
 void sched_tasklist_unlock(irqstate_t lock);
+irqstate_t sched_blocklist_lock(void);
+void sched_blocklist_unlock(irqstate_t lock);
 
 #if defined(CONFIG_ARCH_HAVE_FETCHADD) && !defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
 #  define sched_islocked_global() \
@@ -78,9 +78,9 @@ void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state)
               task_state <= LAST_BLOCKED_STATE);
 
 #ifdef CONFIG_SMP
-  /* Lock the tasklists before accessing */
+  /* Lock the blocked tasklists before accessing */
 
-  irqstate_t lock = sched_tasklist_lock();
+  irqstate_t lock = sched_blocklist_lock();
 #endif
 
   /* Add the TCB to the blocked task list associated with this state. */
@@ -103,9 +103,9 @@ void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state)
     }
 
 #ifdef CONFIG_SMP
-  /* Unlock the tasklists */
+  /* Unlock the blocked tasklists */
 
-  sched_tasklist_unlock(lock);
+  sched_blocklist_unlock(lock);
 #endif
 
   /* Make sure the TCB's state corresponds to the list */
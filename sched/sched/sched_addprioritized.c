@@ -87,6 +87,24 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_CPUBALANCE
+  /* Let the IDLE CPUs in its affinity set know about a ready-to-run task */
+
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      SCHED_RTR_CPUSET_ADD(tcb);
+    }
+#endif
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  /* The ready-to-run list is indexed by priority and need not be searched */
+
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      return sched_rtrbitmap_add(tcb);
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
    */
@@ -304,6 +304,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
           DEBUGASSERT(task_state == TSTATE_TASK_RUNNING);
 
+          SCHED_COUNT_MIGRATION(btcb, cpu);
           btcb->cpu        = cpu;
           btcb->task_state = TSTATE_TASK_RUNNING;
 
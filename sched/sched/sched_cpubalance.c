@@ -0,0 +1,181 @@
+/****************************************************************************
+ * sched/sched/sched_cpubalance.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The number of times that a task started running on each CPU after last
+ * running on a different CPU.  Updated with the tasklists locked.
+ */
+
+volatile uint32_t g_cpu_migrations[CONFIG_SMP_NCPUS];
+
+/* The set of CPUs that may run some task in the g_readytorun list.  See
+ * SCHED_RTR_CPUSET_ADD().
+ */
+
+volatile cpu_set_t g_rtr_cpuset;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_cpu_balance
+ *
+ * Description:
+ *   Pull a stranded task onto the calling CPU.  A task is stranded if it
+ *   waits in the g_readytorun list but has a higher priority than the task
+ *   running on this CPU and this CPU is in its affinity set.  That can
+ *   happen, for example, if this CPU became idle while the scheduler was
+ *   locked or while another CPU held the IRQ lock:  In that case the CPU
+ *   falls back to its IDLE task and nothing later reconsiders the
+ *   g_readytorun list until some other task blocks.
+ *
+ *   The stranded task is moved to the g_pendingtasks list and the normal
+ *   up_release_pending() logic then assigns it to the CPU running the
+ *   lowest priority task within its affinity set, pausing and resuming
+ *   that CPU or performing a context switch on this CPU as needed.
+ *
+ *   This is called periodically from the IDLE loop of each CPU.  The
+ *   g_rtr_cpuset hint keeps the IDLE loop out of the critical section
+ *   unless some task in g_readytorun may run on this CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_cpu_balance(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *stcb;
+  FAR struct tcb_s *tcb;
+  cpu_set_t cpuset;
+  irqstate_t flags;
+  irqstate_t lock;
+  int me;
+
+  /* Don't bother with the critical section unless it looks like there
+   * might be a task for this CPU.  These tests are not atomic and are
+   * repeated below.  A task added just after the test will be found on
+   * the next pass through the IDLE loop.
+   */
+
+  if (!CPU_ISSET(this_cpu(), &g_rtr_cpuset) || sched_islocked_global())
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  lock  = sched_tasklist_lock();
+
+  me    = this_cpu();
+  rtcb  = current_task(me);
+  stcb  = NULL;
+
+  if (!sched_islocked_global())
+    {
+      /* Find the highest priority task that may run on this CPU.  The list
+       * is prioritized so this is the first one with a matching affinity.
+       * Rebuild the hint from the affinities of the tasks that stay in the
+       * list while walking it.
+       */
+
+      cpuset = 0;
+      for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+           tcb != NULL;
+           tcb = (FAR struct tcb_s *)tcb->flink)
+        {
+          if (stcb == NULL && CPU_ISSET(me, &tcb->affinity))
+            {
+              stcb = tcb;
+            }
+          else
+            {
+              cpuset |= tcb->affinity;
+            }
+        }
+
+      if (stcb != NULL && stcb->sched_priority > rtcb->sched_priority)
+        {
+          /* Move the task to the pending task list */
+
+          sched_remprioritized(stcb, (FAR dq_queue_t *)&g_readytorun);
+          (void)sched_addprioritized(stcb, (FAR dq_queue_t *)&g_pendingtasks);
+          stcb->task_state = TSTATE_TASK_PENDING;
+        }
+      else if (stcb != NULL)
+        {
+          cpuset |= stcb->affinity;
+          stcb    = NULL;
+        }
+
+      g_rtr_cpuset = cpuset;
+    }
+
+  sched_tasklist_unlock(lock);
+
+  /* Then let the pending task logic assign it to a CPU */
+
+  if (stcb != NULL)
+    {
+      up_release_pending();
+    }
+
+  leave_critical_section(flags);
+}
@@ -90,7 +90,9 @@ bool sched_mergepending(void)
   FAR struct tcb_s *ptcb;
   FAR struct tcb_s *pnext;
   FAR struct tcb_s *rtcb;
+#ifndef CONFIG_SCHED_READYTORUN_BITMAP
   FAR struct tcb_s *rprev;
+#endif
   bool ret = false;
 
   /* Initialize the inner search loop */
@@ -105,6 +107,24 @@ bool sched_mergepending(void)
     {
       pnext = ptcb->flink;
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      /* The ready-to-run list is indexed by priority so there is no need
+       * to search for the insertion point.  rtcb tracks the head of the
+       * ready-to-run list.
+       */
+
+      if (sched_rtrbitmap_add(ptcb))
+        {
+          rtcb->task_state  = TSTATE_TASK_READYTORUN;
+          ptcb->task_state  = TSTATE_TASK_RUNNING;
+          rtcb              = ptcb;
+          ret               = true;
+        }
+      else
+        {
+          ptcb->task_state  = TSTATE_TASK_READYTORUN;
+        }
+#else
       /* REVISIT:  Why don't we just remove the ptcb from pending task list
        * and call sched_addreadytorun?
        */
@@ -155,6 +175,7 @@ bool sched_mergepending(void)
       /* Set up for the next time through */
 
       rtcb = ptcb;
+#endif
     }
 
   /* Mark the input list empty */
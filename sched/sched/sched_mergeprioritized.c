@@ -118,7 +118,31 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
        tmp  = (FAR struct tcb_s *)dq_next((FAR dq_entry_t *)tmp))
     {
       tmp->task_state = task_state;
+
+#ifdef CONFIG_SCHED_CPUBALANCE
+      if (list2 == (FAR dq_queue_t *)&g_readytorun)
+        {
+          SCHED_RTR_CPUSET_ADD(tmp);
+        }
+#endif
+    }
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  /* The ready-to-run list is indexed by priority.  Add the TCBs one at a
+   * time so that the index is kept up to date; this takes a constant time
+   * per TCB.
+   */
+
+  if (list2 == (FAR dq_queue_t *)&g_readytorun)
+    {
+      while ((tmp = (FAR struct tcb_s *)dq_remfirst(&clone)) != NULL)
+        {
+          (void)sched_rtrbitmap_add(tmp);
+        }
+
+      goto ret_with_lock;
     }
+#endif
 
   /* Get the head of list2 */
 
@@ -76,12 +76,24 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
   DEBUGASSERT(task_state >= FIRST_BLOCKED_STATE &&
               task_state <= LAST_BLOCKED_STATE);
 
+#ifdef CONFIG_SMP
+  /* Lock the blocked tasklists before accessing */
+
+  irqstate_t lock = sched_blocklist_lock();
+#endif
+
   /* Remove the TCB from the blocked task list associated
    * with this state
    */
 
   dq_rem((FAR dq_entry_t *)btcb, TLIST_BLOCKED(task_state));
 
+#ifdef CONFIG_SMP
+  /* Unlock the blocked tasklists */
+
+  sched_blocklist_unlock(lock);
+#endif
+
   /* Make sure the TCB's state corresponds to not being in
    * any list
    */
@@ -101,7 +101,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+  sched_remprioritized(rtcb, (FAR dq_queue_t *)&g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -237,11 +237,12 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
            * list and add to the head of the g_assignedtasks[cpu] list.
            */
 
-          tmptcb = (FAR struct tcb_s *)
-            dq_remfirst((FAR dq_queue_t *)&g_readytorun);
+          tmptcb = (FAR struct tcb_s *)g_readytorun.head;
+          sched_remprioritized(tmptcb, (FAR dq_queue_t *)&g_readytorun);
 
           dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
 
+          SCHED_COUNT_MIGRATION(tmptcb, cpu);
           tmptcb->cpu = cpu;
           nxttcb = tmptcb;
         }
@@ -328,7 +329,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * g_assignedtasks[cpu] list.
        */
 
-      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+      sched_remprioritized(rtcb, tasklist);
     }
 
   /* Since the TCB is no longer in any list, it is now invalid */
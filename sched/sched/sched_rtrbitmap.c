@@ -0,0 +1,248 @@
+/****************************************************************************
+ * sched/sched/sched_rtrbitmap.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The bitmap covers every priority from the IDLE priority (zero) through
+ * SCHED_PRIORITY_MAX, 32 priorities per word.
+ */
+
+#define RTRMAP_NWORDS      ((SCHED_PRIORITY_MAX + 32) >> 5)
+#define RTRMAP_NDX(p)      ((p) >> 5)
+#define RTRMAP_BIT(p)      ((uint32_t)1 << ((p) & 31))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Bit N of the bitmap is set if g_readytorun holds at least one TCB with
+ * priority N.
+ */
+
+static uint32_t g_rtrmap[RTRMAP_NWORDS];
+
+/* The last TCB of each priority in g_readytorun.  TCBs of the same priority
+ * are contiguous in the list so this entry marks the end of the FIFO of
+ * that priority.  Valid only if the corresponding bit is set in g_rtrmap.
+ */
+
+static FAR struct tcb_s *g_rtrtail[SCHED_PRIORITY_MAX + 1];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_rtrbitmap_ceiling
+ *
+ * Description:
+ *   Return the lowest priority greater than or equal to 'priority' that is
+ *   represented in g_readytorun or -1 if there is no such priority.  At
+ *   most RTRMAP_NWORDS words are examined.
+ *
+ ****************************************************************************/
+
+static int sched_rtrbitmap_ceiling(int priority)
+{
+  int ndx = RTRMAP_NDX(priority);
+  uint32_t map;
+
+  /* Ignore the priorities below 'priority' in the first word */
+
+  map = g_rtrmap[ndx] & ~(RTRMAP_BIT(priority) - 1);
+
+  for (; ; )
+    {
+      if (map != 0)
+        {
+          return (ndx << 5) + ffs((int)map) - 1;
+        }
+
+      if (++ndx >= RTRMAP_NWORDS)
+        {
+          return -1;
+        }
+
+      map = g_rtrmap[ndx];
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_rtrbitmap_add
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list.  This has the same effect as
+ *   sched_addprioritized() but the insertion point is found from the
+ *   priority bitmap rather than by searching the list:  The TCB goes
+ *   just after the last TCB of the lowest priority that is greater than or
+ *   equal to its own, or at the head of the list if there is none.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to add to g_readytorun
+ *
+ * Returned Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ *   The same as for sched_addprioritized().
+ *
+ ****************************************************************************/
+
+bool sched_rtrbitmap_add(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = (FAR dq_queue_t *)&g_readytorun;
+  int priority = tcb->sched_priority;
+  int ceiling;
+  bool ret = false;
+
+  ceiling = sched_rtrbitmap_ceiling(priority);
+  if (ceiling < 0)
+    {
+      /* No TCB has the same or higher priority.  Add the TCB to the head
+       * of the list.
+       */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      ret = true;
+    }
+  else
+    {
+      DEBUGASSERT(g_rtrtail[ceiling] != NULL);
+      dq_addafter((FAR dq_entry_t *)g_rtrtail[ceiling],
+                  (FAR dq_entry_t *)tcb, list);
+    }
+
+  /* The TCB is now the last TCB of its priority */
+
+  g_rtrtail[priority] = tcb;
+  g_rtrmap[RTRMAP_NDX(priority)] |= RTRMAP_BIT(priority);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sched_rtrbitmap_remove
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list, updating the priority bitmap.
+ *   The priority of the TCB must not have been changed since it was added
+ *   to the list.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from g_readytorun
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_rtrbitmap_remove(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+
+  DEBUGASSERT((g_rtrmap[RTRMAP_NDX(priority)] & RTRMAP_BIT(priority)) != 0);
+
+  if (g_rtrtail[priority] == tcb)
+    {
+      FAR struct tcb_s *prev = (FAR struct tcb_s *)tcb->blink;
+
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          /* The previous TCB becomes the last TCB of this priority */
+
+          g_rtrtail[priority] = prev;
+        }
+      else
+        {
+          /* This was the only TCB of this priority */
+
+          g_rtrtail[priority] = NULL;
+          g_rtrmap[RTRMAP_NDX(priority)] &= ~RTRMAP_BIT(priority);
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+}
+
+/****************************************************************************
+ * Name: sched_remprioritized
+ *
+ * Description:
+ *   Remove a TCB from a prioritized task list.  This is the counterpart of
+ *   sched_addprioritized() and must be used in place of dq_rem() whenever
+ *   the list may be g_readytorun.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove
+ *   list - Points to the prioritized list that holds the TCB
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_remprioritized(FAR struct tcb_s *tcb, FAR dq_queue_t *list)
+{
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      sched_rtrbitmap_remove(tcb);
+    }
+  else
+    {
+      dq_rem((FAR dq_entry_t *)tcb, list);
+    }
+}
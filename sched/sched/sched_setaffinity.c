@@ -126,6 +126,17 @@ int nxsched_setaffinity(pid_t pid, size_t cpusetsize,
 
   tcb->affinity = *mask;
 
+#ifdef CONFIG_SCHED_CPUBALANCE
+  /* A task waiting in the g_readytorun list may now run on other CPUs */
+
+  if (tcb->task_state == TSTATE_TASK_READYTORUN)
+    {
+      irqstate_t lock = sched_tasklist_lock();
+      SCHED_RTR_CPUSET_ADD(tcb);
+      sched_tasklist_unlock(lock);
+    }
+#endif
+
   /* Is the task still executing a a CPU in its affinity mask? Will this
    * change cause the task to be removed from its current assigned task
    * list?
@@ -165,9 +165,20 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#if defined(CONFIG_SCHED_READYTORUN_BITMAP) && !defined(CONFIG_SMP)
+      /* The running task is in the priority-indexed g_readytorun list.  It
+       * remains at the head of the list but must be re-indexed under its
+       * new priority.
+       */
+
+      sched_rtrbitmap_remove(tcb);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      (void)sched_rtrbitmap_add(tcb);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -247,9 +258,14 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
-      /* Remove the TCB from the ready-to-run task list that it resides in */
+      bool doswitch;
+
+      /* Remove the TCB from the ready-to-run task list that it resides in.
+       * NOTE that this must be done even if assertions are disabled.
+       */
 
-      DEBUGASSERT(!sched_removereadytorun(tcb));
+      doswitch = sched_removereadytorun(tcb);
+      DEBUGASSERT(!doswitch);
 
       /* Change the task priority */
 
@@ -257,7 +273,9 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
       /* Put it back into the correct ready-to-run task list */
 
-      DEBUGASSERT(!sched_addreadytorun(tcb));
+      doswitch = sched_addreadytorun(tcb);
+      DEBUGASSERT(!doswitch);
+      UNUSED(doswitch);
     }
 }
 
@@ -288,6 +306,12 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
   tasklist = TLIST_BLOCKED(task_state);
   if (TLIST_ISPRIORITIZED(task_state))
     {
+#ifdef CONFIG_SMP
+      /* Lock the blocked tasklists before accessing */
+
+      irqstate_t lock = sched_blocklist_lock();
+#endif
+
       /* Remove the TCB from the prioritized task list */
 
       dq_rem((FAR dq_entry_t *)tcb, tasklist);
@@ -299,6 +323,10 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
       /* Put it back into the prioritized list at the correct position. */
 
       sched_addprioritized(tcb, tasklist);
+
+#ifdef CONFIG_SMP
+      sched_blocklist_unlock(lock);
+#endif
     }
 
   /* CASE 3b. The task resides in a non-prioritized list. */
@@ -46,10 +46,12 @@
 #include "sched/sched.h"
 
 /****************************************************************************
- * Public Data
+ * Private Data
  ****************************************************************************/
 
-/* Splinlock to protect the tasklists */
+/* Splinlock to protect the ready-to-run tasklists (g_readytorun,
+ * g_pendingtasks and g_assignedtasks[])
+ */
 
 static volatile spinlock_t g_tasklist_lock SP_SECTION = SP_UNLOCKED;
 
@@ -57,27 +59,34 @@ static volatile spinlock_t g_tasklist_lock SP_SECTION = SP_UNLOCKED;
 
 static volatile uint8_t g_tasklist_lock_count[CONFIG_SMP_NCPUS];
 
+/* Spinlock to protect the blocked tasklists (g_waitingforsemaphore,
+ * g_waitingforsignal, etc.) so that moving a task into or out of a blocked
+ * list does not hold g_tasklist_lock.  See sched/sched/sched.h for the
+ * lock order.
+ */
+
+static volatile spinlock_t g_blocklist_lock SP_SECTION = SP_UNLOCKED;
+
+/* Handles nested calls */
+
+static volatile uint8_t g_blocklist_lock_count[CONFIG_SMP_NCPUS];
+
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: sched_tasklist_lock()
+ * Name: sched_nested_lock()
  *
  * Description:
- *   Disable local interrupts and take the global spinlock (g_tasklist_lock)
- *   if the call counter (g_tasklist_lock_count[cpu]) equals to 0. Then the
- *   counter on the CPU is incremented to allow nested call.
+ *   Disable local interrupts and take the spinlock if the call counter of
+ *   this CPU equals to 0.  Then the counter is incremented to allow nested
+ *   calls.
  *
- *   NOTE: This API is used to protect tasklists in the scheduler. So do not
- *   use this API for other purposes.
- *
- * Returned Value:
- *   An opaque, architecture-specific value that represents the state of
- *   the interrupts prior to the call to sched_tasklist_lock();
  ****************************************************************************/
 
-irqstate_t sched_tasklist_lock(void)
+static irqstate_t sched_nested_lock(FAR volatile spinlock_t *lock,
+                                    FAR volatile uint8_t *count)
 {
   int me;
   irqstate_t ret;
@@ -85,16 +94,69 @@ irqstate_t sched_tasklist_lock(void)
   ret = up_irq_save();
   me  = this_cpu();
 
-  if (0 == g_tasklist_lock_count[me])
+  if (0 == count[me])
     {
-      spin_lock(&g_tasklist_lock);
+      spin_lock(lock);
     }
 
-  g_tasklist_lock_count[me]++;
-  DEBUGASSERT(0 != g_tasklist_lock_count[me]);
+  count[me]++;
+  DEBUGASSERT(0 != count[me]);
   return ret;
 }
 
+/****************************************************************************
+ * Name: sched_nested_unlock()
+ *
+ * Description:
+ *   Decrement the call counter of this CPU and if it decrements to zero
+ *   then release the spinlock and restore the interrupt state.
+ *
+ ****************************************************************************/
+
+static void sched_nested_unlock(FAR volatile spinlock_t *lock,
+                                FAR volatile uint8_t *count,
+                                irqstate_t flags)
+{
+  int me;
+
+  me = this_cpu();
+
+  DEBUGASSERT(0 < count[me]);
+  count[me]--;
+
+  if (0 == count[me])
+    {
+      spin_unlock(lock);
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_tasklist_lock()
+ *
+ * Description:
+ *   Disable local interrupts and take the global spinlock (g_tasklist_lock)
+ *   if the call counter (g_tasklist_lock_count[cpu]) equals to 0. Then the
+ *   counter on the CPU is incremented to allow nested call.
+ *
+ *   NOTE: This API is used to protect the ready-to-run tasklists in the
+ *   scheduler. So do not use this API for other purposes.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to sched_tasklist_lock();
+ ****************************************************************************/
+
+irqstate_t sched_tasklist_lock(void)
+{
+  return sched_nested_lock(&g_tasklist_lock, g_tasklist_lock_count);
+}
+
 /****************************************************************************
  * Name: sched_tasklist_unlock()
  *
@@ -104,8 +166,8 @@ irqstate_t sched_tasklist_lock(void)
  *   restore the interrupt state as it was prior to the previous call to
  *   sched_tasklist_lock().
  *
- *   NOTE: This API is used to protect tasklists in the scheduler. So do not
- *   use this API for other purposes.
+ *   NOTE: This API is used to protect the ready-to-run tasklists in the
+ *   scheduler. So do not use this API for other purposes.
  *
  * Input Parameters:
  *   lock - The architecture-specific value that represents the state of
@@ -117,17 +179,41 @@ irqstate_t sched_tasklist_lock(void)
 
 void sched_tasklist_unlock(irqstate_t lock)
 {
-  int me;
+  sched_nested_unlock(&g_tasklist_lock, g_tasklist_lock_count, lock);
+}
 
-  me = this_cpu();
+/****************************************************************************
+ * Name: sched_blocklist_lock()
+ *
+ * Description:
+ *   The same as sched_tasklist_lock() but for the blocked tasklists
+ *   (g_waitingforsemaphore, g_waitingforsignal, etc.).
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to sched_blocklist_lock();
+ ****************************************************************************/
 
-  DEBUGASSERT(0 < g_tasklist_lock_count[me]);
-  g_tasklist_lock_count[me]--;
+irqstate_t sched_blocklist_lock(void)
+{
+  return sched_nested_lock(&g_blocklist_lock, g_blocklist_lock_count);
+}
 
-  if (0 == g_tasklist_lock_count[me])
-    {
-      spin_unlock(&g_tasklist_lock);
-    }
+/****************************************************************************
+ * Name: sched_blocklist_unlock()
+ *
+ * Description:
+ *   Release the lock taken by sched_blocklist_lock().
+ *
+ * Input Parameters:
+ *   lock - The architecture-specific value that represents the state of
+ *          the interrupts prior to the call to sched_blocklist_lock().
+ *
+ * Returned Value:
+ *   None
+ ****************************************************************************/
 
-  up_irq_restore(lock);
+void sched_blocklist_unlock(irqstate_t lock)
+{
+  sched_nested_unlock(&g_blocklist_lock, g_blocklist_lock_count, lock);
 }
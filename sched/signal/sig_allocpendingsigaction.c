@@ -40,10 +40,8 @@
 #include <nuttx/config.h>
 
 #include <signal.h>
-#include <assert.h>
 
-#include <nuttx/irq.h>
-#include <nuttx/arch.h>
+#include <nuttx/mm/mempool.h>
 
 #include "signal/signal.h"
 
@@ -61,59 +59,11 @@
 
 FAR sigq_t *nxsig_alloc_pendingsigaction(void)
 {
-  FAR sigq_t    *sigq;
-  irqstate_t flags;
-
-  /* Check if we were called from an interrupt handler. */
-
-  if (up_interrupt_context())
-    {
-      /* Try to get the pending signal action structure from the free list */
-
-      sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-
-      /* If so, then try the special list of structures reserved for
-       * interrupt handlers
-       */
-
-      if (!sigq)
-        {
-          sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingirqaction);
-        }
-    }
-
-  /* If we were not called from an interrupt handler, then we are
-   * free to allocate pending signal action structures if necessary.
+  /* Get a pending signal action structure from the pool.  If we were called
+   * from an interrupt handler, then this may be one of the structures
+   * reserved for interrupt handlers.  Otherwise, the structure may be
+   * allocated from the heap if there are no unreserved structures available.
    */
 
-  else
-    {
-      /* Try to get the pending signal action structure from the free list */
-
-      flags = enter_critical_section();
-      sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-      leave_critical_section(flags);
-
-      /* Check if we got one. */
-
-      if (!sigq)
-        {
-          /* No...Try the resource pool */
-
-          if (!sigq)
-            {
-              sigq = (FAR sigq_t *)kmm_malloc((sizeof (sigq_t)));
-            }
-
-          /* Check if we got an allocated message */
-
-          if (sigq)
-            {
-              sigq->type = SIG_ALLOC_DYN;
-            }
-        }
-    }
-
-  return sigq;
+  return (FAR sigq_t *)mempool_alloc(&g_sigpendingactionpool);
 }
-
@@ -58,17 +58,12 @@
 
 sq_queue_t  g_sigfreeaction;
 
-/* The g_sigpendingaction data structure is a list of available pending
- * signal action structures.
+/* The g_sigpendingactionpool memory pool holds the available pending
+ * signal action structures.  NUM_PENDING_INT_ACTIONS of the pre-allocated
+ * structures are reserved for use by interrupt handlers.
  */
 
-sq_queue_t  g_sigpendingaction;
-
-/* The g_sigpendingirqaction is a list of available pending signal actions
- * that are reserved for use by interrupt handlers.
- */
-
-sq_queue_t  g_sigpendingirqaction;
+struct mempool_s g_sigpendingactionpool;
 
 /* The g_sigpendingsignal data structure is a list of available pending
  * signal structures.
@@ -93,18 +88,6 @@ sq_queue_t  g_sigpendingirqsignal;
 
 static sigactq_t  *g_sigactionalloc;
 
-/* g_sigpendingactionalloc is a pointer to the start of the allocated
- * blocks of pending signal actions.
- */
-
-static sigq_t     *g_sigpendingactionalloc;
-
-/* g_sigpendingirqactionalloc is a pointer to the start of the allocated
- * block of pending signal actions.
- */
-
-static sigq_t     *g_sigpendingirqactionalloc;
-
 /* g_sigpendingsignalalloc is a pointer to the start of the allocated
  * blocks of pending signals.
  */
@@ -121,8 +104,6 @@ static sigpendq_t *g_sigpendingirqsignalalloc;
  * Private Function Prototypes
  ****************************************************************************/
 
-static sigq_t     *nxsig_alloc_block(sq_queue_t *siglist, uint16_t nsigs,
-                                     uint8_t sigtype);
 static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
                                                   uint16_t nsigs, uint8_t sigtype);
 
@@ -130,38 +111,6 @@ static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: nxsig_alloc_block
- *
- * Description:
- *   Allocate a block of pending signal actions and place them
- *   on the free list.
- *
- ****************************************************************************/
-
-static FAR sigq_t *nxsig_alloc_block(sq_queue_t *siglist, uint16_t nsigs,
-                                     uint8_t sigtype)
-{
-  FAR sigq_t *sigqalloc;
-  FAR sigq_t *sigq;
-  int i;
-
-  /* Allocate a block of pending signal actions. */
-
-  sigqalloc = (FAR sigq_t *)kmm_malloc((sizeof(sigq_t)) * nsigs);
-  if (sigqalloc != NULL)
-    {
-      sigq = sigqalloc;
-      for (i = 0; i < nsigs; i++)
-        {
-          sigq->type = sigtype;
-          sq_addlast((FAR sq_entry_t *)sigq++, siglist);
-        }
-    }
-
-  return sigqalloc;
-}
-
 /****************************************************************************
  * Name: nxsig_alloc_pendingsignalblock
  *
@@ -213,24 +162,21 @@ void nxsig_initialize(void)
   /* Initialize free lists */
 
   sq_init(&g_sigfreeaction);
-  sq_init(&g_sigpendingaction);
-  sq_init(&g_sigpendingirqaction);
   sq_init(&g_sigpendingsignal);
   sq_init(&g_sigpendingirqsignal);
 
-  /* Add a block of signal structures to each list */
+  /* Allocate the pool of pending signal actions, including the actions
+   * reserved for use by interrupt handlers.
+   */
+
+  DEBUGVERIFY(mempool_initialize(&g_sigpendingactionpool, "sigpendaction",
+                                 NULL, sizeof(sigq_t),
+                                 NUM_PENDING_ACTIONS +
+                                 NUM_PENDING_INT_ACTIONS,
+                                 NUM_PENDING_INT_ACTIONS,
+                                 MEMPOOL_FLAG_GROW));
 
-  g_sigpendingactionalloc =
-    nxsig_alloc_block(&g_sigpendingaction,
-                      NUM_PENDING_ACTIONS,
-                      SIG_ALLOC_FIXED);
-  DEBUGASSERT(g_sigpendingactionalloc != NULL);
-
-  g_sigpendingirqactionalloc =
-    nxsig_alloc_block(&g_sigpendingirqaction,
-                      NUM_PENDING_INT_ACTIONS,
-                      SIG_ALLOC_IRQ);
-  DEBUGASSERT(g_sigpendingirqactionalloc != NULL);
+  /* Add a block of signal structures to each list */
 
   nxsig_alloc_actionblock();
 
@@ -49,6 +49,7 @@
 #include <sched.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -115,7 +116,6 @@ struct sigq_s
   sigset_t  mask;                /* Additional signals to mask while the
                                   * the signal-catching function executes */
   siginfo_t info;                /* Signal information */
-  uint8_t   type;                /* (Used to manage allocations) */
 };
 typedef struct sigq_s sigq_t;
 
@@ -129,17 +129,12 @@ typedef struct sigq_s sigq_t;
 
 extern sq_queue_t  g_sigfreeaction;
 
-/* The g_sigpendingaction data structure is a list of available pending
- * signal action structures.
- */
-
-extern sq_queue_t  g_sigpendingaction;
-
-/* The g_sigpendingirqaction is a list of available pending signal actions
- * that are reserved for use by interrupt handlers.
+/* The g_sigpendingactionpool memory pool holds the available pending
+ * signal action structures.  NUM_PENDING_INT_ACTIONS of the pre-allocated
+ * structures are reserved for use by interrupt handlers.
  */
 
-extern sq_queue_t  g_sigpendingirqaction;
+extern struct mempool_s g_sigpendingactionpool;
 
 /* The g_sigpendingsignal data structure is a list of available pending
  * signal structures.
@@ -41,31 +41,31 @@
 
 #include <queue.h>
 
+#include <nuttx/mm/mempool.h>
+
 #include "wdog/wdog.h"
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* The g_wdpool memory pool holds the watchdogs available to the system
+ * for delayed function use.  CONFIG_WDOG_INTRESERVE of the pre-allocated
+ * watchdogs are reserved for use by interrupt handlers; tasks allocate
+ * watchdogs from the kernel heap if no other pre-allocated watchdog is
+ * available.
  */
 
-sq_queue_t g_wdfreelist;
+struct mempool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
-
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
-
-uint16_t g_wdnfree;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -79,11 +79,11 @@ clock_t g_wdtickbase;
  * Private Data
  ****************************************************************************/
 
-/* g_wdpool is a list of pre-allocated watchdogs. The number of watchdogs
- * in the pool is a configuration item.
+/* g_wdalloc is the array of pre-allocated watchdogs. The number of
+ * watchdogs in the pool is a configuration item.
  */
 
-static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
+static struct wdog_s g_wdalloc[CONFIG_PREALLOC_WDOGS];
 
 /****************************************************************************
  * Public Functions
@@ -110,24 +110,21 @@ static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
 
 void wd_initialize(void)
 {
-  FAR struct wdog_s *wdog = g_wdpool;
-  int i;
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Initialize the watchdog timer wheel */
 
-  /* Initialize watchdog lists */
+  wd_wheel_initialize();
+#else
+  /* Initialize the watchdog active list */
 
-  sq_init(&g_wdfreelist);
   sq_init(&g_wdactivelist);
+#endif
 
-  /* The g_wdfreelist must be loaded at initialization time to hold the
+  /* The g_wdpool must be loaded at initialization time to hold the
    * configured number of watchdogs.
    */
 
-  for (i = 0; i < CONFIG_PREALLOC_WDOGS; i++)
-    {
-      sq_addlast((FAR sq_entry_t *)wdog++, &g_wdfreelist);
-    }
-
-  /* All watchdogs are free */
-
-  g_wdnfree = CONFIG_PREALLOC_WDOGS;
+  (void)mempool_initialize(&g_wdpool, "wdog", g_wdalloc,
+                           sizeof(struct wdog_s), CONFIG_PREALLOC_WDOGS,
+                           CONFIG_WDOG_INTRESERVE, MEMPOOL_FLAG_GROW);
 }
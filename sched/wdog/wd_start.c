@@ -71,6 +71,7 @@
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -114,40 +115,66 @@ static inline void wd_expiration(void)
               ((FAR struct wdog_s *)g_wdactivelist.head)->lag += wdog->lag;
             }
 
-          /* Indicate that the watchdog is no longer active. */
+          /* Mark the watchdog inactive and execute its function */
 
-          WDOG_CLRACTIVE(wdog);
+          wd_dispatch(wdog);
+        }
+    }
+}
+#endif /* !CONFIG_WDOG_TIMERWHEEL */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Mark an expired watchdog inactive and execute its watchdog function.
+ *   The watchdog must already have been removed from the active watchdogs.
+ *
+ * Input Parameters:
+ *   wdog - The expired watchdog
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from interrupt handler logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_dispatch(FAR struct wdog_s *wdog)
+{
+  /* Indicate that the watchdog is no longer active. */
 
-          /* Execute the watchdog function */
+  WDOG_CLRACTIVE(wdog);
 
-          up_setpicbase(wdog->picbase);
+  /* Execute the watchdog function */
+
+  up_setpicbase(wdog->picbase);
 
 #if CONFIG_MAX_WDOGPARMS == 0
-          wdog->func(0);
+  wdog->func(0);
 #elif CONFIG_MAX_WDOGPARMS == 1
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0]);
+  wdog->func((int)wdog->argc,
+             wdog->parm[0]);
 #elif CONFIG_MAX_WDOGPARMS == 2
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1]);
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1]);
 #elif CONFIG_MAX_WDOGPARMS == 3
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2]);
 #elif CONFIG_MAX_WDOGPARMS == 4
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2],
-                     wdog->parm[3]);
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2],
+             wdog->parm[3]);
 #else
 #  error Missing support
 #endif
-        }
-    }
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: wd_start
  *
@@ -185,10 +212,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
   int i;
 
@@ -253,6 +282,11 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Add the watchdog to the timer wheel.  No search is needed. */
+
+  wd_wheel_add(wdog, delay);
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -343,9 +377,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif
+
+  /* Mark the watchdog as active */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -361,6 +399,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   return OK;
 }
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /****************************************************************************
  * Name: wd_timer
  *
@@ -494,3 +533,4 @@ void wd_timer(void)
 #endif
 }
 #endif /* CONFIG_SCHED_TICKLESS */
+#endif /* !CONFIG_WDOG_TIMERWHEEL */
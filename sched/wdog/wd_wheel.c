@@ -0,0 +1,512 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel has WHEEL_LEVELS levels of WHEEL_NSLOTS slots.  A level L slot
+ * spans 2^(5*L) ticks so that the wheel as a whole spans 2^35 ticks, more
+ * than the longest possible (int32_t) delay.
+ */
+
+#define WHEEL_BITS         5
+#define WHEEL_NSLOTS       (1 << WHEEL_BITS)
+#define WHEEL_MASK         (WHEEL_NSLOTS - 1)
+#define WHEEL_LEVELS       7
+
+#define WHEEL_SHIFT(l)     ((l) * WHEEL_BITS)
+#define WHEEL_INDEX(t,l)   (((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK)
+#define WHEEL_SPAN(l)      ((uint32_t)1 << WHEEL_SHIFT(l))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Each slot is a circular, doubly linked list of watchdogs with the slot
+ * itself as the list head.  struct wdog_s begins with its next and prev
+ * links, so it may be linked as a dq_entry_t.  Each level also has a bitmap
+ * of its non-empty slots.
+ */
+
+static dq_entry_t g_wdslots[WHEEL_LEVELS][WHEEL_NSLOTS];
+static uint32_t   g_wdmap[WHEEL_LEVELS];
+
+/* The time, in ticks, up to which the wheel has been processed */
+
+static uint32_t   g_wdnow;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Link a watchdog into the slot that corresponds to its expiration time.
+ *   The level is selected by the time remaining so that the watchdog is
+ *   reached (either to expire or to be moved to a lower level) before it
+ *   expires.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  FAR dq_entry_t *head;
+  FAR dq_entry_t *node = (FAR dq_entry_t *)wdog;
+  uint32_t delta = wdog->expire - g_wdnow;
+  int level;
+  int slot;
+
+  for (level = 0; level < WHEEL_LEVELS - 1; level++)
+    {
+      if (delta < WHEEL_SPAN(level + 1))
+        {
+          break;
+        }
+    }
+
+  slot = WHEEL_INDEX(wdog->expire, level);
+  head = &g_wdslots[level][slot];
+
+  /* Add the watchdog at the tail of the slot so that watchdogs with the
+   * same expiration time expire in the order that they were started.
+   */
+
+  node->flink        = head;
+  node->blink        = head->blink;
+  head->blink->flink = node;
+  head->blink        = node;
+
+  g_wdmap[level]    |= (uint32_t)1 << slot;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_detach
+ *
+ * Description:
+ *   Move the content of a non-empty slot to the list 'list' leaving the
+ *   slot empty.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_detach(int level, int slot, FAR dq_entry_t *list)
+{
+  FAR dq_entry_t *head = &g_wdslots[level][slot];
+
+  list->flink        = head->flink;
+  list->blink        = head->blink;
+  list->flink->blink = list;
+  list->blink->flink = list;
+
+  head->flink        = head;
+  head->blink        = head;
+
+  g_wdmap[level]    &= ~((uint32_t)1 << slot);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ *
+ * Description:
+ *   Unlink a watchdog from whatever list it is in.
+ *
+ ****************************************************************************/
+
+static inline void wd_wheel_unlink(FAR dq_entry_t *node)
+{
+  node->blink->flink = node->flink;
+  node->flink->blink = node->blink;
+  node->flink        = NULL;
+  node->blink        = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Process the tick g_wdnow:  First, move the watchdogs in any higher
+ *   level slot that begins at this tick to lower levels.  Then expire
+ *   the watchdogs in the level 0 slot for this tick.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_tick(void)
+{
+  FAR struct wdog_s *wdog;
+  dq_entry_t list;
+  int level;
+  int slot;
+
+  /* Find the highest level whose current slot begins at this tick */
+
+  for (level = 1;
+       level < WHEEL_LEVELS && (g_wdnow & (WHEEL_SPAN(level) - 1)) == 0;
+       level++);
+
+  /* And cascade those slots, highest level first */
+
+  while (--level > 0)
+    {
+      slot = WHEEL_INDEX(g_wdnow, level);
+      if ((g_wdmap[level] & ((uint32_t)1 << slot)) != 0)
+        {
+          wd_wheel_detach(level, slot, &list);
+          while (list.flink != &list)
+            {
+              wdog = (FAR struct wdog_s *)list.flink;
+              wd_wheel_unlink((FAR dq_entry_t *)wdog);
+              wd_wheel_insert(wdog);
+            }
+        }
+    }
+
+  /* Then expire every watchdog in the level 0 slot.  The slot is detached
+   * first so that watchdog functions may freely start and cancel watchdogs
+   * (including those that are still in the detached list).
+   */
+
+  slot = WHEEL_INDEX(g_wdnow, 0);
+  if ((g_wdmap[0] & ((uint32_t)1 << slot)) != 0)
+    {
+      wd_wheel_detach(0, slot, &list);
+      while (list.flink != &list)
+        {
+          wdog = (FAR struct wdog_s *)list.flink;
+          DEBUGASSERT(wdog->expire == g_wdnow);
+
+          wd_wheel_unlink((FAR dq_entry_t *)wdog);
+          wd_dispatch(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks from g_wdnow until the next tick that must
+ *   be processed (because a watchdog expires or a slot must be cascaded
+ *   at that time), or zero if the wheel is empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+static uint32_t wd_wheel_next(void)
+{
+  uint32_t next = 0;
+  uint32_t delta;
+  uint32_t map;
+  int level;
+  int rot;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      map = g_wdmap[level];
+      if (map != 0)
+        {
+          /* Rotate the map so that bit 0 is the slot following the current
+           * slot, then find the first non-empty slot.
+           */
+
+          rot   = (WHEEL_INDEX(g_wdnow, level) + 1) & WHEEL_MASK;
+          map   = (map >> rot) | (map << ((WHEEL_NSLOTS - rot) & WHEEL_MASK));
+
+          /* That slot is reached at the start of its span */
+
+          delta = (((g_wdnow >> WHEEL_SHIFT(level)) + ffs((int)map))
+                   << WHEEL_SHIFT(level)) - g_wdnow;
+
+          if (next == 0 || delta < next)
+            {
+              next = delta;
+            }
+        }
+    }
+
+  return next;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timer wheel.  Called from wd_initialize().
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+  int level;
+  int slot;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      for (slot = 0; slot < WHEEL_NSLOTS; slot++)
+        {
+          g_wdslots[level][slot].flink = &g_wdslots[level][slot];
+          g_wdslots[level][slot].blink = &g_wdslots[level][slot];
+        }
+
+      g_wdmap[level] = 0;
+    }
+
+  g_wdnow = 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel so that it expires after 'delay'
+ *   calls to wd_timer() (or the equivalent number of ticks in the
+ *   tick-less case).
+ *
+ * Input Parameters:
+ *   wdog  - The watchdog to add.  It must not be active.
+ *   delay - The delay in clock ticks.  Must be greater than zero.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog, int32_t delay)
+{
+  DEBUGASSERT(delay > 0);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* If the wheel is empty, the interval timer has not been running and
+   * the clock tickbase must be brought up to date.
+   */
+
+  if (wd_wheel_next() == 0)
+    {
+      g_wdtickbase = clock_systimer();
+    }
+#endif
+
+  wdog->expire = g_wdnow + (uint32_t)delay;
+  wd_wheel_insert(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR dq_entry_t *node = (FAR dq_entry_t *)wdog;
+  FAR dq_entry_t *prev = node->blink;
+  FAR dq_entry_t *next = node->flink;
+  int ndx;
+
+  wd_wheel_unlink(node);
+
+  /* If the list is now empty then 'prev' and 'next' are both the list
+   * head.  If that list head is a slot of the wheel (and not a list of
+   * expiring watchdogs in wd_wheel_tick()), then mark the slot empty.
+   */
+
+  if (prev == next &&
+      prev >= &g_wdslots[0][0] &&
+      prev <  &g_wdslots[WHEEL_LEVELS - 1][WHEEL_NSLOTS])
+    {
+      ndx = prev - &g_wdslots[0][0];
+      g_wdmap[ndx >> WHEEL_BITS] &= ~((uint32_t)1 << (ndx & WHEEL_MASK));
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks that have yet to be processed by wd_timer()
+ *   before an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+  return (int)(wdog->expire - g_wdnow);
+}
+
+/****************************************************************************
+ * Name: wd_timer
+ *
+ * Description:
+ *   This function is called from the timer interrupt handler to determine
+ *   if it is time to execute a watchdog function.  If so, the watchdog
+ *   function will be executed in the context of the timer interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   ticks - If CONFIG_SCHED_TICKLESS is defined then the number of ticks
+ *     in the interval that just expired is provided.  Otherwise,
+ *     this function is called on each timer interrupt and a value of one
+ *     is implicit.
+ *
+ * Returned Value:
+ *   If CONFIG_SCHED_TICKLESS is defined then the number of ticks for the
+ *   next delay is provided (zero if no delay).  Otherwise, this function
+ *   has no returned value.
+ *
+ * Assumptions:
+ *   Called from interrupt handler logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_timer(int ticks)
+{
+  uint32_t next;
+  unsigned int ret;
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  /* Update clock tickbase */
+
+  g_wdtickbase += ticks;
+
+  /* Skip directly from one tick of interest to the next until the elapsed
+   * ticks have been consumed.
+   */
+
+  while (ticks > 0)
+    {
+      next = wd_wheel_next();
+      if (next == 0 || next > (uint32_t)ticks)
+        {
+          g_wdnow += ticks;
+          break;
+        }
+
+      g_wdnow += next;
+      ticks   -= next;
+      wd_wheel_tick();
+    }
+
+  /* Return the delay for the next tick of interest */
+
+  ret = wd_wheel_next();
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return ret;
+}
+
+#else
+void wd_timer(void)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  /* Advance the wheel by one tick */
+
+  g_wdnow++;
+  wd_wheel_tick();
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+}
+#endif /* CONFIG_SCHED_TICKLESS */